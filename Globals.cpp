@@ -1,12 +1,86 @@
 #include"Globals.h"
 #include<QStandardPaths>
-#include<QApplication>
+#include <algorithm>
 
 namespace GlobalFlags {
 bool additionalBodiesEnabled = false;
+bool transitChartPointsEnabled = false;
 QString lastGeneratedChartType = "Natal Birth";
 QString appDir = QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) + "/Asteria";
 bool activeModelLoaded = false;
 QString sharesDirPath = appDir + "/shares";
 
 }
+
+namespace {
+double g_orbMax = 8.0; // Default orb value
+
+// Factors as AspectOrbTable::standard() sets them
+struct OrbFactors {
+    OrbFactors() { reset(); }
+    void reset() {
+        for (int i = 0; i < AspectKindCount; ++i) {
+            aspects[i] = isMajorAspect(AspectKind(i)) ? 1.0 : 0.75;
+        }
+        std::fill(std::begin(bodies), std::end(bodies), 1.0);
+    }
+    double aspects[AspectKindCount];
+    double bodies[BodyCount];
+};
+OrbFactors g_orbFactors;
+}
+
+// Global orb getter/setter, kept here so the headless core owns it
+double getOrbMax() {
+    return g_orbMax;
+}
+
+void setOrbMax(double value) {
+    g_orbMax = value;
+}
+
+double getAspectOrbFactor(AspectKind aspect) {
+    return g_orbFactors.aspects[int(aspect)];
+}
+
+void setAspectOrbFactor(AspectKind aspect, double factor) {
+    g_orbFactors.aspects[int(aspect)] = factor;
+}
+
+double getBodyOrbFactor(Body body) {
+    return g_orbFactors.bodies[int(body)];
+}
+
+void setBodyOrbFactor(Body body, double factor) {
+    g_orbFactors.bodies[int(body)] = factor;
+}
+
+void resetOrbFactors() {
+    g_orbFactors.reset();
+}
+
+// Keyed by aspect code and body name, which stay stable when the enums grow
+void saveOrbFactors(QSettings &settings) {
+    settings.beginGroup("orbs");
+    for (int i = 0; i < AspectKindCount; ++i) {
+        settings.setValue("aspect/" + aspectCode(AspectKind(i)), g_orbFactors.aspects[i]);
+    }
+    for (int i = 0; i < BodyCount; ++i) {
+        settings.setValue("body/" + bodyName(Body(i)), g_orbFactors.bodies[i]);
+    }
+    settings.endGroup();
+}
+
+void loadOrbFactors(QSettings &settings) {
+    g_orbFactors.reset();
+    settings.beginGroup("orbs");
+    for (int i = 0; i < AspectKindCount; ++i) {
+        g_orbFactors.aspects[i] = settings.value("aspect/" + aspectCode(AspectKind(i)),
+                                                 g_orbFactors.aspects[i]).toDouble();
+    }
+    for (int i = 0; i < BodyCount; ++i) {
+        g_orbFactors.bodies[i] = settings.value("body/" + bodyName(Body(i)),
+                                                g_orbFactors.bodies[i]).toDouble();
+    }
+    settings.endGroup();
+}
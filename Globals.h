@@ -3,11 +3,14 @@
 
 #include <QString>
 #include <Qt>
-#include <QColor>
 #include <QSettings>
+#include "astrotypes.h"
 
 namespace GlobalFlags {
 extern bool additionalBodiesEnabled;
+// Let the Syzygy, Lots, Vertex and East Point transit too. They need a
+// full chart for every day of a transit scan, so this is off by default.
+extern bool transitChartPointsEnabled;
 extern QString lastGeneratedChartType;
 extern QString appDir;
 extern bool activeModelLoaded;
@@ -18,13 +21,25 @@ extern QString sharesDirPath;
 double getOrbMax();
 void setOrbMax(double value);
 
+// Orb of each aspect as a share of the max orb (1.0 for majors, 0.75 for
+// minors by default)
+double getAspectOrbFactor(AspectKind aspect);
+void setAspectOrbFactor(AspectKind aspect, double factor);
+
+// Per-body orb scaling (1.0 by default), see AspectOrbTable
+double getBodyOrbFactor(Body body);
+void setBodyOrbFactor(Body body, double factor);
+
+// Aspect and body orb factors, kept in the "orbs" settings group
+void resetOrbFactors();
+void saveOrbFactors(QSettings &settings);
+void loadOrbFactors(QSettings &settings);
+
 // Global font setting functions
 //QString getAstroFontFamily();
 //void setAstroFontFamily(const QString &fontFamily);
 
 
-#include <Qt>
-#include <QColor>
 // Aspect line style settings
 class AspectSettings {
 public:
@@ -0,0 +1,158 @@
+#include "aspectkernel.h"
+#include <cmath>
+#include <numeric>
+
+AspectOrbTable::AspectOrbTable()
+{
+    std::fill(std::begin(m_aspectOrbs), std::end(m_aspectOrbs), 0.0);
+    std::fill(std::begin(m_bodyFactors), std::end(m_bodyFactors), 1.0);
+}
+
+AspectOrbTable AspectOrbTable::standard(double orbMax)
+{
+    AspectOrbTable table;
+    for (int i = 0; i < AspectKindCount; ++i) {
+        AspectKind aspect = AspectKind(i);
+        table.setAspectOrb(aspect, isMajorAspect(aspect) ? orbMax : orbMax * 0.75);
+    }
+    return table;
+}
+
+void AspectOrbTable::setAspectOrb(AspectKind aspect, double orb)
+{
+    m_aspectOrbs[int(aspect)] = orb;
+}
+
+void AspectOrbTable::setBodyFactor(Body body, double factor)
+{
+    m_bodyFactors[int(body)] = factor;
+    m_maxFactor = *std::max_element(std::begin(m_bodyFactors), std::end(m_bodyFactors));
+}
+
+bool AspectOrbTable::operator==(const AspectOrbTable &other) const
+{
+    return std::equal(std::begin(m_aspectOrbs), std::end(m_aspectOrbs), std::begin(other.m_aspectOrbs))
+            && std::equal(std::begin(m_bodyFactors), std::end(m_bodyFactors), std::begin(other.m_bodyFactors));
+}
+
+AspectKernel::AspectKernel(const AspectOrbTable &orbs)
+    : m_orbs(orbs)
+{
+}
+
+AspectKernel::SortedPoints AspectKernel::sortPoints(const double *longitudes, const Body *bodies, int count)
+{
+    SortedPoints points;
+    points.indexes.resize(count);
+    std::iota(points.indexes.begin(), points.indexes.end(), 0);
+    std::sort(points.indexes.begin(), points.indexes.end(), [longitudes](int a, int b) {
+        return longitudes[a] < longitudes[b];
+    });
+
+    points.longitudes.resize(count);
+    for (int i = 0; i < count; ++i) {
+        points.longitudes[i] = longitudes[points.indexes[i]];
+    }
+    points.bodies = QVector<Body>(bodies, bodies + count);
+    return points;
+}
+
+template<typename Visit>
+void AspectKernel::forEachInWindow(const SortedPoints &b, double center, double width, Visit visit)
+{
+    const double *begin = b.longitudes.constData();
+    const double *end = begin + b.longitudes.size();
+
+    auto visitRange = [&](double lo, double hi) {
+        for (const double *p = std::lower_bound(begin, end, lo); p != end && *p <= hi; ++p) {
+            visit(int(p - begin));
+        }
+    };
+
+    // Windows are narrower than 180 degrees, so they wrap at most once
+    double lo = center - width;
+    double hi = center + width;
+    if (lo < 0.0) {
+        visitRange(lo + 360.0, 360.0);
+        visitRange(0.0, hi);
+    } else if (hi >= 360.0) {
+        visitRange(lo, 360.0);
+        visitRange(0.0, hi - 360.0);
+    } else {
+        visitRange(lo, hi);
+    }
+}
+
+void AspectKernel::scanPoint(double longitude, Body body, int first, const SortedPoints &b,
+                             int minSecond, QVector<int> &best, QVector<AspectHit> &hits) const
+{
+    const int firstHit = hits.size();
+
+    for (int k = 0; k < AspectKindCount; ++k) {
+        const AspectKind aspect = AspectKind(k);
+        const double angle = aspectAngle(aspect);
+        const double width = m_orbs.widestOrb(aspect);
+        if (width <= 0.0) {
+            continue;
+        }
+
+        auto check = [&](int pos) {
+            const int second = b.indexes[pos];
+            if (second < minSecond) {
+                return;
+            }
+
+            double separation = std::fabs(longitude - b.longitudes[pos]);
+            if (separation > 180.0) separation = 360.0 - separation;
+            const double orb = std::fabs(separation - angle);
+            if (orb > m_orbs.orbFor(aspect, body, b.bodies[second])) {
+                return;
+            }
+
+            // Keep only the tightest aspect of each pair
+            int &slot = best[second];
+            if (slot < 0) {
+                slot = hits.size();
+                hits.append({first, second, aspect, orb});
+            } else if (orb < hits[slot].orb) {
+                hits[slot].aspect = aspect;
+                hits[slot].orb = orb;
+            }
+        };
+
+        forEachInWindow(b, std::fmod(longitude + angle, 360.0), width, check);
+        if (angle > 0.0 && angle < 180.0) {
+            forEachInWindow(b, std::fmod(longitude - angle + 360.0, 360.0), width, check);
+        }
+    }
+
+    // Reset the slots this point used and restore input order
+    for (int i = firstHit; i < hits.size(); ++i) {
+        best[hits[i].second] = -1;
+    }
+    std::sort(hits.begin() + firstHit, hits.end(), [](const AspectHit &a, const AspectHit &b) {
+        return a.second < b.second;
+    });
+}
+
+QVector<AspectHit> AspectKernel::findWithin(const double *longitudes, const Body *bodies, int count) const
+{
+    QVector<AspectHit> hits;
+    const SortedPoints sorted = sortPoints(longitudes, bodies, count);
+    QVector<int> best(count, -1);
+
+    for (int i = 0; i < count; ++i) {
+        scanPoint(longitudes[i], bodies[i], i, sorted, i + 1, best, hits);
+    }
+    return hits;
+}
+
+void AspectKernel::findBetween(const double *longitudes, const Body *bodies, int count,
+                               const SortedPoints &b, QVector<AspectHit> &hits) const
+{
+    QVector<int> best(b.indexes.size(), -1);
+
+    for (int i = 0; i < count; ++i) {
+        scanPoint(longitudes[i], bodies[i], i, b, 0, best, hits);
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef ASPECTKERNEL_H
+#define ASPECTKERNEL_H
+
+#include <QVector>
+#include <algorithm>
+#include "astrotypes.h"
+
+// Allowed orb per aspect kind, scaled per body. A pair of bodies gets the
+// aspect's orb times the larger of the two body factors, so giving the
+// luminaries a factor above 1 widens every aspect they take part in.
+class AspectOrbTable
+{
+public:
+    AspectOrbTable();
+
+    // The app's default: majors get orbMax, minors 3/4 of it, all factors 1
+    static AspectOrbTable standard(double orbMax);
+
+    void setAspectOrb(AspectKind aspect, double orb);
+    double aspectOrb(AspectKind aspect) const { return m_aspectOrbs[int(aspect)]; }
+
+    void setBodyFactor(Body body, double factor);
+    double bodyFactor(Body body) const { return m_bodyFactors[int(body)]; }
+
+    double orbFor(AspectKind aspect, Body a, Body b) const {
+        return m_aspectOrbs[int(aspect)] * std::max(m_bodyFactors[int(a)], m_bodyFactors[int(b)]);
+    }
+
+    // Widest orb any pair can get for an aspect
+    double widestOrb(AspectKind aspect) const { return m_aspectOrbs[int(aspect)] * m_maxFactor; }
+
+    bool operator==(const AspectOrbTable &other) const;
+    bool operator!=(const AspectOrbTable &other) const { return !(*this == other); }
+
+private:
+    double m_aspectOrbs[AspectKindCount];
+    double m_bodyFactors[BodyCount];
+    double m_maxFactor = 1.0;
+};
+
+// One aspect found by the kernel; first/second index the input arrays
+struct AspectHit {
+    int first;
+    int second;
+    AspectKind aspect;
+    double orb;
+};
+
+// Table-driven aspect detection over plain longitude arrays. One side is
+// sorted by longitude; for every point and aspect angle only the points
+// inside the orb window are looked at, found by binary search. Each pair
+// reports only its tightest aspect. Serves natal and composite charts
+// (pairs within one set) as well as transits and synastry (pairs across
+// two sets).
+class AspectKernel
+{
+public:
+    explicit AspectKernel(const AspectOrbTable &orbs);
+
+    // A set of points sorted by longitude, reusable across many queries
+    // (e.g. the natal side of a transit scan)
+    struct SortedPoints {
+        QVector<double> longitudes;  // Ascending, in [0, 360)
+        QVector<int> indexes;        // Position of each entry in the input
+        QVector<Body> bodies;        // Bodies in input order
+    };
+
+    static SortedPoints sortPoints(const double *longitudes, const Body *bodies, int count);
+
+    // Every pair (i < j) of one set, ordered by (first, second)
+    QVector<AspectHit> findWithin(const double *longitudes, const Body *bodies, int count) const;
+
+    // Pairs across two sets; first indexes a, second indexes b.
+    // Appends to hits, ordered by (first, second) within this call.
+    void findBetween(const double *longitudes, const Body *bodies, int count,
+                     const SortedPoints &b, QVector<AspectHit> &hits) const;
+
+private:
+    // Calls visit(sortedPosition) for every point of b within [center - width, center + width]
+    template<typename Visit>
+    static void forEachInWindow(const SortedPoints &b, double center, double width, Visit visit);
+
+    void scanPoint(double longitude, Body body, int first, const SortedPoints &b,
+                   int minSecond, QVector<int> &best, QVector<AspectHit> &hits) const;
+
+    AspectOrbTable m_orbs;
+};
+
+#endif // ASPECTKERNEL_H
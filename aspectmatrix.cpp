@@ -0,0 +1,229 @@
+#include "aspectmatrix.h"
+#include <algorithm>
+#include <cmath>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ASPECTMATRIX_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+struct Params {
+    const double *natal;
+    const double *factors;
+    int count;
+    const int *aspects;      // Aspect kinds with a usable orb, in kind order
+    int aspectCount;
+    const double *angles;
+    const double *orbs;
+};
+
+// Reference version of the comparison, also used for the natal points left
+// over after the last full vector
+void scalarRange(const Params &p, double longitude, double factor, int row, int from,
+                 QVector<AspectHit> &hits)
+{
+    for (int j = from; j < p.count; ++j) {
+        double separation = std::fabs(longitude - p.natal[j]);
+        if (separation > 180.0) separation = 360.0 - separation;
+        const double pairFactor = std::max(factor, p.factors[j]);
+
+        int bestAspect = -1;
+        double bestOrb = 0.0;
+        for (int a = 0; a < p.aspectCount; ++a) {
+            const int k = p.aspects[a];
+            const double orb = std::fabs(separation - p.angles[k]);
+            if (orb <= p.orbs[k] * pairFactor && (bestAspect < 0 || orb < bestOrb)) {
+                bestAspect = k;
+                bestOrb = orb;
+            }
+        }
+
+        if (bestAspect >= 0) {
+            hits.append({row, j, AspectKind(bestAspect), bestOrb});
+        }
+    }
+}
+
+#ifdef ASPECTMATRIX_X86
+
+// Both vector versions keep, per lane, the tightest orb so far and the aspect
+// it belongs to (-1 for none), then emit the lanes that found one. The
+// arithmetic matches scalarRange step for step, so results are identical.
+
+__attribute__((target("sse4.1")))
+void sse41Row(const Params &p, double longitude, double factor, int row, QVector<AspectHit> &hits)
+{
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d fullCircle = _mm_set1_pd(360.0);
+    const __m128d none = _mm_set1_pd(-1.0);
+    const __m128d unbounded = _mm_set1_pd(HUGE_VAL);
+    const __m128d t = _mm_set1_pd(longitude);
+    const __m128d tf = _mm_set1_pd(factor);
+
+    int j = 0;
+    for (; j + 2 <= p.count; j += 2) {
+        __m128d separation = _mm_andnot_pd(signMask, _mm_sub_pd(t, _mm_loadu_pd(p.natal + j)));
+        separation = _mm_min_pd(separation, _mm_sub_pd(fullCircle, separation));
+        const __m128d pairFactor = _mm_max_pd(tf, _mm_loadu_pd(p.factors + j));
+
+        __m128d bestOrb = unbounded;
+        __m128d bestAspect = none;
+        for (int a = 0; a < p.aspectCount; ++a) {
+            const int k = p.aspects[a];
+            const __m128d orb = _mm_andnot_pd(signMask, _mm_sub_pd(separation, _mm_set1_pd(p.angles[k])));
+            const __m128d limit = _mm_mul_pd(_mm_set1_pd(p.orbs[k]), pairFactor);
+            const __m128d take = _mm_and_pd(_mm_cmple_pd(orb, limit), _mm_cmplt_pd(orb, bestOrb));
+            bestOrb = _mm_blendv_pd(bestOrb, orb, take);
+            bestAspect = _mm_blendv_pd(bestAspect, _mm_set1_pd(double(k)), take);
+        }
+
+        const int found = _mm_movemask_pd(_mm_cmpge_pd(bestAspect, _mm_setzero_pd()));
+        if (found) {
+            alignas(16) double orbs[2];
+            alignas(16) double aspects[2];
+            _mm_store_pd(orbs, bestOrb);
+            _mm_store_pd(aspects, bestAspect);
+            for (int lane = 0; lane < 2; ++lane) {
+                if (found & (1 << lane)) {
+                    hits.append({row, j + lane, AspectKind(int(aspects[lane])), orbs[lane]});
+                }
+            }
+        }
+    }
+
+    scalarRange(p, longitude, factor, row, j, hits);
+}
+
+__attribute__((target("avx2")))
+void avx2Row(const Params &p, double longitude, double factor, int row, QVector<AspectHit> &hits)
+{
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d fullCircle = _mm256_set1_pd(360.0);
+    const __m256d none = _mm256_set1_pd(-1.0);
+    const __m256d unbounded = _mm256_set1_pd(HUGE_VAL);
+    const __m256d t = _mm256_set1_pd(longitude);
+    const __m256d tf = _mm256_set1_pd(factor);
+
+    int j = 0;
+    for (; j + 4 <= p.count; j += 4) {
+        __m256d separation = _mm256_andnot_pd(signMask, _mm256_sub_pd(t, _mm256_loadu_pd(p.natal + j)));
+        separation = _mm256_min_pd(separation, _mm256_sub_pd(fullCircle, separation));
+        const __m256d pairFactor = _mm256_max_pd(tf, _mm256_loadu_pd(p.factors + j));
+
+        __m256d bestOrb = unbounded;
+        __m256d bestAspect = none;
+        for (int a = 0; a < p.aspectCount; ++a) {
+            const int k = p.aspects[a];
+            const __m256d orb = _mm256_andnot_pd(signMask, _mm256_sub_pd(separation, _mm256_set1_pd(p.angles[k])));
+            const __m256d limit = _mm256_mul_pd(_mm256_set1_pd(p.orbs[k]), pairFactor);
+            const __m256d take = _mm256_and_pd(_mm256_cmp_pd(orb, limit, _CMP_LE_OQ),
+                                               _mm256_cmp_pd(orb, bestOrb, _CMP_LT_OQ));
+            bestOrb = _mm256_blendv_pd(bestOrb, orb, take);
+            bestAspect = _mm256_blendv_pd(bestAspect, _mm256_set1_pd(double(k)), take);
+        }
+
+        const int found = _mm256_movemask_pd(_mm256_cmp_pd(bestAspect, _mm256_setzero_pd(), _CMP_GE_OQ));
+        if (found) {
+            alignas(32) double orbs[4];
+            alignas(32) double aspects[4];
+            _mm256_store_pd(orbs, bestOrb);
+            _mm256_store_pd(aspects, bestAspect);
+            for (int lane = 0; lane < 4; ++lane) {
+                if (found & (1 << lane)) {
+                    hits.append({row, j + lane, AspectKind(int(aspects[lane])), orbs[lane]});
+                }
+            }
+        }
+    }
+
+    scalarRange(p, longitude, factor, row, j, hits);
+}
+
+#endif // ASPECTMATRIX_X86
+
+AspectMatrix::Isa detectIsa()
+{
+#ifdef ASPECTMATRIX_X86
+    if (__builtin_cpu_supports("avx2")) {
+        return AspectMatrix::Isa::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return AspectMatrix::Isa::Sse41;
+    }
+#endif
+    return AspectMatrix::Isa::Scalar;
+}
+
+}
+
+AspectMatrix::AspectMatrix(const AspectOrbTable &orbs, const double *natalLongitudes,
+                           const Body *natalBodies, int natalCount)
+{
+    m_natalLongitudes.reserve(natalCount);
+    m_natalFactors.reserve(natalCount);
+    for (int i = 0; i < natalCount; ++i) {
+        m_natalLongitudes.append(natalLongitudes[i]);
+        m_natalFactors.append(orbs.bodyFactor(natalBodies[i]));
+    }
+
+    for (int k = 0; k < AspectKindCount; ++k) {
+        m_aspectAngles[k] = aspectAngle(AspectKind(k));
+        m_aspectOrbs[k] = orbs.aspectOrb(AspectKind(k));
+    }
+    for (int i = 0; i < BodyCount; ++i) {
+        m_bodyFactors[i] = orbs.bodyFactor(Body(i));
+    }
+}
+
+AspectMatrix::Isa AspectMatrix::activeIsa()
+{
+    static const Isa isa = detectIsa();
+    return isa;
+}
+
+const char *AspectMatrix::isaName(Isa isa)
+{
+    switch (isa) {
+    case Isa::Avx2:  return "AVX2";
+    case Isa::Sse41: return "SSE4.1";
+    default:         return "scalar";
+    }
+}
+
+void AspectMatrix::evaluate(const double *longitudes, const Body *bodies, int rowCount,
+                            QVector<AspectHit> &hits) const
+{
+    // Like AspectKernel, aspects whose orb is switched off are never reported
+    int aspects[AspectKindCount];
+    int aspectCount = 0;
+    for (int k = 0; k < AspectKindCount; ++k) {
+        if (m_aspectOrbs[k] > 0.0) {
+            aspects[aspectCount++] = k;
+        }
+    }
+
+    const Params p = {m_natalLongitudes.constData(), m_natalFactors.constData(),
+                      int(m_natalLongitudes.size()), aspects, aspectCount,
+                      m_aspectAngles, m_aspectOrbs};
+
+    const Isa isa = activeIsa();
+    for (int row = 0; row < rowCount; ++row) {
+        const double longitude = longitudes[row];
+        const double factor = m_bodyFactors[int(bodies[row])];
+        switch (isa) {
+#ifdef ASPECTMATRIX_X86
+        case Isa::Avx2:
+            avx2Row(p, longitude, factor, row, hits);
+            break;
+        case Isa::Sse41:
+            sse41Row(p, longitude, factor, row, hits);
+            break;
+#endif
+        default:
+            scalarRange(p, longitude, factor, row, 0, hits);
+            break;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef ASPECTMATRIX_H
+#define ASPECTMATRIX_H
+
+#include <QVector>
+#include "aspectkernel.h"
+
+// Brute-force aspect test of many rows (e.g. every transiting body on every
+// day of a scan) against one fixed set of natal points. The natal side is kept
+// as flat longitude and orb-factor arrays and compared a whole vector register
+// at a time: four natal points per step with AVX2, two with SSE4.1, one in the
+// scalar fallback. The instruction set is picked once at run time.
+//
+// The comparison is the same one AspectKernel makes, so both report the same
+// pairs, each with its tightest aspect.
+class AspectMatrix
+{
+public:
+    enum class Isa {
+        Scalar,
+        Sse41,
+        Avx2
+    };
+
+    AspectMatrix(const AspectOrbTable &orbs, const double *natalLongitudes,
+                 const Body *natalBodies, int natalCount);
+
+    // Test rows [0, rowCount) against every natal point. first indexes the
+    // rows, second the natal points; hits are appended ordered by
+    // (first, second).
+    void evaluate(const double *longitudes, const Body *bodies, int rowCount,
+                  QVector<AspectHit> &hits) const;
+
+    int natalCount() const { return m_natalLongitudes.size(); }
+
+    // Instruction set used by evaluate(), chosen for the running CPU
+    static Isa activeIsa();
+    static const char *isaName(Isa isa);
+
+private:
+    QVector<double> m_natalLongitudes;
+    QVector<double> m_natalFactors;
+    double m_aspectAngles[AspectKindCount];
+    double m_aspectOrbs[AspectKindCount];
+    double m_bodyFactors[BodyCount];
+};
+
+#endif // ASPECTMATRIX_H
@@ -4,13 +4,14 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QGridLayout>
+#include <QGroupBox>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QSettings>
 AspectSettingsDialog::AspectSettingsDialog(QWidget* parent)
     : QDialog(parent)
 {
-    setWindowTitle("Aspect Display Settings");
+    setWindowTitle("Aspect Settings");
     setupUI();
     loadCurrentSettings();
 }
@@ -27,9 +28,18 @@ void AspectSettingsDialog::saveSettings()
     // Save minor aspect settings
     AspectSettings::instance().setMinorAspectWidth(m_minorWidthSpinBox->value());
     AspectSettings::instance().setMinorAspectStyle(penStyleFromIndex(m_minorStyleCombo->currentIndex()));
+
+    // Save orbs, shown as a percentage of the max orb
+    for (int i = 0; i < AspectKindCount; ++i) {
+        setAspectOrbFactor(AspectKind(i), m_aspectOrbSpinBoxes[i]->value() / 100.0);
+    }
+    for (int i = 0; i < BodyCount; ++i) {
+        setBodyOrbFactor(Body(i), m_bodyOrbSpinBoxes[i]->value());
+    }
     //use mainwindows settings functionality
     QSettings settings;
     AspectSettings::instance().saveToSettings(settings);
+    saveOrbFactors(settings);
 
     accept();
 }
@@ -37,10 +47,12 @@ void AspectSettingsDialog::saveSettings()
 void AspectSettingsDialog::resetDefaults()
 {
     AspectSettings::instance().resetToDefaults();
+    resetOrbFactors();
 
     // Save defaults to disk
     QSettings settings;
     AspectSettings::instance().saveToSettings(settings);
+    saveOrbFactors(settings);
 
     loadCurrentSettings();
 }
@@ -90,6 +102,33 @@ void AspectSettingsDialog::setupUI()
 
     mainLayout->addLayout(gridLayout);
 
+    // Orbs per aspect, as a percentage of the max orb set in the main window
+    QGroupBox* aspectOrbBox = new QGroupBox("Aspect Orbs (% of max orb)");
+    QGridLayout* aspectOrbLayout = new QGridLayout(aspectOrbBox);
+    for (int i = 0; i < AspectKindCount; ++i) {
+        m_aspectOrbSpinBoxes[i] = new QDoubleSpinBox();
+        m_aspectOrbSpinBoxes[i]->setRange(0.0, 200.0);
+        m_aspectOrbSpinBoxes[i]->setSingleStep(5.0);
+        m_aspectOrbSpinBoxes[i]->setDecimals(0);
+        m_aspectOrbSpinBoxes[i]->setSuffix("%");
+        aspectOrbLayout->addWidget(new QLabel(aspectCode(AspectKind(i)) + ":"), i / 3, (i % 3) * 2);
+        aspectOrbLayout->addWidget(m_aspectOrbSpinBoxes[i], i / 3, (i % 3) * 2 + 1);
+    }
+    mainLayout->addWidget(aspectOrbBox);
+
+    // Per-body factors; a pair gets the larger factor of its two bodies
+    QGroupBox* bodyOrbBox = new QGroupBox("Body Orb Factors");
+    QGridLayout* bodyOrbLayout = new QGridLayout(bodyOrbBox);
+    for (int i = 0; i < BodyCount; ++i) {
+        m_bodyOrbSpinBoxes[i] = new QDoubleSpinBox();
+        m_bodyOrbSpinBoxes[i]->setRange(0.0, 3.0);
+        m_bodyOrbSpinBoxes[i]->setSingleStep(0.1);
+        m_bodyOrbSpinBoxes[i]->setDecimals(2);
+        bodyOrbLayout->addWidget(new QLabel(bodyName(Body(i)) + ":"), i / 3, (i % 3) * 2);
+        bodyOrbLayout->addWidget(m_bodyOrbSpinBoxes[i], i / 3, (i % 3) * 2 + 1);
+    }
+    mainLayout->addWidget(bodyOrbBox);
+
     // Add some spacing
     mainLayout->addStretch();
 
@@ -113,7 +152,7 @@ void AspectSettingsDialog::setupUI()
     mainLayout->addLayout(buttonLayout);
 
     // Set a reasonable size
-    resize(350, 300);
+    resize(560, 640);
 }
 
 void AspectSettingsDialog::populateStyleCombo(QComboBox* combo)
@@ -138,6 +177,14 @@ void AspectSettingsDialog::loadCurrentSettings()
     // Load minor aspect settings
     m_minorWidthSpinBox->setValue(AspectSettings::instance().getMinorAspectWidth());
     m_minorStyleCombo->setCurrentIndex(penStyleToIndex(AspectSettings::instance().getMinorAspectStyle()));
+
+    // Load orbs
+    for (int i = 0; i < AspectKindCount; ++i) {
+        m_aspectOrbSpinBoxes[i]->setValue(getAspectOrbFactor(AspectKind(i)) * 100.0);
+    }
+    for (int i = 0; i < BodyCount; ++i) {
+        m_bodyOrbSpinBoxes[i]->setValue(getBodyOrbFactor(Body(i)));
+    }
 }
 
 int AspectSettingsDialog::penStyleToIndex(Qt::PenStyle style)
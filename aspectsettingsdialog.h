@@ -5,6 +5,7 @@
 #include <QDoubleSpinBox>
 #include <QComboBox>
 #include <QCheckBox>
+#include "astrotypes.h"
 
 class AspectSettingsDialog : public QDialog {
     Q_OBJECT
@@ -28,6 +29,10 @@ private:
     QComboBox* m_majorStyleCombo;
     QDoubleSpinBox* m_minorWidthSpinBox;
     QComboBox* m_minorStyleCombo;
+
+    // Orbs for the next calculation
+    QDoubleSpinBox* m_aspectOrbSpinBoxes[AspectKindCount];
+    QDoubleSpinBox* m_bodyOrbSpinBoxes[BodyCount];
 };
 
 #endif // ASPECTSETTINGSDIALOG_H
@@ -0,0 +1,130 @@
+#include "astrotypes.h"
+#include <cmath>
+
+// Include Swiss Ephemeris headers
+extern "C" {
+#include "swephexp.h"
+}
+
+namespace {
+
+const char *const kBodyNames[BodyCount] = {
+    "Sun", "Moon", "Mercury", "Venus", "Mars",
+    "Jupiter", "Saturn", "Uranus", "Neptune", "Pluto",
+    "North Node", "South Node", "Chiron",
+    "Ceres", "Pallas", "Juno", "Vesta", "Lilith",
+    "Syzygy", "Pars Fortuna", "Part of Spirit", "Vertex", "East Point",
+    "Asc", "MC", "Desc", "IC"
+};
+
+const int kSweBodyIds[BodyCount] = {
+    SE_SUN, SE_MOON, SE_MERCURY, SE_VENUS, SE_MARS,
+    SE_JUPITER, SE_SATURN, SE_URANUS, SE_NEPTUNE, SE_PLUTO,
+    SE_TRUE_NODE, -1, SE_CHIRON,
+    SE_CERES, SE_PALLAS, SE_JUNO, SE_VESTA, SE_MEAN_APOG,
+    -1, -1, -1, -1, -1,
+    -1, -1, -1, -1
+};
+
+const char *const kSignNames[12] = {
+    "Aries", "Taurus", "Gemini", "Cancer", "Leo", "Virgo",
+    "Libra", "Scorpio", "Sagittarius", "Capricorn", "Aquarius", "Pisces"
+};
+
+double normalize360(double longitude)
+{
+    longitude = fmod(longitude, 360.0);
+    if (longitude < 0) longitude += 360.0;
+    return longitude;
+}
+
+struct AspectInfo {
+    const char *code;
+    double angle;
+    bool major;
+};
+
+const AspectInfo kAspects[AspectKindCount] = {
+    {"CON", 0.0, true},     // Conjunction
+    {"OPP", 180.0, true},   // Opposition
+    {"TRI", 120.0, true},   // Trine
+    {"SQR", 90.0, true},    // Square
+    {"SEX", 60.0, true},    // Sextile
+    {"QUI", 150.0, false},  // Quincunx
+    {"SSQ", 45.0, false},   // Semi-square
+    {"SQQ", 135.0, false},  // Sesquiquadrate
+    {"SSX", 30.0, false}    // Semi-sextile
+};
+
+}
+
+QString bodyName(Body body)
+{
+    return QString::fromLatin1(kBodyNames[int(body)]);
+}
+
+bool bodyFromName(const QString &name, Body *body)
+{
+    for (int i = 0; i < BodyCount; ++i) {
+        if (name == QLatin1String(kBodyNames[i])) {
+            *body = Body(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+int sweBodyId(Body body)
+{
+    return kSweBodyIds[int(body)];
+}
+
+double aspectAngle(AspectKind kind)
+{
+    return kAspects[int(kind)].angle;
+}
+
+QString aspectCode(AspectKind kind)
+{
+    return QString::fromLatin1(kAspects[int(kind)].code);
+}
+
+bool aspectFromCode(const QString &code, AspectKind *kind)
+{
+    for (int i = 0; i < AspectKindCount; ++i) {
+        if (code == QLatin1String(kAspects[i].code)) {
+            *kind = AspectKind(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isMajorAspect(AspectKind kind)
+{
+    return kAspects[int(kind)].major;
+}
+
+Sign signOf(double longitude)
+{
+    return Sign(static_cast<int>(normalize360(longitude) / 30.0));
+}
+
+QString signName(Sign sign)
+{
+    return QString::fromLatin1(kSignNames[int(sign)]);
+}
+
+QString formatSignPosition(double longitude)
+{
+    longitude = normalize360(longitude);
+
+    // Calculate sign index (0-11) and the position within the sign
+    int signIndex = static_cast<int>(longitude / 30.0);
+    double degreeInSign = longitude - (signIndex * 30.0);
+
+    int degree = static_cast<int>(degreeInSign);
+    int minute = static_cast<int>((degreeInSign - degree) * 60);
+
+    return QString("%1 %2° %3'").arg(QString::fromLatin1(kSignNames[signIndex])).arg(degree).arg(minute);
+}
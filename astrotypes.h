@@ -0,0 +1,95 @@
+#ifndef ASTROTYPES_H
+#define ASTROTYPES_H
+
+#include <QString>
+#include <QtGlobal>
+
+// Chart points known to the calculator. The numeric values are stable and are
+// used as indexes into per-body tables, so new points are only ever appended.
+enum class Body : quint8 {
+    Sun,
+    Moon,
+    Mercury,
+    Venus,
+    Mars,
+    Jupiter,
+    Saturn,
+    Uranus,
+    Neptune,
+    Pluto,
+    NorthNode,
+    SouthNode,
+    Chiron,
+    Ceres,
+    Pallas,
+    Juno,
+    Vesta,
+    Lilith,
+    Syzygy,
+    ParsFortuna,
+    PartOfSpirit,
+    Vertex,
+    EastPoint,
+    Asc,
+    MC,
+    Desc,
+    IC
+};
+
+constexpr int BodyCount = int(Body::IC) + 1;
+
+// Aspects used throughout the app, in the order the calculator checks them
+enum class AspectKind : quint8 {
+    Conjunction,
+    Opposition,
+    Trine,
+    Square,
+    Sextile,
+    Quincunx,
+    SemiSquare,
+    Sesquiquadrate,
+    SemiSextile
+};
+
+constexpr int AspectKindCount = int(AspectKind::SemiSextile) + 1;
+
+// Zodiac signs, 30 degrees each from 0 Aries
+enum class Sign : quint8 {
+    Aries,
+    Taurus,
+    Gemini,
+    Cancer,
+    Leo,
+    Virgo,
+    Libra,
+    Scorpio,
+    Sagittarius,
+    Capricorn,
+    Aquarius,
+    Pisces
+};
+
+// Display names, as used in chart data, saved charts and the transit report
+QString bodyName(Body body);
+bool bodyFromName(const QString &name, Body *body);
+
+// Swiss Ephemeris body number, or -1 for points derived from other data
+// (South Node, Syzygy, Lots, Vertex, East Point and the angles)
+int sweBodyId(Body body);
+
+// Exact angle and three-letter code ("CON", "SQR", ...) of an aspect
+double aspectAngle(AspectKind kind);
+QString aspectCode(AspectKind kind);
+bool aspectFromCode(const QString &code, AspectKind *kind);
+
+// Majors get the full orb, minors 3/4 of it
+bool isMajorAspect(AspectKind kind);
+
+// Sign of an ecliptic longitude (any value, normalized to 0-360)
+Sign signOf(double longitude);
+QString signName(Sign sign);
+
+// Position within its sign as shown in chart data, e.g. "Aries 12° 34'"
+QString formatSignPosition(double longitude);
+
+#endif // ASTROTYPES_H
@@ -0,0 +1,38 @@
+#include "calculationoptions.h"
+#include "Globals.h"
+
+CalculationOptions CalculationOptions::fromGlobals(const QString &houseSystem)
+{
+    CalculationOptions options;
+    for (int i = 0; i < AspectKindCount; ++i) {
+        options.orbs.setAspectOrb(AspectKind(i), getOrbMax() * getAspectOrbFactor(AspectKind(i)));
+    }
+    for (int i = 0; i < BodyCount; ++i) {
+        options.orbs.setBodyFactor(Body(i), getBodyOrbFactor(Body(i)));
+    }
+    options.houseSystem = houseSystem;
+    options.additionalBodies = GlobalFlags::additionalBodiesEnabled;
+    options.transitChartPoints = GlobalFlags::transitChartPointsEnabled;
+    return options;
+}
+
+bool CalculationOptions::operator==(const CalculationOptions &other) const
+{
+    return orbs == other.orbs
+            && houseSystem == other.houseSystem
+            && additionalBodies == other.additionalBodies
+            && transitChartPoints == other.transitChartPoints;
+}
+
+size_t qHash(const CalculationOptions &options, size_t seed)
+{
+    seed = qHashMulti(seed, options.houseSystem, options.additionalBodies,
+                      options.transitChartPoints);
+    for (int i = 0; i < AspectKindCount; ++i) {
+        seed = qHashMulti(seed, options.orbs.aspectOrb(AspectKind(i)));
+    }
+    for (int i = 0; i < BodyCount; ++i) {
+        seed = qHashMulti(seed, options.orbs.bodyFactor(Body(i)));
+    }
+    return seed;
+}
@@ -0,0 +1,40 @@
+#ifndef CALCULATIONOPTIONS_H
+#define CALCULATIONOPTIONS_H
+
+#include <QString>
+#include <QHashFunctions>
+#include "aspectkernel.h"
+
+// Everything besides the birth data that changes a calculation's result.
+// The calculator reads its settings only from this value, never from the
+// globals, so two jobs with different settings can run side by side and the
+// same inputs always give the same output. Take a snapshot of the app
+// settings with fromGlobals() on the UI thread and pass it down by value.
+struct CalculationOptions {
+    // Orb per aspect and per-body orb factors
+    AspectOrbTable orbs = AspectOrbTable::standard(8.0);
+
+    // Used where the call has no house system of its own (transit scans,
+    // natal charts, return charts)
+    QString houseSystem = "Placidus";
+
+    // Natal charts and transit scans include the asteroids, Lilith, the
+    // Syzygy, Lots, Vertex and East Point
+    bool additionalBodies = false;
+
+    // With additionalBodies, let the points taken from the houses transit
+    // too (a full chart per scanned day)
+    bool transitChartPoints = false;
+
+    // The orb, body factor and body set settings of the app, and the given
+    // house system
+    static CalculationOptions fromGlobals(const QString &houseSystem = "Placidus");
+
+    bool operator==(const CalculationOptions &other) const;
+    bool operator!=(const CalculationOptions &other) const { return !(*this == other); }
+};
+
+// For using options as (part of) a cache key
+size_t qHash(const CalculationOptions &options, size_t seed = 0);
+
+#endif // CALCULATIONOPTIONS_H
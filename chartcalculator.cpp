@@ -10,8 +10,17 @@
 #include <QCoreApplication>
 #include <QDateTime>
 #include <QTimeZone>
+#include <QMutex>
+#include <algorithm>
 #include <cmath>
-#include"Globals.h"
+#include <cstdio>
+#include "ephemeriscontext.h"
+#include "ephemeriscache.h"
+#include "transitengine.h"
+#include "returnengine.h"
+#include "lunation.h"
+#include "aspectkernel.h"
+#include "aspectmatrix.h"
 // Include Swiss Ephemeris headers
 extern "C" {
 #include "swephexp.h"
@@ -41,68 +50,23 @@ ChartCalculator::ChartCalculator(QObject *parent)
 
 ChartCalculator::~ChartCalculator()
 {
-    // Close Swiss Ephemeris
-    if (m_isInitialized) {
-        swe_close();
-    }
+    // Nothing to close here: the Swiss Ephemeris state belongs to the thread,
+    // not to this instance, and EphemerisContext releases it at thread exit.
 }
 
 
 
 bool ChartCalculator::initialize()
 {
-    // Possible locations for ephemeris files
-    QStringList searchPaths;
-
-#ifdef FLATHUB_BUILD
-        // For Flatpak builds, the ephemeris files are in /app/share/swisseph
-    searchPaths << "/app/share/swisseph";
-#else
-        // Standard locations for non-Flatpak builds
-    searchPaths << QCoreApplication::applicationDirPath() + "/ephemeris"
-                << QCoreApplication::applicationDirPath() + "/../share/Asteria/ephemeris"
-                << "/app/share/Asteria/ephemeris"
-                << QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/ephemeris";
-#endif
-
-    // Find first valid path
-    for (const QString& path : searchPaths) {
-        if (path.isEmpty()) continue;
-
-        QDir dir(path);
-        if (dir.exists()) {
-            // Check for existence of key ephemeris files
-            if (dir.exists("sepl_18.se1") || dir.exists("sepl_20.se1") ||
-                dir.exists("seas_18.se1") || dir.exists("semo_18.se1")) {
-
-                m_ephemerisPath = path;
-
-                // Set ephemeris path for Swiss Ephemeris
-                QByteArray pathBytes = m_ephemerisPath.toLocal8Bit();
-                swe_set_ephe_path(pathBytes.constData());
-
-                // Debug output to verify files are accessible
-                QStringList files = dir.entryList(QDir::Files, QDir::Name);
-                for (int i = 0; i < qMin(5, files.size()); i++) {
-                }
-                if (files.size() > 5) {
-                }
-
-                m_isInitialized = true;
-                return true;
-            }
-        }
-    }
-
-    // If we get here, no valid path was found
-    qWarning() << "Ephemeris files not found in any standard location!";
-    qWarning() << "Searched paths:";
-    for (const QString& path : searchPaths) {
-        qWarning() << "  " << path;
+    // The ephemeris search runs once per process; later instances only pick
+    // up the resolved path
+    if (!EphemerisContext::initialize(&m_lastError)) {
+        return false;
     }
 
-    m_lastError = "Ephemeris files not found. Please check installation.";
-    return false;
+    m_ephemerisPath = EphemerisContext::ephemerisPath();
+    m_isInitialized = true;
+    return true;
 }
 
 
@@ -117,6 +81,10 @@ bool ChartCalculator::isAvailable() const {
     return true;
 }
 
+double ChartCalculator::julianDay(const QDate &date, const QTime &time, const QString &utcOffset) const {
+    return dateTimeToJulianDay(QDateTime(date, time), utcOffset);
+}
+
 
 
 
@@ -207,25 +175,7 @@ QString ChartCalculator::getZodiacSign(double longitude) const {
 */
 
 QString ChartCalculator::getZodiacSign(double longitude) const {
-    // Normalize longitude to 0-360
-    longitude = fmod(longitude, 360.0);
-    if (longitude < 0) longitude += 360.0;
-
-    // Calculate sign index (0-11)
-    int signIndex = static_cast<int>(longitude / 30.0);
-    double degreeInSign = longitude - (signIndex * 30.0);
-
-    // Calculate degrees and minutes within the sign
-    int degree = static_cast<int>(degreeInSign);
-    int minute = static_cast<int>((degreeInSign - degree) * 60);
-
-    // Return sign name
-    static const QString signs[] = {
-        "Aries", "Taurus", "Gemini", "Cancer", "Leo", "Virgo",
-        "Libra", "Scorpio", "Sagittarius", "Capricorn", "Aquarius", "Pisces"
-    };
-
-    return QString("%1 %2° %3'").arg(signs[signIndex]).arg(degree).arg(minute);
+    return formatSignPosition(longitude);
 }
 
 
@@ -257,55 +207,36 @@ QString ChartCalculator::findHouse(double longitude, const QVector<HouseData> &h
     return "House1";
 }
 
-QVector<AspectData> ChartCalculator::calculateAspects(const QVector<PlanetData> &planets, double orbMax) const {
-    QVector<AspectData> aspects;
-
-    // Define aspect types and their angles
-    struct AspectType {
-        QString name;
-        double angle;
-        double orb;
-    };
-    orbMax= getOrbMax();
-    const AspectType aspectTypes[] = {
-        {"CON", 0.0, orbMax},      // Conjunction
-        {"OPP", 180.0, orbMax},    // Opposition
-        {"TRI", 120.0, orbMax},    // Trine
-        {"SQR", 90.0, orbMax},     // Square
-        {"SEX", 60.0, orbMax},     // Sextile
-        {"QUI", 150.0, orbMax * 0.75},  // Quintile
-        {"SSQ", 45.0, orbMax * 0.75},  // Semi-square
-        {"SQQ", 135.0, orbMax * 0.75}, // Sesquiquadrate
-        {"SSX", 30.0, orbMax * 0.75}  // Semi-sextile
-        //{"SSP", 0.0, orbMax * 0.5},     // Semiparallel (custom) - typically for declination
-        //{"PAR", 0.0, orbMax * 0.5}      // Parallel (custom) - typically for declination
-    };
-
-    // Calculate aspects between all planets
+QVector<AspectData> ChartCalculator::calculateAspects(const QVector<PlanetData> &planets,
+                                                      const AspectOrbTable &orbs) const {
+    QVector<double> longitudes;
+    QVector<Body> bodies;
+    QVector<int> source;
+    longitudes.reserve(planets.size());
+    bodies.reserve(planets.size());
+    source.reserve(planets.size());
     for (int i = 0; i < planets.size(); i++) {
-        for (int j = i + 1; j < planets.size(); j++) {
-            double angle1 = planets[i].longitude;
-            double angle2 = planets[j].longitude;
-
-            // Calculate the smallest angle between the two planets
-            double diff = fabs(angle1 - angle2);
-            if (diff > 180.0) diff = 360.0 - diff;
-
-            // Check each aspect type
-            for (const AspectType &aspectType : aspectTypes) {
-                double orb = fabs(diff - aspectType.angle);
-                if (orb <= aspectType.orb) {
-                    AspectData aspect;
-                    aspect.planet1 = planets[i].id;
-                    aspect.planet2 = planets[j].id;
-                    aspect.aspectType = aspectType.name;
-                    aspect.orb = orb;
-                    aspects.append(aspect);
-                    break;  // Only add the closest matching aspect
-                }
-            }
+        Body body;
+        if (bodyFromName(planets[i].id, &body)) {
+            longitudes.append(planets[i].longitude);
+            bodies.append(body);
+            source.append(i);
         }
     }
+
+    AspectKernel kernel(orbs);
+    const QVector<AspectHit> hits = kernel.findWithin(longitudes.constData(), bodies.constData(), longitudes.size());
+
+    QVector<AspectData> aspects;
+    aspects.reserve(hits.size());
+    for (const AspectHit &hit : hits) {
+        AspectData aspect;
+        aspect.planet1 = planets[source[hit.first]].id;
+        aspect.planet2 = planets[source[hit.second]].id;
+        aspect.aspectType = aspectCode(hit.aspect);
+        aspect.orb = hit.orb;
+        aspects.append(aspect);
+    }
     return aspects;
 }
 
@@ -316,13 +247,13 @@ ChartData ChartCalculator::calculateChart(const QDate &birthDate,
                                           const QString &utcOffset,
                                           const QString &latitude,
                                           const QString &longitude,
-                                          const QString &houseSystem,
-                                          double orbMax) {
+                                          const CalculationOptions &options) {
     ChartData data;
     if (!m_isInitialized) {
         m_lastError = "Swiss Ephemeris not initialized";
         return data;
     }
+    EphemerisContext::Lease lease;
 
     // Convert input to required format
     QDateTime birthDateTime(birthDate, birthTime);
@@ -332,181 +263,290 @@ ChartData ChartCalculator::calculateChart(const QDate &birthDate,
     // Convert to Julian day
     double jd = dateTimeToJulianDay(birthDateTime, utcOffset);
 
-    // Calculate house cusps
-    QVector<HouseData> houses = calculateHouseCusps(jd, lat, lon, houseSystem);
-    data.houses = houses;
-
-    // Calculate angles (Asc, MC, etc.)
-    data.angles = calculateAngles(jd, lat, lon, houseSystem);
-    // Calculate planet positions
-    data.planets = calculatePlanetPositions(jd, houses);
-
-    ////////// Add Syzygy and Pars Fortuna and other methods
-    addSyzygyAndParsFortuna(data.planets, jd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, jd, houses);
-    ///////////
+    // Houses, angles, planets and the additional points
+    data = calculatePositions(jd, lat, lon, options.houseSystem, true);
 
     // Calculate aspects
-    orbMax = getOrbMax();
-    data.aspects = calculateAspects(data.planets, orbMax);
+    data.aspects = calculateAspects(data.planets, options.orbs);
     return data;
 }
 
+QVector<ChartData> ChartCalculator::calculateCharts(const QVector<ChartRequest> &requests,
+                                                    const CalculationOptions &options)
+{
+    QVector<ChartData> results(requests.size());
+    QVector<QString> errors(requests.size());
+    ChartData *out = results.data();
+    QString *errorOut = errors.data();
+
+    EphemerisPool::parallelFor(requests.size(), [&](int i) {
+        // One calculator per task keeps error state apart between threads
+        ChartCalculator calculator;
+        const ChartRequest &request = requests.at(i);
+        CalculationOptions requestOptions = options;
+        requestOptions.houseSystem = request.houseSystem;
+        out[i] = calculator.calculateChart(request.birthDate, request.birthTime,
+                                           request.utcOffset, request.latitude,
+                                           request.longitude, requestOptions);
+        errorOut[i] = calculator.getLastError();
+    });
 
+    m_lastError.clear();
+    for (const QString &error : errors) {
+        if (!error.isEmpty()) {
+            m_lastError = error;
+            break;
+        }
+    }
+    return results;
+}
 
+QVector<CompactChart> ChartCalculator::calculateCompactCharts(const QVector<ChartRequest> &requests,
+                                                              const CalculationOptions &options)
+{
+    QVector<CompactChart> results(requests.size());
+    QVector<QString> errors(requests.size());
+    CompactChart *out = results.data();
+    QString *errorOut = errors.data();
+
+    EphemerisPool::parallelFor(requests.size(), [&](int i) {
+        ChartCalculator calculator;
+        const ChartRequest &request = requests.at(i);
+        CalculationOptions requestOptions = options;
+        requestOptions.houseSystem = request.houseSystem;
+        out[i] = CompactChart::fromChartData(
+                    calculator.calculateChart(request.birthDate, request.birthTime,
+                                              request.utcOffset, request.latitude,
+                                              request.longitude, requestOptions));
+        errorOut[i] = calculator.getLastError();
+    });
 
-QVector<HouseData> ChartCalculator::calculateHouseCusps(double jd, double lat, double lon, const QString &houseSystem) const {
-    QVector<HouseData> houses;
+    m_lastError.clear();
+    for (const QString &error : errors) {
+        if (!error.isEmpty()) {
+            m_lastError = error;
+            break;
+        }
+    }
+    return results;
+}
 
-    // Convert house system string to char
-    char hsys = 'P'; // Placidus by default
-    if (houseSystem == "Placidus") hsys = 'P';
-    else if (houseSystem == "Koch") hsys = 'K';
-    else if (houseSystem == "Porphyrius") hsys = 'O';
-    else if (houseSystem == "Regiomontanus") hsys = 'R';
-    else if (houseSystem == "Campanus") hsys = 'C';
-    else if (houseSystem == "Equal") hsys = 'E';
-    else if (houseSystem == "Whole Sign") hsys = 'W';
 
+char ChartCalculator::houseSystemCode(const QString &houseSystem)
+{
+    if (houseSystem == "Koch") return 'K';
+    if (houseSystem == "Porphyrius") return 'O';
+    if (houseSystem == "Regiomontanus") return 'R';
+    if (houseSystem == "Campanus") return 'C';
+    if (houseSystem == "Equal") return 'E';
+    if (houseSystem == "Whole Sign") return 'W';
+    return 'P'; // Placidus by default
+}
 
+ChartCalculator::HouseFrame ChartCalculator::calculateHouseFrame(double jd, double lat, double lon,
+                                                                 const QString &houseSystem) const {
+    HouseFrame frame;
 
-    // Arrays to hold house cusps and ascmc values
+    // One call gives the cusps and every ascmc point the chart needs
     double cusps[13] = {0};
     double ascmc[10] = {0};
-
-    // Calculate house cusps
-    int result = swe_houses(jd, lat, lon, hsys, cusps, ascmc);
-
-    if (result < 0) {
+    if (swe_houses_ex(jd, 0, lat, lon, houseSystemCode(houseSystem), cusps, ascmc) < 0) {
         qWarning() << "Error calculating house cusps";
-        return houses;
+        return frame;
     }
 
-    // Process house cusps
+    frame.houses.reserve(12);
     for (int i = 1; i <= 12; i++) {
         HouseData house;
         house.id = QString("House%1").arg(i);
         house.longitude = cusps[i];
         house.sign = getZodiacSign(house.longitude);
-        houses.append(house);
+        frame.houses.append(house);
     }
 
-    return houses;
+    const double angleLongitudes[4] = {
+        ascmc[SE_ASC],
+        ascmc[SE_MC],
+        fmod(ascmc[SE_ASC] + 180.0, 360.0),
+        fmod(ascmc[SE_MC] + 180.0, 360.0)
+    };
+    const char *angleIds[4] = {"Asc", "MC", "Desc", "IC"};
+    frame.angles.reserve(4);
+    for (int i = 0; i < 4; i++) {
+        AngleData angle;
+        angle.id = angleIds[i];
+        angle.longitude = angleLongitudes[i];
+        angle.sign = getZodiacSign(angle.longitude);
+        frame.angles.append(angle);
+    }
+
+    frame.ascendant = ascmc[SE_ASC];
+    frame.vertex = ascmc[SE_VERTEX];
+    frame.eastPoint = ascmc[SE_EQUASC];
+    frame.valid = true;
+    return frame;
 }
 
-QVector<AngleData> ChartCalculator::calculateAngles(double jd, double lat, double lon, const QString &houseSystem) const {
-    QVector<AngleData> angles;
-
-    // Convert house system string to char (same as in calculateHouseCusps)
-    char hsys = 'P'; // Placidus by default
-    if (houseSystem == "Placidus") hsys = 'P';
-    else if (houseSystem == "Koch") hsys = 'K';
-    else if (houseSystem == "Porphyrius") hsys = 'O';
-    else if (houseSystem == "Regiomontanus") hsys = 'R';
-    else if (houseSystem == "Campanus") hsys = 'C';
-    else if (houseSystem == "Equal") hsys = 'E';
-    else if (houseSystem == "Whole Sign") hsys = 'W';
-
-
-    // Arrays to hold house cusps and ascmc values
-    double cusps[13] = {0};
-    double ascmc[10] = {0};
+ChartData ChartCalculator::calculatePositions(double jd, double lat, double lon,
+                                              const QString &houseSystem,
+                                              bool additionalBodies) const {
+    ChartData data;
+    HouseFrame frame = calculateHouseFrame(jd, lat, lon, houseSystem);
 
-    // Calculate house cusps with the specified house system
-    int result = swe_houses(jd, lat, lon, hsys, cusps, ascmc);
-    if (result < 0) {
-        qWarning() << "Error calculating angles";
-        return angles;
-    }
-
-    // Add Ascendant
-    AngleData asc;
-    asc.id = "Asc";
-    asc.longitude = ascmc[0];
-    asc.sign = getZodiacSign(asc.longitude);
-    angles.append(asc);
-
-    // Add Midheaven
-    AngleData mc;
-    mc.id = "MC";
-    mc.longitude = ascmc[1];
-    mc.sign = getZodiacSign(mc.longitude);
-    angles.append(mc);
-
-    // Add Descendant
-    AngleData desc;
-    desc.id = "Desc";
-    desc.longitude = fmod(ascmc[0] + 180.0, 360.0);
-    desc.sign = getZodiacSign(desc.longitude);
-    angles.append(desc);
-
-    // Add Imum Coeli
-    AngleData ic;
-    ic.id = "IC";
-    ic.longitude = fmod(ascmc[1] + 180.0, 360.0);
-    ic.sign = getZodiacSign(ic.longitude);
-    angles.append(ic);
-
-    return angles;
+    data.planets = placeBodies(calculateBodyPositions(jd, additionalBodies), frame);
+    data.houses = frame.houses;
+    data.angles = frame.angles;
+    return data;
 }
 
-QVector<PlanetData> ChartCalculator::calculatePlanetPositions(double jd, const QVector<HouseData> &houses) const {
-    QVector<PlanetData> planets;
-    // Define the planets to calculate
-    int planetIds[] = {
-        SE_SUN, SE_MOON, SE_MERCURY, SE_VENUS, SE_MARS,
-        SE_JUPITER, SE_SATURN, SE_URANUS, SE_NEPTUNE, SE_PLUTO,
-        SE_TRUE_NODE, SE_CHIRON
-    };
+ChartCalculator::BodyPositions ChartCalculator::calculateBodyPositions(double jd, bool additionalBodies) const {
+    BodyPositions positions;
+    QVector<PlanetData> &planets = positions.planets;
+    QVector<Body> &bodies = positions.bodies;
 
-    QString planetNames[] = {
-        "Sun", "Moon", "Mercury", "Venus", "Mars",
-        "Jupiter", "Saturn", "Uranus", "Neptune", "Pluto",
-        "North Node", "Chiron"
+    auto append = [&](Body body, const PlanetData &planet) {
+        planets.append(planet);
+        bodies.append(body);
     };
 
-    int numPlanets = sizeof(planetIds) / sizeof(planetIds[0]);
+    // Points that come from the houses get an entry in their place in the
+    // list; placeBodies() fills them in
+    auto appendPlaceholder = [&](Body body) {
+        PlanetData point;
+        point.id = bodyName(body);
+        point.longitude = 0.0;
+        point.latitude = 0.0;
+        append(body, point);
+    };
 
-    // Calculate each planet
-    for (int i = 0; i < numPlanets; i++) {
+    auto calculate = [&](Body body, int sweId, int flags) {
         double xx[6]; // Position and speed
         char serr[256];
-
-        // Calculate planet position
-        int flag = SEFLG_SPEED | SEFLG_SWIEPH;
-        int ret = swe_calc_ut(jd, planetIds[i], flag, xx, serr);
-
-        if (ret < 0) {
-            qWarning() << "Error calculating position for planet" << planetNames[i] << ":" << serr;
-            continue;
+        if (swe_calc_ut(jd, sweId, flags, xx, serr) < 0) {
+            qWarning() << "Error calculating position for planet" << bodyName(body) << ":" << serr;
+            return;
         }
 
         PlanetData planet;
-        planet.id = planetNames[i];
+        planet.id = bodyName(body);
         planet.longitude = xx[0]; // Longitude in degrees
         planet.latitude = xx[1];  // Latitude in degrees
         planet.sign = getZodiacSign(planet.longitude);
         planet.isRetrograde = (xx[3] < 0); // Retrograde if speed is negative
-        planet.house = findHouse(planet.longitude, houses);
+        append(body, planet);
+    };
 
-        planets.append(planet);
+    // Define the planets to calculate
+    const Body mainBodies[] = {
+        Body::Sun, Body::Moon, Body::Mercury, Body::Venus, Body::Mars,
+        Body::Jupiter, Body::Saturn, Body::Uranus, Body::Neptune, Body::Pluto,
+        Body::NorthNode, Body::Chiron
+    };
+    for (Body body : mainBodies) {
+        calculate(body, sweBodyId(body), SEFLG_SPEED | SEFLG_SWIEPH);
     }
 
     // Add South Node (opposite to North Node)
-    for (const PlanetData &planet : planets) {
-        if (planet.id == "North Node") {
-            PlanetData southNode;
-            southNode.id = "South Node";
-            southNode.longitude = fmod(planet.longitude + 180.0, 360.0);
-            southNode.latitude = -planet.latitude;
-            southNode.sign = getZodiacSign(southNode.longitude);
-            southNode.isRetrograde = planet.isRetrograde;
-            southNode.house = findHouse(southNode.longitude, houses);
-            planets.append(southNode);
+    int northNode = bodies.indexOf(Body::NorthNode);
+    if (northNode >= 0) {
+        PlanetData southNode;
+        southNode.id = "South Node";
+        southNode.longitude = fmod(planets[northNode].longitude + 180.0, 360.0);
+        southNode.latitude = -planets[northNode].latitude;
+        southNode.sign = getZodiacSign(southNode.longitude);
+        southNode.isRetrograde = planets[northNode].isRetrograde;
+        append(Body::SouthNode, southNode);
+    }
+
+    if (!additionalBodies) {
+        return positions;
+    }
+
+    // Syzygy (Pre-Natal Lunation - New or Full Moon). Both New and Full Moon
+    // use the Sun's position at the syzygy (NOT Sun + 180 for the Full Moon),
+    // following the traditional Syzygy calculation, so only the Sun is
+    // needed. Without a lunation the Sun at birth is used.
+    double syzygyJd = jd;
+    Lunation lunation;
+    if (findPreviousLunation(jd, &lunation)) {
+        syzygyJd = lunation.jd;
+    }
+    double xx[6];
+    char serr[256] = {0};
+    if (swe_calc_ut(syzygyJd, SE_SUN, SEFLG_SWIEPH, xx, serr) >= 0) {
+        PlanetData syzygy;
+        syzygy.id = "Syzygy";
+        syzygy.longitude = xx[0];
+        syzygy.latitude = 0.0;
+        syzygy.sign = getZodiacSign(syzygy.longitude);
+        syzygy.isRetrograde = false;
+        append(Body::Syzygy, syzygy);
+    }
+
+    appendPlaceholder(Body::ParsFortuna);
+
+    // Ceres, Pallas, Juno, Vesta (major asteroids)
+    for (Body body : {Body::Ceres, Body::Pallas, Body::Juno, Body::Vesta}) {
+        calculate(body, sweBodyId(body), SEFLG_SWIEPH | SEFLG_SPEED);
+    }
+
+    appendPlaceholder(Body::Vertex);
+
+    // Lilith (Mean Black Moon)
+    calculate(Body::Lilith, SE_MEAN_APOG, SEFLG_SWIEPH | SEFLG_SPEED);
+
+    appendPlaceholder(Body::PartOfSpirit);
+    appendPlaceholder(Body::EastPoint);
+
+    return positions;
+}
+
+QVector<PlanetData> ChartCalculator::placeBodies(const BodyPositions &positions,
+                                                 const HouseFrame &frame) const {
+    const QVector<HouseData> &houses = frame.houses;
+
+    int sun = positions.bodies.indexOf(Body::Sun);
+    int moon = positions.bodies.indexOf(Body::Moon);
+    double sun_lon = sun >= 0 ? positions.planets[sun].longitude : 0.0;
+    double moon_lon = moon >= 0 ? positions.planets[moon].longitude : 0.0;
+    double asc = frame.ascendant;
+
+    QVector<PlanetData> planets;
+    planets.reserve(positions.planets.size());
+    for (int i = 0; i < positions.planets.size(); i++) {
+        PlanetData planet = positions.planets[i];
+        bool derived = true;
+
+        switch (positions.bodies[i]) {
+        case Body::ParsFortuna:
+            planet.longitude = fmod(asc + moon_lon - sun_lon, 360.0);
+            break;
+        case Body::PartOfSpirit:
+            // Reverse of Pars Fortuna
+            planet.longitude = fmod(asc + sun_lon - moon_lon, 360.0);
+            break;
+        case Body::Vertex:
+            if (!frame.valid) continue;
+            planet.longitude = frame.vertex;
+            break;
+        case Body::EastPoint:
+            // Equatorial ascendant
+            if (!frame.valid) continue;
+            planet.longitude = frame.eastPoint;
+            break;
+        default:
+            derived = false;
             break;
         }
-    }
 
+        if (derived) {
+            if (planet.longitude < 0) planet.longitude += 360.0;
+            planet.sign = getZodiacSign(planet.longitude);
+            planet.isRetrograde = false;
+        }
+        planet.house = findHouse(planet.longitude, houses);
+        planets.append(planet);
+    }
     return planets;
 }
 
@@ -519,34 +559,10 @@ ChartData ChartCalculator::calculateSolarReturn(const QDate &birthDate,
                                                 const QString &utcOffset,
                                                 const QString &latitude,
                                                 const QString &longitude,
-                                                const QString &houseSystem,
+                                                const CalculationOptions &options,
 
                                                 int year)
 {
-    ChartData data;
-
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
-        return data;
-    }
-
-    // Convert birth data to Julian day
-    QDateTime birthDateTime(birthDate, birthTime);
-    double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
-
-    // Get Sun's position at birth
-    double xx[6];
-    char serr[256];
-    int flag = SEFLG_SWIEPH;
-    int ret = swe_calc_ut(birthJd, SE_SUN, flag, xx, serr);
-
-    if (ret < 0) {
-        m_lastError = QString("Error calculating Sun position: %1").arg(serr);
-        return data;
-    }
-
-    double sunLongitude = xx[0];
-
     // Estimate solar return time (around birthday in the target year)
     QDate approxDate(year, birthDate.month(), birthDate.day());
     if (!approxDate.isValid()) {
@@ -554,49 +570,12 @@ ChartData ChartCalculator::calculateSolarReturn(const QDate &birthDate,
         approxDate = QDate(year, birthDate.month(), birthDate.daysInMonth());
     }
 
-    QDateTime approxDateTime(approxDate, birthTime);
-    double approxJd = dateTimeToJulianDay(approxDateTime, utcOffset);
-
-    // Find exact solar return (when Sun returns to the same longitude)
-    double srJd = findPlanetaryEvent(SE_SUN, approxJd, sunLongitude);
-
-    if (srJd <= 0) {
-        m_lastError = "Could not find solar return";
-        return data;
-    }
-
-    // Calculate chart for the solar return time
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    // Calculate house cusps
-    QVector<HouseData> houses = calculateHouseCusps(srJd, lat, lon, houseSystem);
-    data.houses = houses;
-
-    // Calculate angles
-    data.angles = calculateAngles(srJd, lat, lon, houseSystem);
-
-    // Calculate planet positions
-    data.planets = calculatePlanetPositions(srJd, houses);
-    ////////// Add Syzygy and Pars Fortuna and other methods
-    addSyzygyAndParsFortuna(data.planets, srJd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, srJd, houses);
-    ///////////
-
-    // Calculate aspects
-    double orbMax = getOrbMax();
-
-    data.aspects = calculateAspects(data.planets, orbMax);
-
-
-    // Convert Julian Day to QDateTime (implement julianDayToDateTime if needed)
-    QDateTime returnDateTime = julianDayToDateTime(srJd, utcOffset);
-
-    data.returnDate = returnDateTime.date();
-    data.returnTime = returnDateTime.time();
-    data.returnJulianDay = srJd;
+    QDateTime birthDateTime(birthDate, birthTime);
+    double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
+    double approxJd = dateTimeToJulianDay(QDateTime(approxDate, birthTime), utcOffset);
 
-    return data;
+    return calculateReturnNear(Body::Sun, birthJd, approxJd, utcOffset,
+                               latitude.toDouble(), longitude.toDouble(), options);
 }
 
 ChartData ChartCalculator::calculateSaturnReturn(const QDate &birthDate,
@@ -604,155 +583,143 @@ ChartData ChartCalculator::calculateSaturnReturn(const QDate &birthDate,
                                                  const QString &utcOffset,
                                                  const QString &latitude,
                                                  const QString &longitude,
-                                                 const QString &houseSystem,
+                                                 const CalculationOptions &options,
                                                  int returnNumber) {
-    ChartData data;
+    // Saturn takes about 29.5 years for one orbit
+    QDateTime birthDateTime(birthDate, birthTime);
+    double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
+    double approxJd = birthJd + (returnNumber * 29.5 * 365.25);
 
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
-        return data;
+    return calculateReturnNear(Body::Saturn, birthJd, approxJd, utcOffset,
+                               latitude.toDouble(), longitude.toDouble(), options);
+}
+
+QString ChartCalculator::returnName(Body body)
+{
+    switch (body) {
+    case Body::Sun: return "solar";
+    case Body::Moon: return "lunar";
+    default: return bodyName(body);
     }
+}
 
-    // Convert birth data to Julian day
-    QDateTime birthDateTime(birthDate, birthTime);
-    double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
-    // Get Saturn's position at birth
+bool ChartCalculator::natalLongitude(Body body, double birthJd, double &longitude)
+{
     double xx[6];
     char serr[256];
     int flag = SEFLG_SWIEPH;
-    int ret = swe_calc_ut(birthJd, SE_SATURN, flag, xx, serr);
+    int ret = swe_calc_ut(birthJd, sweBodyId(body), flag, xx, serr);
 
     if (ret < 0) {
-        m_lastError = QString("Error calculating Saturn position: %1").arg(serr);
-        return data;
-    }
-
-    double saturnLongitude = xx[0];
-
-    // Estimate Saturn return time
-    // Saturn takes about 29.5 years for one orbit
-    double approxJd = birthJd + (returnNumber * 29.5 * 365.25);
-
-    // Find exact Saturn return (when Saturn returns to the same longitude)
-    double srJd = findPlanetaryEvent(SE_SATURN, approxJd, saturnLongitude);
-
-    if (srJd <= 0) {
-        m_lastError = "Could not find Saturn return";
-        return data;
+        m_lastError = QString("Error calculating %1 position: %2").arg(bodyName(body)).arg(serr);
+        return false;
     }
 
-    // Calculate chart for the Saturn return time
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    // Calculate house cusps
-    QVector<HouseData> houses = calculateHouseCusps(srJd, lat, lon, houseSystem);
-    data.houses = houses;
+    longitude = xx[0];
+    return true;
+}
 
-    // Calculate angles
-    data.angles = calculateAngles(srJd, lat, lon, houseSystem);
+ChartData ChartCalculator::buildChartAt(double jd, const QString &utcOffset, double lat, double lon,
+                                        const CalculationOptions &options) const
+{
+    ChartData data = calculatePositions(jd, lat, lon, options.houseSystem, true);
 
-    // Calculate planet positions
-    data.planets = calculatePlanetPositions(srJd, houses);
-    ////////// Add Syzygy and Pars Fortuna and other methods
-    addSyzygyAndParsFortuna(data.planets, srJd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, srJd, houses);
-    ///////////
     // Calculate aspects
-    double orbMax = getOrbMax();
-    data.aspects = calculateAspects(data.planets, orbMax);
+    data.aspects = calculateAspects(data.planets, options.orbs);
 
-    // Convert Julian Day to QDateTime (implement julianDayToDateTime if needed)
-    QDateTime returnDateTime = julianDayToDateTime(srJd, utcOffset);
+    QDateTime returnDateTime = julianDayToDateTime(jd, utcOffset);
     data.returnDate = returnDateTime.date();
     data.returnTime = returnDateTime.time();
-    data.returnJulianDay = srJd;
+    data.returnJulianDay = jd;
 
     return data;
 }
 
-double ChartCalculator::findPlanetaryEvent(int planet, double startJd, double targetLongitude) const {
-    // Search window (days)
-    const double searchWindow = 60.0;
-
-    // Search step (days)
-    const double step = 1.0;
-
-    // Tolerance (degrees)
-    const double tolerance = 0.0001;
-
-    double jd = startJd - searchWindow / 2;
-    double endJd = startJd + searchWindow / 2;
-
-    double bestJd = 0;
-    double bestDiff = 360.0;
-
-    // First pass: find approximate time with daily steps
-    while (jd <= endJd) {
-        double xx[6];
-        char serr[256];
-        int flag = SEFLG_SWIEPH;
-        int ret = swe_calc_ut(jd, planet, flag, xx, serr);
-
-        if (ret < 0) {
-            qWarning() << "Error in findPlanetaryEvent:" << serr;
-            return 0;
-        }
-
-        double longitude = xx[0];
-        double diff = fabs(longitude - targetLongitude);
-        if (diff > 180.0) diff = 360.0 - diff;
-
-        if (diff < bestDiff) {
-            bestDiff = diff;
-            bestJd = jd;
-        }
+ChartData ChartCalculator::calculateReturnNear(Body body, double birthJd, double approxJd,
+                                               const QString &utcOffset, double lat, double lon,
+                                               const CalculationOptions &options)
+{
+    if (!m_isInitialized) {
+        m_lastError = "Swiss Ephemeris not initialized";
+        return ChartData();
+    }
+    m_lastError.clear();
+    EphemerisContext::Lease lease;
 
-        jd += step;
+    double targetLongitude = 0.0;
+    if (!natalLongitude(body, birthJd, targetLongitude)) {
+        return ChartData();
     }
 
-    if (bestDiff > 10.0) {
-        // If we're not close, try a wider search
-        return findPlanetaryEvent(planet, startJd - searchWindow, targetLongitude);
+    ReturnEngine engine;
+    double returnJd = engine.findNearestReturn(body, targetLongitude, approxJd);
+    if (returnJd <= 0) {
+        m_lastError = QString("Could not find %1 return").arg(returnName(body));
+        return ChartData();
     }
 
-    // Second pass: refine with binary search
-    double lowerJd = bestJd - step;
-    double upperJd = bestJd + step;
+    return buildChartAt(returnJd, utcOffset, lat, lon, options);
+}
 
-    for (int i = 0; i < 20; i++) {  // 20 iterations should be enough for precision
-        double midJd = (lowerJd + upperJd) / 2;
+QVector<ChartData> ChartCalculator::calculateReturnSeries(Body body,
+                                                          const QDate &birthDate,
+                                                          const QTime &birthTime,
+                                                          const QString &utcOffset,
+                                                          const QString &latitude,
+                                                          const QString &longitude,
+                                                          const CalculationOptions &options,
+                                                          const QDate &fromDate,
+                                                          const QDate &toDate)
+{
+    // Only the returning body's natal longitude is needed, which is cheaper
+    // to calculate than a natal chart; leave the planets empty
+    NatalChart natal;
+    natal.birthJd = dateTimeToJulianDay(QDateTime(birthDate, birthTime), utcOffset);
+    natal.utcOffset = utcOffset;
+    natal.latitude = latitude.toDouble();
+    natal.longitude = longitude.toDouble();
+    return calculateReturnSeries(body, natal, options, fromDate, toDate);
+}
 
-        double xx[6];
-        char serr[256];
-        int flag = SEFLG_SWIEPH;
-        int ret = swe_calc_ut(midJd, planet, flag, xx, serr);
+QVector<ChartData> ChartCalculator::calculateReturnSeries(Body body,
+                                                          const NatalChart &natal,
+                                                          const CalculationOptions &options,
+                                                          const QDate &fromDate,
+                                                          const QDate &toDate)
+{
+    QVector<ChartData> charts;
+    if (!m_isInitialized) {
+        m_lastError = "Swiss Ephemeris not initialized";
+        return charts;
+    }
+    m_lastError.clear();
+    EphemerisContext::Lease lease;
 
-        if (ret < 0) {
-            qWarning() << "Error in findPlanetaryEvent refinement:" << serr;
-            return 0;
-        }
+    const QString &utcOffset = natal.utcOffset;
+    double targetLongitude = 0.0;
+    if (!natal.longitudeOf(body, targetLongitude)
+            && !natalLongitude(body, natal.birthJd, targetLongitude)) {
+        return charts;
+    }
 
-        double longitude = xx[0];
-        double diff = longitude - targetLongitude;
+    double startJd = dateTimeToJulianDay(QDateTime(fromDate, QTime(0, 0)), utcOffset);
+    double endJd = dateTimeToJulianDay(QDateTime(toDate, QTime(23, 59, 59)), utcOffset);
 
-        // Normalize difference to -180 to +180
-        if (diff > 180.0) diff -= 360.0;
-        if (diff < -180.0) diff += 360.0;
+    // One sweep finds every pass, then the charts are filled in parallel
+    ReturnEngine engine;
+    const QVector<ReturnEvent> returns = engine.findReturns(body, targetLongitude, startJd, endJd);
 
-        if (fabs(diff) < tolerance) {
-            return midJd;  // Found with required precision
-        }
+    charts.resize(returns.size());
+    ChartData *out = charts.data();
+    const double lat = natal.latitude;
+    const double lon = natal.longitude;
 
-        if (diff < 0) {
-            lowerJd = midJd;
-        } else {
-            upperJd = midJd;
-        }
-    }
+    EphemerisPool::parallelFor(returns.size(), [&](int i) {
+        EphemerisContext::Lease workerLease;
+        out[i] = buildChartAt(returns.at(i).jd, utcOffset, lat, lon, options);
+    });
 
-    // Return best approximation
-    return (lowerJd + upperJd) / 2;
+    return charts;
 }
 
 QString ChartCalculator::calculateTransits(const QDate &birthDate,
@@ -761,129 +728,661 @@ QString ChartCalculator::calculateTransits(const QDate &birthDate,
                                            const QString &latitude,
                                            const QString &longitude,
                                            const QDate &transitStartDate,
-                                           int numberOfDays) {
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
+                                           int numberOfDays,
+                                           const CalculationOptions &options) {
+    QVector<TransitHit> hits = calculateTransitList(birthDate, birthTime, utcOffset,
+                                                    latitude, longitude,
+                                                    transitStartDate, numberOfDays, options);
+    if (!m_lastError.isEmpty()) {
         return QString();
     }
+    return formatTransitReport(hits, transitStartDate, numberOfDays);
+}
 
-
-    // Use the complete natal planet list from birthChart
-    QDateTime birthDateTime(birthDate, birthTime);
-    double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    QVector<HouseData> natalHouses = calculateHouseCusps(birthJd, lat, lon, houseSystem);
-    QVector<AngleData> natalAngles = calculateAngles(birthJd, lat, lon, houseSystem);
-    QVector<PlanetData> natalPlanets = calculatePlanetPositions(birthJd, natalHouses);
-    if (GlobalFlags::additionalBodiesEnabled) {
-        addSyzygyAndParsFortuna(natalPlanets, birthJd, natalHouses, natalAngles);
-        calculateAdditionalBodies(natalPlanets, birthJd, natalHouses);
+namespace {
+
+// Row buffers of a day-stepped transit scan. Each thread keeps one set
+// between scans and the rows of a chunk are reserved up front, so the day
+// loop mostly writes into capacity that is already there. The aspect hit
+// and chunk buffers still grow whenever a chunk has more hits than any
+// before it on that thread.
+struct TransitScratch {
+    QVector<double> longitudes;
+    QVector<Body> bodies;
+    QVector<bool> retrograde;
+    QVector<int> days;
+    QVector<AspectHit> aspectHits;
+    QVector<TransitHit> chunk;
+    bool inUse = false;
+
+    void clearRows()
+    {
+        longitudes.clear();
+        bodies.clear();
+        retrograde.clear();
+        days.clear();
+    }
+
+    void reserveRows(int rows)
+    {
+        longitudes.reserve(rows);
+        bodies.reserve(rows);
+        retrograde.reserve(rows);
+        days.reserve(rows);
+    }
+};
+
+// The calling thread's scratch, or a private one when a scan is already
+// using it (a scan started from a chunk callback)
+class TransitScratchLease
+{
+public:
+    TransitScratchLease()
+        : m_scratch(threadScratch().inUse ? &m_own : &threadScratch())
+    {
+        m_scratch->inUse = true;
+        m_scratch->clearRows();
+        m_scratch->aspectHits.clear();
+        m_scratch->chunk.clear();
     }
-    //addSyzygyAndParsFortuna(natalPlanets, birthJd, natalHouses, natalAngles);
-    //calculateAdditionalBodies(natalPlanets, birthJd, natalHouses);
+    ~TransitScratchLease() { m_scratch->inUse = false; }
 
-    QDateTime transitStartDateTime(transitStartDate, QTime(0, 0));
-    double transitStartJd = dateTimeToJulianDay(transitStartDateTime, "+0:00");
+    TransitScratch &operator*() const { return *m_scratch; }
 
-    QStringList includedTargetObjects;
-    QStringList excludedTransitingObjects;
+private:
+    Q_DISABLE_COPY(TransitScratchLease)
 
-    if (GlobalFlags::additionalBodiesEnabled) {
-        includedTargetObjects = {"Sun", "Moon", "Mercury", "Venus", "Mars",
-                                 "Jupiter", "Saturn", "Uranus", "Neptune", "Pluto",
-                                 "Lilith", "Ceres", "Pallas", "Juno", "Vesta", "Vertex", "East Point", "Chiron",
-                                 "Pars Fortuna", "North Node", "South Node"};
-        excludedTransitingObjects = {""};
-    } else {
-        includedTargetObjects = {"Sun", "Moon", "Mercury", "Venus", "Mars",
-                                 "Jupiter", "Saturn", "Uranus", "Neptune", "Pluto"};
-        excludedTransitingObjects = {"Chiron", "North Node", "South Node"};
+    static TransitScratch &threadScratch()
+    {
+        thread_local TransitScratch scratch;
+        return scratch;
     }
 
-    struct AspectType {
-        QString code;
-        double angle;
-        double orb;
-    };
+    TransitScratch m_own;
+    TransitScratch *m_scratch;
+};
 
-    double orbMax = getOrbMax();
-    const AspectType aspectTypes[] = {
-        {"CON", 0.0, orbMax},
-        {"OPP", 180.0, orbMax},
-        {"TRI", 120.0, orbMax},
-        {"SQR", 90.0, orbMax},
-        {"SEX", 60.0, orbMax},
-        {"QUI", 150.0, orbMax * 0.75},
-        {"SSQ", 45.0, orbMax * 0.75},
-        {"SQQ", 135.0, orbMax * 0.75},
+// Longitude and speed of an ephemeris body for the day scan. Near a station
+// the fitted speed may have the wrong sign, and rejected segments have no
+// fit; the ephemeris answers then.
+bool scanPosition(const EphemerisCache &cache, Body body, double jd, double &longitude, double &speed)
+{
+    if (cache.longitude(body, jd, longitude, speed) && std::fabs(speed) > cache.speedTolerance()) {
+        return true;
+    }
 
+    // The South Node is opposite the North Node, moving with it
+    const Body sweBody = body == Body::SouthNode ? Body::NorthNode : body;
+    double xx[6];
+    char serr[256];
+    if (swe_calc_ut(jd, sweBodyId(sweBody), SEFLG_SPEED | SEFLG_SWIEPH, xx, serr) < 0) {
+        qWarning() << "Error calculating position for planet" << bodyName(body) << ":" << serr;
+        return false;
+    }
+    longitude = body == Body::SouthNode ? fmod(xx[0] + 180.0, 360.0) : xx[0];
+    speed = xx[3];
+    return true;
+}
 
-        {"SSX", 30.0, orbMax * 0.75}
-    };
-    int numAspectTypes = sizeof(aspectTypes) / sizeof(aspectTypes[0]);
+double normalizeDegrees(double angle)
+{
+    angle = fmod(angle, 360.0);
+    return angle < 0.0 ? angle + 360.0 : angle;
+}
 
-    QString report;
-    report += "---TRANSITS---\n";
+}
 
-    for (int day = 0; day < numberOfDays; day++) {
-        double transitJd = transitStartJd + day;
-        QDateTime transitDateTime = julianDayToDateTime(transitJd);
-        QString dateStr = transitDateTime.toString("yyyy/MM/dd");
-
-        QVector<HouseData> transitHouses = calculateHouseCusps(transitJd, lat, lon, houseSystem);
-        QVector<AngleData> transitAngles = calculateAngles(transitJd, lat, lon, houseSystem);
-        QVector<PlanetData> transitPlanets = calculatePlanetPositions(transitJd, transitHouses);
-        //addSyzygyAndParsFortuna(transitPlanets, transitJd, transitHouses, transitAngles);
-        //calculateAdditionalBodies(transitPlanets, transitJd, transitHouses);
-
-        if (GlobalFlags::additionalBodiesEnabled) {
-            addSyzygyAndParsFortuna(transitPlanets, transitJd, transitHouses, transitAngles);
-            calculateAdditionalBodies(transitPlanets, transitJd, transitHouses);
-        }
+QVector<TransitHit> ChartCalculator::calculateTransitList(const QDate &birthDate,
+                                                          const QTime &birthTime,
+                                                          const QString &utcOffset,
+                                                          const QString &latitude,
+                                                          const QString &longitude,
+                                                          const QDate &transitStartDate,
+                                                          int numberOfDays,
+                                                          const CalculationOptions &options,
+                                                          const ProgressCallback &progress,
+                                                          const TransitChunkCallback &chunkReady) {
+    NatalChartHandle natal = natalChart(birthDate, birthTime, utcOffset, latitude, longitude, options);
+    if (!natal) {
+        return QVector<TransitHit>();
+    }
+    return calculateTransitList(*natal, transitStartDate, numberOfDays, options, progress, chunkReady);
+}
 
+QVector<TransitHit> ChartCalculator::calculateTransitList(const NatalChart &natal,
+                                                          const QDate &transitStartDate,
+                                                          int numberOfDays,
+                                                          const CalculationOptions &requestedOptions,
+                                                          const ProgressCallback &progress,
+                                                          const TransitChunkCallback &chunkReady) {
+    // The body set has to be the one the natal points were made with
+    const CalculationOptions options = natal.searchOptions(requestedOptions);
+    QVector<TransitHit> hits;
+    if (!m_isInitialized) {
+        m_lastError = "Swiss Ephemeris not initialized";
+        return hits;
+    }
+    m_lastError.clear();
+    EphemerisContext::Lease lease;
 
-        QStringList dayAspects;
-        for (const PlanetData &transitPlanet : transitPlanets) {
-            if (excludedTransitingObjects.contains(transitPlanet.id)) {
-                continue;
-            }
-            for (const PlanetData &natalPlanet : natalPlanets) {
-                if (!includedTargetObjects.contains(natalPlanet.id)) {
-                    continue;
-                }
-                double diff = fabs(transitPlanet.longitude - natalPlanet.longitude);
-                if (diff > 180.0) diff = 360.0 - diff;
+    const double lat = natal.latitude;
+    const double lon = natal.longitude;
+    const QVector<PlanetData> &natalPlanets = natal.planets;
 
-                for (int j = 0; j < numAspectTypes; j++) {
-                    double orb = fabs(diff - aspectTypes[j].angle);
-                    if (orb <= aspectTypes[j].orb) {
-                        QString transitPlanetName = transitPlanet.id;
-                        if (transitPlanet.isRetrograde) {
-                            transitPlanetName += " (R)";
-                        }
+    QDateTime transitStartDateTime(transitStartDate, QTime(0, 0));
+    double transitStartJd = dateTimeToJulianDay(transitStartDateTime, "+0:00");
 
-                        QString aspectStr = QString("%1 %2 %3( %4°)")
-                                                .arg(transitPlanetName)
-                                                .arg(aspectTypes[j].code)
-                                                .arg(natalPlanet.id)
+    // Per-body masks instead of name lists, checked for every pair every day
+    bool includedTarget[BodyCount] = {};
+    bool excludedTransiting[BodyCount] = {};
 
-                                                .arg(orb, 0, 'f', 2);
-                        dayAspects.append(aspectStr);
+    const Body mainBodies[] = {Body::Sun, Body::Moon, Body::Mercury, Body::Venus, Body::Mars,
+                               Body::Jupiter, Body::Saturn, Body::Uranus, Body::Neptune, Body::Pluto};
+    for (Body body : mainBodies) {
+        includedTarget[int(body)] = true;
+    }
 
+    if (options.additionalBodies) {
+        const Body extraTargets[] = {Body::Lilith, Body::Ceres, Body::Pallas, Body::Juno, Body::Vesta,
+                                     Body::Vertex, Body::EastPoint, Body::Chiron,
+                                     Body::ParsFortuna, Body::NorthNode, Body::SouthNode};
+        for (Body body : extraTargets) {
+            includedTarget[int(body)] = true;
+        }
+    } else {
+        excludedTransiting[int(Body::Chiron)] = true;
+        excludedTransiting[int(Body::NorthNode)] = true;
+        excludedTransiting[int(Body::SouthNode)] = true;
+    }
+
+    // Resolve the natal targets once
+    QVector<double> natalLongitudes;
+    QVector<Body> natalBodies;
+    for (const PlanetData &natalPlanet : natalPlanets) {
+        Body body;
+        if (bodyFromName(natalPlanet.id, &body) && includedTarget[int(body)]) {
+            natalLongitudes.append(natalPlanet.longitude);
+            natalBodies.append(body);
+        }
+    }
 
-                        break;
-                    }
+    AspectMatrix matrix(options.orbs, natalLongitudes.constData(),
+                        natalBodies.constData(), natalLongitudes.size());
+
+    // The scan only needs where each transiting body is and which way it
+    // moves, which comes from the ephemeris. Points taken from the day's
+    // houses or lunation (Syzygy, Lots, Vertex, East Point) cost a house
+    // calculation and a lunation search per day, so they only transit when
+    // asked for. Either way the bodies are in a chart's planet list order,
+    // so hits keep their order.
+    const bool chartPoints = options.additionalBodies && options.transitChartPoints;
+    QVector<Body> order = {Body::Sun, Body::Moon, Body::Mercury, Body::Venus, Body::Mars,
+                           Body::Jupiter, Body::Saturn, Body::Uranus, Body::Neptune, Body::Pluto,
+                           Body::NorthNode, Body::Chiron, Body::SouthNode};
+    if (chartPoints) {
+        order << Body::Syzygy << Body::ParsFortuna << Body::Ceres << Body::Pallas << Body::Juno
+              << Body::Vesta << Body::Vertex << Body::Lilith << Body::PartOfSpirit << Body::EastPoint;
+    } else if (options.additionalBodies) {
+        order << Body::Ceres << Body::Pallas << Body::Juno << Body::Vesta << Body::Lilith;
+    }
+    QVector<Body> sampledBodies;
+    for (Body body : order) {
+        if (!excludedTransiting[int(body)]) {
+            sampledBodies.append(body);
+        }
+    }
+    const char houseSystem = houseSystemCode(options.houseSystem);
+
+    // Room for every hit up front. Relative longitudes are close to uniform
+    // over a long scan, so a pair is in orb of an aspect on about 2 x orb /
+    // 360 of the days, on each side of the aspect.
+    if (!chunkReady) {
+        double rowsPerDay = 0.0;
+        for (Body transitBody : sampledBodies) {
+            for (Body natalBody : natalBodies) {
+                for (int a = 0; a < AspectKindCount; ++a) {
+                    const double angle = aspectAngle(AspectKind(a));
+                    const int sides = angle > 0.0 && angle < 180.0 ? 2 : 1;
+                    rowsPerDay += sides * 2.0 * options.orbs.orbFor(AspectKind(a), transitBody, natalBody) / 360.0;
                 }
             }
         }
-        report += dateStr + ": " + dayAspects.join(", ") + "\n";
-    }
-    return report;
-}
+        // Headroom for uneven periods, within what a QVector can hold
+        hits.reserve(int(std::min(1.2 * rowsPerDay * numberOfDays + 64.0, 1e8)));
+    }
+
+    // Transiting positions are gathered into flat rows a block of days at a
+    // time, so the aspect test runs over whole days x bodies blocks and each
+    // block can be handed over as soon as it is done. The buffers are reused
+    // and hits go into the space reserved above, so once the buffers have
+    // grown to the largest chunk and the period is in the ephemeris cache, a
+    // day allocates nothing (tests/transitscanalloctest.cpp checks this).
+    const int kChunkDays = 7;
+    TransitScratchLease scratchLease;
+    TransitScratch &scratch = *scratchLease;
+    scratch.reserveRows(kChunkDays * sampledBodies.size());
+    QVector<double> &transitLongitudes = scratch.longitudes;
+    QVector<Body> &transitBodies = scratch.bodies;
+    QVector<bool> &transitRetrograde = scratch.retrograde;
+    QVector<int> &transitDay = scratch.days;
+    QVector<AspectHit> &aspectHits = scratch.aspectHits;
+    QVector<TransitHit> &chunk = scratch.chunk;
+
+    // Transiting positions come from the shared polynomial cache, fitted a
+    // chunk ahead. The first scan of a period pays for the fits; any later
+    // scan or event search over it evaluates polynomials only.
+    EphemerisCache &cache = EphemerisCache::shared();
 
-QDateTime ChartCalculator::julianDayToDateTime(double jd, const QString &utcOffset) const {
+    for (int day = 0; day < numberOfDays; day++) {
+        if (progress && !progress(day, numberOfDays)) {
+            m_lastError = "Calculation cancelled";
+            return hits;
+        }
+        double transitJd = transitStartJd + day;
+
+        if (day % kChunkDays == 0) {
+            const double chunkEndJd = transitStartJd + std::min(day + kChunkDays, numberOfDays) - 1;
+            for (Body body : sampledBodies) {
+                cache.prepare(body, transitJd, chunkEndJd);
+            }
+            if (chartPoints) {
+                // The Syzygy searches back for the last lunation, at most 18
+                // days (half a turn at 10 deg/day)
+                cache.prepare(Body::Sun, transitJd - 18.0, chunkEndJd);
+                cache.prepare(Body::Moon, transitJd - 18.0, chunkEndJd);
+            }
+        }
+
+        // The day's angles, for the chart points; cusps are not needed.
+        // Without them the Lots fall back to a 0 Ascendant, as in a chart.
+        double ascmc[10] = {0};
+        bool housesValid = false;
+        if (chartPoints) {
+            double cusps[13];
+            housesValid = swe_houses_ex(transitJd, 0, lat, lon, houseSystem, cusps, ascmc) >= 0;
+        }
+        const double ascendant = housesValid ? ascmc[SE_ASC] : 0.0;
+
+        double sunLongitude = 0.0;
+        double moonLongitude = 0.0;
+        for (Body body : sampledBodies) {
+            double longitude = 0.0;
+            double speed = 0.0;
+            switch (body) {
+            case Body::Syzygy: {
+                // The Sun at the last New or Full Moon, as in a chart
+                double syzygyJd = transitJd;
+                Lunation lunation;
+                if (findPreviousLunation(transitJd, &lunation)) {
+                    syzygyJd = lunation.jd;
+                }
+                if (!scanPosition(cache, Body::Sun, syzygyJd, longitude, speed)) {
+                    continue;
+                }
+                speed = 0.0;
+                break;
+            }
+            case Body::ParsFortuna:
+                longitude = normalizeDegrees(ascendant + moonLongitude - sunLongitude);
+                break;
+            case Body::PartOfSpirit:
+                longitude = normalizeDegrees(ascendant + sunLongitude - moonLongitude);
+                break;
+            case Body::Vertex:
+                if (!housesValid) {
+                    continue;
+                }
+                longitude = ascmc[SE_VERTEX];
+                break;
+            case Body::EastPoint:
+                if (!housesValid) {
+                    continue;
+                }
+                longitude = ascmc[SE_EQUASC];
+                break;
+            default:
+                if (!scanPosition(cache, body, transitJd, longitude, speed)) {
+                    continue;
+                }
+                break;
+            }
+
+            if (body == Body::Sun) {
+                sunLongitude = longitude;
+            } else if (body == Body::Moon) {
+                moonLongitude = longitude;
+            }
+            transitLongitudes.append(longitude);
+            transitBodies.append(body);
+            transitRetrograde.append(speed < 0);
+            transitDay.append(day);
+        }
+
+        if ((day + 1) % kChunkDays != 0 && day + 1 < numberOfDays) {
+            continue;
+        }
+
+        aspectHits.clear();
+        matrix.evaluate(transitLongitudes.constData(), transitBodies.constData(),
+                        transitLongitudes.size(), aspectHits);
+
+        // Rows were added day by day, so the hits come out in date order
+        chunk.clear();
+        for (const AspectHit &aspectHit : aspectHits) {
+            TransitHit hit;
+            hit.date = transitStartDate.addDays(transitDay[aspectHit.first]);
+            hit.transitBody = transitBodies[aspectHit.first];
+            hit.natalBody = natalBodies[aspectHit.second];
+            hit.aspect = aspectHit.aspect;
+            hit.orb = aspectHit.orb;
+            hit.retrograde = transitRetrograde[aspectHit.first];
+            chunk.append(hit);
+        }
+
+        if (chunkReady) {
+            chunkReady(chunk);
+        } else {
+            hits += chunk;
+        }
+
+        scratch.clearRows();
+    }
+    return hits;
+}
+
+QString ChartCalculator::formatTransitReport(const QVector<TransitHit> &hits,
+                                             const QDate &transitStartDate,
+                                             int numberOfDays)
+{
+    // Labels are made once; the lines are then written straight into one
+    // buffer sized for the whole report
+    QString bodyLabels[BodyCount];
+    for (int i = 0; i < BodyCount; ++i) {
+        bodyLabels[i] = bodyName(Body(i));
+    }
+    QString aspectLabels[AspectKindCount];
+    for (int i = 0; i < AspectKindCount; ++i) {
+        aspectLabels[i] = aspectCode(AspectKind(i));
+    }
+
+    QString report;
+    report.reserve(16 + numberOfDays * 14 + hits.size() * 40);
+    report += QLatin1String("---TRANSITS---\n");
+
+    // Hits come in date order; every day gets a line, even without aspects
+    char number[32];
+    int index = 0;
+    for (int day = 0; day < numberOfDays; day++) {
+        QDate date = transitStartDate.addDays(day);
+        int length = std::snprintf(number, sizeof(number), "%04d/%02d/%02d: ",
+                                   date.year(), date.month(), date.day());
+        report += QLatin1String(number, length);
+
+        bool first = true;
+        for (; index < hits.size() && hits.at(index).date == date; ++index) {
+            const TransitHit &hit = hits.at(index);
+            if (!first) {
+                report += QLatin1String(", ");
+            }
+            first = false;
+
+            report += bodyLabels[int(hit.transitBody)];
+            if (hit.retrograde) {
+                report += QLatin1String(" (R)");
+            }
+            report += QLatin1Char(' ');
+            report += aspectLabels[int(hit.aspect)];
+            report += QLatin1Char(' ');
+            report += bodyLabels[int(hit.natalBody)];
+            // Integer formatting: %.2f follows LC_NUMERIC, which QApplication
+            // takes from the environment (a decimal comma in de_DE)
+            const qint64 hundredths = qRound64(std::fabs(hit.orb) * 100.0);
+            length = std::snprintf(number, sizeof(number), "( %s%lld.%02lld", hit.orb < 0 ? "-" : "",
+                                   hundredths / 100, hundredths % 100);
+            report += QLatin1String(number, length);
+            report += QStringLiteral("°)");
+        }
+        report += QLatin1Char('\n');
+    }
+    return report;
+}
+
+QString ChartCalculator::formatTransitEventReport(const QVector<TransitEvent> &events)
+{
+    // UT minute of a Julian day as "yyyy/MM/dd HH:mm"
+    char number[32];
+    auto appendTime = [&number](QString &out, double jd) {
+        int year, month, day;
+        double hours;
+        // Round to the minute first, so 23:59:30 becomes the next day. The
+        // nudge keeps a whole minute from coming back as 59.999 seconds.
+        swe_revjul(std::floor(jd * 1440.0 + 0.5) / 1440.0 + 1e-7, SE_GREG_CAL, &year, &month, &day, &hours);
+        const int minutes = int(hours * 60.0);
+        const int length = std::snprintf(number, sizeof(number), "%04d/%02d/%02d %02d:%02d",
+                                         year, month, day, minutes / 60, minutes % 60);
+        out += QLatin1String(number, length);
+    };
+
+    QString report;
+    report.reserve(24 + events.size() * 110);
+    report += QLatin1String("---TRANSIT WINDOWS (UT)---\n");
+    for (const TransitEvent &event : events) {
+        appendTime(report, event.startJd);
+        if (event.startsBeforeRange) {
+            report += QLatin1String(" (already in orb)");
+        }
+        report += QLatin1String(" - ");
+        appendTime(report, event.endJd);
+        if (event.endsAfterRange) {
+            report += QLatin1String(" (still in orb)");
+        }
+        report += QLatin1String(": ");
+        report += bodyName(event.transitBody);
+        report += QLatin1Char(' ');
+        report += aspectCode(event.aspect);
+        report += QLatin1Char(' ');
+        report += bodyName(event.natalBody);
+
+        if (event.exactJds.isEmpty()) {
+            // Same integer formatting as formatTransitReport
+            const qint64 hundredths = qRound64(event.minOrb * 100.0);
+            const int length = std::snprintf(number, sizeof(number), ", closest %lld.%02lld",
+                                             hundredths / 100, hundredths % 100);
+            report += QLatin1String(number, length);
+            report += QStringLiteral("°");
+        } else {
+            report += QLatin1String(", exact ");
+            for (int i = 0; i < event.exactJds.size(); ++i) {
+                if (i > 0) {
+                    report += QLatin1String(", ");
+                }
+                appendTime(report, event.exactJds.at(i));
+                if (event.exactRetrograde.at(i)) {
+                    report += QLatin1String(" (R)");
+                }
+            }
+        }
+        report += QLatin1Char('\n');
+    }
+    return report;
+}
+
+QVector<PlanetData> ChartCalculator::calculateTransitNatalPlanets(double birthJd, double lat, double lon,
+                                                                  const CalculationOptions &options) const
+{
+    return calculatePositions(birthJd, lat, lon, options.houseSystem, options.additionalBodies).planets;
+}
+
+bool NatalChart::longitudeOf(Body body, double &longitude) const
+{
+    const QString id = bodyName(body);
+    for (const PlanetData &planet : planets) {
+        if (planet.id == id) {
+            longitude = planet.longitude;
+            return true;
+        }
+    }
+    return false;
+}
+
+namespace {
+
+// Recently used natal charts, shared by every calculator in the process
+struct NatalChartCache {
+    static constexpr int Capacity = 8;
+    QMutex mutex;
+    QVector<NatalChartHandle> charts;   // Most recently used first
+};
+
+NatalChartCache &natalChartCache()
+{
+    static NatalChartCache cache;
+    return cache;
+}
+
+bool sameBirthData(const NatalChart &chart, double birthJd, const QString &utcOffset,
+                   double lat, double lon, const CalculationOptions &options)
+{
+    return chart.birthJd == birthJd && chart.utcOffset == utcOffset
+            && chart.latitude == lat && chart.longitude == lon
+            && chart.options.houseSystem == options.houseSystem
+            && chart.options.additionalBodies == options.additionalBodies;
+}
+
+}
+
+CalculationOptions NatalChart::searchOptions(const CalculationOptions &options) const
+{
+    CalculationOptions result = options;
+    result.houseSystem = this->options.houseSystem;
+    result.additionalBodies = this->options.additionalBodies;
+    return result;
+}
+
+NatalChartHandle ChartCalculator::natalChart(const QDate &birthDate,
+                                             const QTime &birthTime,
+                                             const QString &utcOffset,
+                                             const QString &latitude,
+                                             const QString &longitude,
+                                             const CalculationOptions &options)
+{
+    m_lastError.clear();
+    if (!m_isInitialized) {
+        m_lastError = "Swiss Ephemeris not initialized";
+        return nullptr;
+    }
+
+    const double birthJd = dateTimeToJulianDay(QDateTime(birthDate, birthTime), utcOffset);
+    const double lat = latitude.toDouble();
+    const double lon = longitude.toDouble();
+
+    NatalChartCache &cache = natalChartCache();
+    {
+        QMutexLocker locker(&cache.mutex);
+        for (int i = 0; i < cache.charts.size(); ++i) {
+            if (sameBirthData(*cache.charts.at(i), birthJd, utcOffset, lat, lon, options)) {
+                NatalChartHandle chart = cache.charts.takeAt(i);
+                cache.charts.prepend(chart);
+                return chart;
+            }
+        }
+    }
+
+    auto chart = std::make_shared<NatalChart>();
+    chart->birthJd = birthJd;
+    chart->utcOffset = utcOffset;
+    chart->latitude = lat;
+    chart->longitude = lon;
+    chart->options = options;
+    {
+        EphemerisContext::Lease lease;
+        chart->planets = calculateTransitNatalPlanets(birthJd, lat, lon, options);
+    }
+    if (chart->planets.isEmpty()) {
+        m_lastError = "Could not calculate the natal chart";
+        return nullptr;
+    }
+
+    QMutexLocker locker(&cache.mutex);
+    cache.charts.prepend(chart);
+    if (cache.charts.size() > NatalChartCache::Capacity) {
+        cache.charts.removeLast();
+    }
+    return chart;
+}
+
+QVector<TransitEvent> ChartCalculator::calculateTransitEvents(const QDate &birthDate,
+                                                              const QTime &birthTime,
+                                                              const QString &utcOffset,
+                                                              const QString &latitude,
+                                                              const QString &longitude,
+                                                              const QDate &transitStartDate,
+                                                              int numberOfDays,
+                                                              const CalculationOptions &options,
+                                                              const ProgressCallback &progress) {
+    NatalChartHandle natal = natalChart(birthDate, birthTime, utcOffset, latitude, longitude, options);
+    if (!natal) {
+        return QVector<TransitEvent>();
+    }
+    return calculateTransitEvents(*natal, transitStartDate, numberOfDays, options, progress);
+}
+
+QVector<TransitEvent> ChartCalculator::calculateTransitEvents(const NatalChart &natal,
+                                                              const QDate &transitStartDate,
+                                                              int numberOfDays,
+                                                              const CalculationOptions &requestedOptions,
+                                                              const ProgressCallback &progress) {
+    // The body set has to be the one the natal points were made with
+    const CalculationOptions options = natal.searchOptions(requestedOptions);
+    if (!m_isInitialized) {
+        m_lastError = "Swiss Ephemeris not initialized";
+        return QVector<TransitEvent>();
+    }
+    EphemerisContext::Lease lease;
+
+    const QVector<PlanetData> &natalPlanets = natal.planets;
+
+    // Same target and transiting sets as the daily report. Derived points
+    // (Syzygy, Lots, Vertex, East Point) only ever act as natal targets.
+    QVector<Body> targetBodies = {Body::Sun, Body::Moon, Body::Mercury, Body::Venus, Body::Mars,
+                                  Body::Jupiter, Body::Saturn, Body::Uranus, Body::Neptune, Body::Pluto};
+    QVector<Body> transitingBodies = targetBodies;
+    if (options.additionalBodies) {
+        targetBodies << Body::Lilith << Body::Ceres << Body::Pallas << Body::Juno << Body::Vesta
+                     << Body::Vertex << Body::EastPoint << Body::Chiron << Body::ParsFortuna
+                     << Body::NorthNode << Body::SouthNode;
+        transitingBodies << Body::NorthNode << Body::SouthNode << Body::Chiron
+                         << Body::Ceres << Body::Pallas << Body::Juno << Body::Vesta << Body::Lilith;
+    }
+
+    QVector<NatalPoint> natalPoints;
+    for (const PlanetData &planet : natalPlanets) {
+        Body body;
+        if (bodyFromName(planet.id, &body) && targetBodies.contains(body)) {
+            natalPoints.append({body, planet.longitude});
+        }
+    }
+
+    QDateTime transitStartDateTime(transitStartDate, QTime(0, 0));
+    double transitStartJd = dateTimeToJulianDay(transitStartDateTime, "+0:00");
+
+    bool cancelled = false;
+    auto step = [&](int done, int total) {
+        cancelled = progress && !progress(done, total);
+        return !cancelled;
+    };
+
+    TransitEngine engine(options.orbs);
+    QVector<TransitEvent> events = engine.findEvents(transitingBodies, natalPoints,
+                                                     transitStartJd, transitStartJd + numberOfDays,
+                                                     step);
+    if (cancelled) {
+        m_lastError = "Calculation cancelled";
+    }
+    return events;
+}
+
+QDateTime ChartCalculator::julianDayToDateTime(double jd, const QString &utcOffset) const {
     int year, month, day, hour, minute, second;
     double hour_fraction;
 
@@ -922,21 +1421,42 @@ QDateTime ChartCalculator::julianDayToDateTime(double jd, const QString &utcOffs
 QVector<EclipseData> ChartCalculator::findEclipses(const QDate &startDate,
                                                    const QDate &endDate,
                                                    bool solarEclipses,
-                                                   bool lunarEclipses) {
+                                                   bool lunarEclipses,
+                                                   const ProgressCallback &progress) {
     QVector<EclipseData> eclipses;
     if (!m_isInitialized) {
         m_lastError = "Swiss Ephemeris not initialized";
         return eclipses;
     }
+    EphemerisContext::Lease lease;
 
     double startJd = dateTimeToJulianDay(QDateTime(startDate, QTime(0, 0)), "+0:00");
     double endJd = dateTimeToJulianDay(QDateTime(endDate, QTime(23, 59, 59)), "+0:00");
     char serr[256] = {0};
 
+    // Progress counts the days searched, over one pass per eclipse kind
+    const int span = qMax(1, int(endJd - startJd));
+    const int total = (solarEclipses ? span : 0) + (lunarEclipses ? span : 0);
+    int passOffset = 0;
+    auto reportProgress = [&](double tjd) {
+        if (!progress) {
+            return true;
+        }
+        int done = passOffset + qBound(0, int(tjd - startJd), span);
+        if (!progress(done, total)) {
+            m_lastError = "Calculation cancelled";
+            return false;
+        }
+        return true;
+    };
+
     // SOLAR ECLIPSES - CORRECTED
     if (solarEclipses) {
         double tjd = startJd;
         while (tjd < endJd) {
+            if (!reportProgress(tjd)) {
+                return QVector<EclipseData>();
+            }
             double tret[10] = {0};
             int32 iflgret = swe_sol_eclipse_when_glob(tjd, SEFLG_SWIEPH, 0, tret, 0, serr);
 
@@ -978,8 +1498,12 @@ QVector<EclipseData> ChartCalculator::findEclipses(const QDate &startDate,
 
     // LUNAR ECLIPSES - COMPLETELY REWRITTEN
     if (lunarEclipses) {
+        passOffset = solarEclipses ? span : 0;
         double tjd = startJd;
         while (tjd < endJd) {
+            if (!reportProgress(tjd)) {
+                return QVector<EclipseData>();
+            }
             double tret[10] = {0};
             // USE PROPER LUNAR ECLIPSE FUNCTION
             int32 iflgret = swe_lun_eclipse_when(tjd, SEFLG_SWIEPH, 0, tret, 0, serr);
@@ -1031,354 +1555,23 @@ QVector<EclipseData> ChartCalculator::findEclipses(const QDate &startDate,
     return eclipses;
 }
 
-void ChartCalculator::addSyzygyAndParsFortuna(QVector<PlanetData> &planets, double jd,
-                                              const QVector<HouseData> &houses,
-                                              const QVector<AngleData> &angles) const {
-    // Calculate Syzygy (Pre-Natal Lunation - New or Full Moon)
-    PlanetData syzygy;
-    syzygy.id = "Syzygy";
-
-    // Find the exact time of the last New Moon or Full Moon before birth
-    double tjd_start = jd - 30; // Start searching 30 days before birth
-    char serr[256] = {0};
-    int flags = SEFLG_SWIEPH;
-
-    // Function to find exact lunation time using binary search
-    auto findExactLunation = [&](double start_jd, double end_jd, bool isNewMoon) -> double {
-        double precision = 0.0001; // Precision in days (about 8.6 seconds)
-        double mid_jd;
-
-        while (end_jd - start_jd > precision) {
-            mid_jd = (start_jd + end_jd) / 2;
-
-            double sun_pos[6], moon_pos[6];
-            if (swe_calc_ut(mid_jd, SE_SUN, flags, sun_pos, serr) < 0 ||
-                swe_calc_ut(mid_jd, SE_MOON, flags, moon_pos, serr) < 0) {
-                return 0; // Error
-            }
-
-            // Calculate angular distance between Sun and Moon
-            double angle = moon_pos[0] - sun_pos[0];
-            while (angle < 0) angle += 360;
-            while (angle >= 360) angle -= 360;
-
-            if (isNewMoon) {
-                // For New Moon, we want conjunction (0°)
-                if (angle > 180) angle = 360 - angle;
-
-                if (angle < 180) {
-                    end_jd = mid_jd;
-                } else {
-                    start_jd = mid_jd;
-                }
-            } else {
-                // For Full Moon, we want opposition (180°)
-                double diff = fabs(angle - 180);
-
-                if (diff < 90) {
-                    end_jd = mid_jd;
-                } else {
-                    start_jd = mid_jd;
-                }
-            }
-        }
-
-        return (start_jd + end_jd) / 2;
-    };
-
-    // Find approximate times first using a coarser search
-    double last_new_moon = 0;
-    double last_full_moon = 0;
-
-    // Search for new and full moons
-    double curr_jd = jd;
-    double prev_angle = -1;
-
-    while (curr_jd > tjd_start) {
-        double sun_pos[6], moon_pos[6];
-        if (swe_calc_ut(curr_jd, SE_SUN, flags, sun_pos, serr) < 0 ||
-            swe_calc_ut(curr_jd, SE_MOON, flags, moon_pos, serr) < 0) {
-            break;
-        }
-
-        // Calculate angular distance between Sun and Moon
-        double angle = moon_pos[0] - sun_pos[0];
-        while (angle < 0) angle += 360;
-        while (angle >= 360) angle -= 360;
-
-        // Check for New Moon (conjunction)
-        if (prev_angle >= 0) {
-            // Detect crossing 0° (conjunction)
-            if ((prev_angle > 330 && angle < 30) || (prev_angle < 30 && angle > 330)) {
-                // Found approximate new moon, now find exact time
-                double exact_jd = findExactLunation(curr_jd - 1, curr_jd, true);
-                if (exact_jd > 0 && exact_jd < jd && (last_new_moon == 0 || exact_jd > last_new_moon)) {
-                    last_new_moon = exact_jd;
-                }
-            }
-
-            // Detect crossing 180° (opposition)
-            if ((prev_angle < 170 && angle > 190) || (prev_angle > 190 && angle < 170)) {
-                // Found approximate full moon, now find exact time
-                double exact_jd = findExactLunation(curr_jd - 1, curr_jd, false);
-                if (exact_jd > 0 && exact_jd < jd && (last_full_moon == 0 || exact_jd > last_full_moon)) {
-                    last_full_moon = exact_jd;
-                }
-            }
-        }
-
-        prev_angle = angle;
-        curr_jd -= 1.0; // Step back one day
-    }
-
-    // Determine which was more recent
-    double syzygy_jd = 0;
-    bool is_new_moon = false;
-
-    if (last_new_moon > last_full_moon) {
-        syzygy_jd = last_new_moon;
-        is_new_moon = true;
-    } else if (last_full_moon > 0) {
-        syzygy_jd = last_full_moon;
-        is_new_moon = false;
-    }
-
-    // If we found a valid syzygy
-    if (syzygy_jd > 0) {
-        // Calculate Sun and Moon positions at the syzygy
-        double xx_sun[6], xx_moon[6];
-        if (swe_calc_ut(syzygy_jd, SE_SUN, flags, xx_sun, serr) >= 0 &&
-            swe_calc_ut(syzygy_jd, SE_MOON, flags, xx_moon, serr) >= 0) {
-
-            if (is_new_moon) {
-                // For New Moon, use the Sun's position (same as Moon)
-                syzygy.longitude = xx_sun[0];
-            } else {
-                // For Full Moon, use the Sun's position (NOT Sun + 180)
-                // This follows traditional Syzygy calculation for Full Moon
-                syzygy.longitude = xx_sun[0];
-            }
-
-            syzygy.sign = getZodiacSign(syzygy.longitude);
-            syzygy.house = findHouse(syzygy.longitude, houses);
-            syzygy.isRetrograde = false;
-            planets.append(syzygy);
-
-            // Debug output
-        }
-    } else {
-        // Fallback if we couldn't find a syzygy
-        //qWarning() << "Could not find a valid Syzygy, using fallback";
-        double xx[6];
-        if (swe_calc_ut(jd, SE_SUN, flags, xx, serr) >= 0) {
-            syzygy.longitude = xx[0];
-            syzygy.sign = getZodiacSign(syzygy.longitude);
-            syzygy.house = findHouse(syzygy.longitude, houses);
-            syzygy.isRetrograde = false;
-            planets.append(syzygy);
-        }
-    }
-
-    // Calculate Pars Fortuna (unchanged)
-    double asc = 0.0;
-    for (const AngleData &angle : angles) {
-        if (angle.id == "Asc") {
-            asc = angle.longitude;
-            break;
-        }
-    }
-    double sun_lon = 0.0;
-    double moon_lon = 0.0;
-    for (const PlanetData &planet : planets) {
-        if (planet.id == "Sun") {
-            sun_lon = planet.longitude;
-        } else if (planet.id == "Moon") {
-            moon_lon = planet.longitude;
-        }
-    }
-    PlanetData parsFortuna;
-    parsFortuna.id = "Pars Fortuna";
-    parsFortuna.longitude = fmod(asc + moon_lon - sun_lon, 360.0);
-    if (parsFortuna.longitude < 0) parsFortuna.longitude += 360.0;
-    parsFortuna.sign = getZodiacSign(parsFortuna.longitude);
-    parsFortuna.house = findHouse(parsFortuna.longitude, houses);
-    parsFortuna.isRetrograde = false;
-    planets.append(parsFortuna);
-}
-
-
-void ChartCalculator::calculateAdditionalBodies(QVector<PlanetData> &planets, double jd,
-                                                const QVector<HouseData> &houses) const {
-    int flags = SEFLG_SWIEPH | SEFLG_SPEED;
-    char serr[256] = {0};
-
-    // 1. Add Ceres, Pallas, Juno, Vesta (major asteroids)
-    int asteroidIds[] = {SE_CERES, SE_PALLAS, SE_JUNO, SE_VESTA};
-    QString asteroidNames[] = {"Ceres", "Pallas", "Juno", "Vesta"};
-
-    for (int i = 0; i < 4; i++) {
-        double xx[6];
-        if (swe_calc_ut(jd, asteroidIds[i], flags, xx, serr) >= 0) {
-            PlanetData asteroid;
-            asteroid.id = asteroidNames[i];
-            asteroid.longitude = xx[0];
-            asteroid.latitude = xx[1];
-            asteroid.sign = getZodiacSign(asteroid.longitude);
-            asteroid.isRetrograde = (xx[3] < 0);
-            asteroid.house = findHouse(asteroid.longitude, houses);
-            planets.append(asteroid);
-        }
-    }
-
-    // 2. Add Vertex (sensitive point)
-    for (const HouseData &house : houses) {
-        if (house.id == "Vertex") {
-            PlanetData vertex;
-            vertex.id = "Vertex";
-            vertex.longitude = house.longitude;
-            vertex.sign = getZodiacSign(vertex.longitude);
-            vertex.house = findHouse(vertex.longitude, houses);
-            vertex.isRetrograde = false;
-            planets.append(vertex);
-            break;
-        }
-    }
-
-    // 3. Add Lilith (Mean Black Moon)
-    double xx[6];
-    if (swe_calc_ut(jd, SE_MEAN_APOG, flags, xx, serr) >= 0) {
-        PlanetData lilith;
-        lilith.id = "Lilith";
-        lilith.longitude = xx[0];
-        lilith.latitude = xx[1];
-        lilith.sign = getZodiacSign(lilith.longitude);
-        lilith.isRetrograde = (xx[3] < 0);
-        lilith.house = findHouse(lilith.longitude, houses);
-        planets.append(lilith);
-    }
-
-
-
-    // 5. Add Part of Spirit (reverse of Pars Fortuna)
-    double asc = 0.0, sun_lon = 0.0, moon_lon = 0.0;
-
-    for (const PlanetData &planet : planets) {
-        if (planet.id == "Sun") {
-            sun_lon = planet.longitude;
-        } else if (planet.id == "Moon") {
-            moon_lon = planet.longitude;
-        }
-    }
-
-    // Find Ascendant from houses
-    for (const HouseData &house : houses) {
-        if (house.id == "1") {
-            asc = house.longitude;
-            break;
-        }
-    }
-
-    PlanetData partOfSpirit;
-    partOfSpirit.id = "Part of Spirit";
-    partOfSpirit.longitude = fmod(asc + sun_lon - moon_lon, 360.0);
-    if (partOfSpirit.longitude < 0) partOfSpirit.longitude += 360.0;
-    partOfSpirit.sign = getZodiacSign(partOfSpirit.longitude);
-    partOfSpirit.house = findHouse(partOfSpirit.longitude, houses);
-    partOfSpirit.isRetrograde = false;
-    planets.append(partOfSpirit);
-
-
-
-    // 8. Add East Point
-    // This requires calculating the East Point using the formula:
-    // ARMC with latitude 0
-    double cusps[13], ascmc[10];
-    if (swe_houses_ex(jd, 0, 0.0, 0.0, int(houseSystem[0].toLatin1()), cusps, ascmc) == 0) {
-        PlanetData eastPoint;
-        eastPoint.id = "East Point";
-        eastPoint.longitude = ascmc[2]; // ARMC with latitude 0
-        eastPoint.sign = getZodiacSign(eastPoint.longitude);
-        eastPoint.house = findHouse(eastPoint.longitude, houses);
-        eastPoint.isRetrograde = false;
-        planets.append(eastPoint);
-    }
-}
-
-
 ChartData ChartCalculator::calculateLunarReturn(
     const QDate &birthDate,
     const QTime &birthTime,
     const QString &utcOffset,
     const QString &latitude,
     const QString &longitude,
-    const QString &houseSystem,
+    const CalculationOptions &options,
     const QDate &targetDate // The date for which to find the lunar return
     )
 {
-    ChartData data;
-
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
-        return data;
-    }
-
-    // Convert birth data to Julian day
+    // Estimate lunar return time (around targetDate, birth time as a starting guess)
     QDateTime birthDateTime(birthDate, birthTime);
     double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
+    double approxJd = dateTimeToJulianDay(QDateTime(targetDate, birthTime), utcOffset);
 
-    // Get Moon's position at birth
-    double xx[6];
-    char serr[256];
-    int flag = SEFLG_SWIEPH;
-    int ret = swe_calc_ut(birthJd, SE_MOON, flag, xx, serr);
-    if (ret < 0) {
-        m_lastError = QString("Error calculating Moon position: %1").arg(serr);
-        return data;
-    }
-    double moonLongitude = xx[0];
-
-    // Estimate lunar return time (around targetDate)
-    QDate approxDate = targetDate;
-    QTime approxTime = birthTime; // Use birth time as a starting guess
-    QDateTime approxDateTime(approxDate, approxTime);
-    double approxJd = dateTimeToJulianDay(approxDateTime, utcOffset);
-
-    // Find exact lunar return (when Moon returns to the same longitude)
-    double lrJd = findPlanetaryEvent(SE_MOON, approxJd, moonLongitude);
-    if (lrJd <= 0) {
-        m_lastError = "Could not find lunar return";
-        return data;
-    }
-
-    // Calculate chart for the lunar return time
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    // Calculate house cusps
-    QVector<HouseData> houses = calculateHouseCusps(lrJd, lat, lon, houseSystem);
-    data.houses = houses;
-
-    // Calculate angles
-    data.angles = calculateAngles(lrJd, lat, lon, houseSystem);
-
-    // Calculate planet positions
-    data.planets = calculatePlanetPositions(lrJd, houses);
-
-    // Add Syzygy, Pars Fortuna, and other methods
-    addSyzygyAndParsFortuna(data.planets, lrJd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, lrJd, houses);
-
-    // Calculate aspects
-    double orbMax = getOrbMax();
-    data.aspects = calculateAspects(data.planets, orbMax);
-
-    // Convert Julian Day to QDateTime (implement julianDayToDateTime if needed)
-    QDateTime returnDateTime = julianDayToDateTime(lrJd, utcOffset);
-    data.returnDate = returnDateTime.date();
-    data.returnTime = returnDateTime.time();
-    data.returnJulianDay = lrJd;
-
-    return data;
+    return calculateReturnNear(Body::Moon, birthJd, approxJd, utcOffset,
+                               latitude.toDouble(), longitude.toDouble(), options);
 }
 
 
@@ -1390,6 +1583,8 @@ bool ChartCalculator::calculateSunriseSunset(
     QDateTime &sunset,
     QString &errorMsg
     ) {
+    EphemerisContext::Lease lease;
+
     // Convert date to Julian Day at 0h UT
     QDateTime dt(date, QTime(0, 0), QTimeZone::utc());
     double jd_ut = swe_julday(dt.date().year(), dt.date().month(), dt.date().day(), 0.0, SE_GREG_CAL);
@@ -1447,75 +1642,16 @@ ChartData ChartCalculator::calculateJupiterReturn(
     const QString &utcOffset,
     const QString &latitude,
     const QString &longitude,
-    const QString &houseSystem,
+    const CalculationOptions &options,
     int returnNumber)
 {
-    ChartData data;
-
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
-        return data;
-    }
-
-    // Convert birth data to Julian day
+    // Jupiter takes about 11.86 years for one orbit
     QDateTime birthDateTime(birthDate, birthTime);
     double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
-
-    // Get Jupiter's position at birth
-    double xx[6];
-    char serr[256];
-    int flag = SEFLG_SWIEPH;
-    int ret = swe_calc_ut(birthJd, SE_JUPITER, flag, xx, serr);
-
-    if (ret < 0) {
-        m_lastError = QString("Error calculating Jupiter position: %1").arg(serr);
-        return data;
-    }
-
-    double jupiterLongitude = xx[0];
-
-    // Estimate Jupiter return time
-    // Jupiter takes about 11.86 years for one orbit
     double approxJd = birthJd + (returnNumber * 11.86 * 365.25);
 
-    // Find exact Jupiter return (when Jupiter returns to the same longitude)
-    double jrJd = findPlanetaryEvent(SE_JUPITER, approxJd, jupiterLongitude);
-
-    if (jrJd <= 0) {
-        m_lastError = "Could not find Jupiter return";
-        return data;
-    }
-
-    // Calculate chart for the Jupiter return time
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    // Calculate house cusps
-    QVector<HouseData> houses = calculateHouseCusps(jrJd, lat, lon, houseSystem);
-    data.houses = houses;
-
-    // Calculate angles
-    data.angles = calculateAngles(jrJd, lat, lon, houseSystem);
-
-    // Calculate planet positions
-    data.planets = calculatePlanetPositions(jrJd, houses);
-
-    // Add Syzygy, Pars Fortuna, and other methods
-    addSyzygyAndParsFortuna(data.planets, jrJd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, jrJd, houses);
-
-    // Calculate aspects
-    double orbMax = getOrbMax();
-    data.aspects = calculateAspects(data.planets, orbMax);
-
-    // Convert Julian Day to QDateTime
-    QDateTime returnDateTime = julianDayToDateTime(jrJd, utcOffset);
-
-    data.returnDate = returnDateTime.date();
-    data.returnTime = returnDateTime.time();
-    data.returnJulianDay = jrJd;
-
-    return data;
+    return calculateReturnNear(Body::Jupiter, birthJd, approxJd, utcOffset,
+                               latitude.toDouble(), longitude.toDouble(), options);
 }
 
 // more planet returns
@@ -1526,74 +1662,16 @@ ChartData ChartCalculator::calculateVenusReturn(
     const QString &utcOffset,
     const QString &latitude,
     const QString &longitude,
-    const QString &houseSystem,
+    const CalculationOptions &options,
     int returnNumber)
 {
-    ChartData data;
-
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
-        return data;
-    }
-
-    // Convert birth data to Julian day
+    // Venus takes about 0.615 years for one orbit
     QDateTime birthDateTime(birthDate, birthTime);
     double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
-
-    // Get Venus's position at birth
-    double xx[6];
-    char serr[256];
-    int flag = SEFLG_SWIEPH;
-    int ret = swe_calc_ut(birthJd, SE_VENUS, flag, xx, serr);
-
-    if (ret < 0) {
-        m_lastError = QString("Error calculating Venus position: %1").arg(serr);
-        return data;
-    }
-
-    double venusLongitude = xx[0];
-
-    // Estimate Venus return time
-    // Venus takes about 0.615 years for one orbit
     double approxJd = birthJd + (returnNumber * 0.61519726 * 365.25);
 
-    // Find exact Venus return (when Venus returns to the same longitude)
-    double vrJd = findPlanetaryEvent(SE_VENUS, approxJd, venusLongitude);
-
-    if (vrJd <= 0) {
-        m_lastError = "Could not find Venus return";
-        return data;
-    }
-
-    // Calculate chart for the Venus return time
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    // Calculate house cusps
-    QVector<HouseData> houses = calculateHouseCusps(vrJd, lat, lon, houseSystem);
-    data.houses = houses;
-
-    // Calculate angles
-    data.angles = calculateAngles(vrJd, lat, lon, houseSystem);
-
-    // Calculate planet positions
-    data.planets = calculatePlanetPositions(vrJd, houses);
-
-    // Add Syzygy, Pars Fortuna, and other methods
-    addSyzygyAndParsFortuna(data.planets, vrJd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, vrJd, houses);
-
-    // Calculate aspects
-    double orbMax = getOrbMax();
-    data.aspects = calculateAspects(data.planets, orbMax);
-
-    // Convert Julian Day to QDateTime
-    QDateTime returnDateTime = julianDayToDateTime(vrJd, utcOffset);
-    data.returnDate = returnDateTime.date();
-    data.returnTime = returnDateTime.time();
-    data.returnJulianDay = vrJd;
-
-    return data;
+    return calculateReturnNear(Body::Venus, birthJd, approxJd, utcOffset,
+                               latitude.toDouble(), longitude.toDouble(), options);
 }
 
 ChartData ChartCalculator::calculateMarsReturn(
@@ -1602,74 +1680,16 @@ ChartData ChartCalculator::calculateMarsReturn(
     const QString &utcOffset,
     const QString &latitude,
     const QString &longitude,
-    const QString &houseSystem,
+    const CalculationOptions &options,
     int returnNumber)
 {
-    ChartData data;
-
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
-        return data;
-    }
-
-    // Convert birth data to Julian day
+    // Mars takes about 1.88 years for one orbit
     QDateTime birthDateTime(birthDate, birthTime);
     double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
-
-    // Get Mars's position at birth
-    double xx[6];
-    char serr[256];
-    int flag = SEFLG_SWIEPH;
-    int ret = swe_calc_ut(birthJd, SE_MARS, flag, xx, serr);
-
-    if (ret < 0) {
-        m_lastError = QString("Error calculating Mars position: %1").arg(serr);
-        return data;
-    }
-
-    double marsLongitude = xx[0];
-
-    // Estimate Mars return time
-    // Mars takes about 1.88 years for one orbit
     double approxJd = birthJd + (returnNumber * 1.8808476 * 365.25);
 
-    // Find exact Mars return (when Mars returns to the same longitude)
-    double mrJd = findPlanetaryEvent(SE_MARS, approxJd, marsLongitude);
-
-    if (mrJd <= 0) {
-        m_lastError = "Could not find Mars return";
-        return data;
-    }
-
-    // Calculate chart for the Mars return time
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    // Calculate house cusps
-    QVector<HouseData> houses = calculateHouseCusps(mrJd, lat, lon, houseSystem);
-    data.houses = houses;
-
-    // Calculate angles
-    data.angles = calculateAngles(mrJd, lat, lon, houseSystem);
-
-    // Calculate planet positions
-    data.planets = calculatePlanetPositions(mrJd, houses);
-
-    // Add Syzygy, Pars Fortuna, and other methods
-    addSyzygyAndParsFortuna(data.planets, mrJd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, mrJd, houses);
-
-    // Calculate aspects
-    double orbMax = getOrbMax();
-    data.aspects = calculateAspects(data.planets, orbMax);
-
-    // Convert Julian Day to QDateTime
-    QDateTime returnDateTime = julianDayToDateTime(mrJd, utcOffset);
-    data.returnDate = returnDateTime.date();
-    data.returnTime = returnDateTime.time();
-    data.returnJulianDay = mrJd;
-
-    return data;
+    return calculateReturnNear(Body::Mars, birthJd, approxJd, utcOffset,
+                               latitude.toDouble(), longitude.toDouble(), options);
 }
 
 ChartData ChartCalculator::calculateMercuryReturn(
@@ -1678,230 +1698,49 @@ ChartData ChartCalculator::calculateMercuryReturn(
     const QString &utcOffset,
     const QString &latitude,
     const QString &longitude,
-    const QString &houseSystem,
+    const CalculationOptions &options,
     int returnNumber)
 {
-    ChartData data;
-
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
-        return data;
-    }
-
-    // Convert birth data to Julian day
+    // Mercury takes about 0.24 years for one orbit
     QDateTime birthDateTime(birthDate, birthTime);
     double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
-
-    // Get Mercury's position at birth
-    double xx[6];
-    char serr[256];
-    int flag = SEFLG_SWIEPH;
-    int ret = swe_calc_ut(birthJd, SE_MERCURY, flag, xx, serr);
-
-    if (ret < 0) {
-        m_lastError = QString("Error calculating Mercury position: %1").arg(serr);
-        return data;
-    }
-
-    double mercuryLongitude = xx[0];
-
-    // Estimate Mercury return time
-    // Mercury takes about 0.24 years for one orbit
     double approxJd = birthJd + (returnNumber * 0.2408467 * 365.25);
 
-    // Find exact Mercury return (when Mercury returns to the same longitude)
-    double mrJd = findPlanetaryEvent(SE_MERCURY, approxJd, mercuryLongitude);
-
-    if (mrJd <= 0) {
-        m_lastError = "Could not find Mercury return";
-        return data;
-    }
-
-    // Calculate chart for the Mercury return time
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    // Calculate house cusps
-    QVector<HouseData> houses = calculateHouseCusps(mrJd, lat, lon, houseSystem);
-    data.houses = houses;
-
-    // Calculate angles
-    data.angles = calculateAngles(mrJd, lat, lon, houseSystem);
-
-    // Calculate planet positions
-    data.planets = calculatePlanetPositions(mrJd, houses);
-
-    // Add Syzygy, Pars Fortuna, and other methods
-    addSyzygyAndParsFortuna(data.planets, mrJd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, mrJd, houses);
-
-    // Calculate aspects
-    double orbMax = getOrbMax();
-    data.aspects = calculateAspects(data.planets, orbMax);
-
-    // Convert Julian Day to QDateTime
-    QDateTime returnDateTime = julianDayToDateTime(mrJd, utcOffset);
-    data.returnDate = returnDateTime.date();
-    data.returnTime = returnDateTime.time();
-    data.returnJulianDay = mrJd;
-
-    return data;
+    return calculateReturnNear(Body::Mercury, birthJd, approxJd, utcOffset,
+                               latitude.toDouble(), longitude.toDouble(), options);
 }
 
 //Uranus Neptune Pluto
 
-ChartData ChartCalculator::calculateUranusReturn(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const QString &houseSystem, int returnNumber)
+ChartData ChartCalculator::calculateUranusReturn(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const CalculationOptions &options, int returnNumber)
 {
-    ChartData data;
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
-        return data;
-    }
-
+    // Uranus takes about 84 years for one orbit
     QDateTime birthDateTime(birthDate, birthTime);
     double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
+    double approxJd = birthJd + (returnNumber * 84.016846 * 365.25);
 
-    double xx[6];
-    char serr[256];
-    int flag = SEFLG_SWIEPH;
-    int ret = swe_calc_ut(birthJd, SE_URANUS, flag, xx, serr);
-    if (ret < 0) {
-        m_lastError = QString("Error calculating Uranus position: %1").arg(serr);
-        return data;
-    }
-    double uranusLongitude = xx[0];
-
-    double uranusPeriod = 84.016846;
-    double approxJd = birthJd + (returnNumber * uranusPeriod * 365.25);
-
-    double srJd = findPlanetaryEvent(SE_URANUS, approxJd, uranusLongitude);
-    if (srJd <= 0) {
-        m_lastError = "Could not find Uranus return";
-        return data;
-    }
-
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    QVector<HouseData> houses = calculateHouseCusps(srJd, lat, lon, houseSystem);
-    data.houses = houses;
-    data.angles = calculateAngles(srJd, lat, lon, houseSystem);
-    data.planets = calculatePlanetPositions(srJd, houses);
-
-    addSyzygyAndParsFortuna(data.planets, srJd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, srJd, houses);
-
-    double orbMax = getOrbMax();
-    data.aspects = calculateAspects(data.planets, orbMax);
-
-    QDateTime returnDateTime = julianDayToDateTime(srJd, utcOffset);
-    data.returnDate = returnDateTime.date();
-    data.returnTime = returnDateTime.time();
-    data.returnJulianDay = srJd;
-
-    return data;
+    return calculateReturnNear(Body::Uranus, birthJd, approxJd, utcOffset,
+                               latitude.toDouble(), longitude.toDouble(), options);
 }
 
-ChartData ChartCalculator::calculateNeptuneReturn(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const QString &houseSystem, int returnNumber)
+ChartData ChartCalculator::calculateNeptuneReturn(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const CalculationOptions &options, int returnNumber)
 {
-    ChartData data;
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
-        return data;
-    }
-
+    // Neptune takes about 164.8 years for one orbit
     QDateTime birthDateTime(birthDate, birthTime);
     double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
+    double approxJd = birthJd + (returnNumber * 164.79132 * 365.25);
 
-    double xx[6];
-    char serr[256];
-    int flag = SEFLG_SWIEPH;
-    int ret = swe_calc_ut(birthJd, SE_NEPTUNE, flag, xx, serr);
-    if (ret < 0) {
-        m_lastError = QString("Error calculating Neptune position: %1").arg(serr);
-        return data;
-    }
-    double neptuneLongitude = xx[0];
-
-    double neptunePeriod = 164.79132;
-    double approxJd = birthJd + (returnNumber * neptunePeriod * 365.25);
-
-    double srJd = findPlanetaryEvent(SE_NEPTUNE, approxJd, neptuneLongitude);
-    if (srJd <= 0) {
-        m_lastError = "Could not find Neptune return";
-        return data;
-    }
-
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    QVector<HouseData> houses = calculateHouseCusps(srJd, lat, lon, houseSystem);
-    data.houses = houses;
-    data.angles = calculateAngles(srJd, lat, lon, houseSystem);
-    data.planets = calculatePlanetPositions(srJd, houses);
-
-    addSyzygyAndParsFortuna(data.planets, srJd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, srJd, houses);
-
-    double orbMax = getOrbMax();
-    data.aspects = calculateAspects(data.planets, orbMax);
-
-    QDateTime returnDateTime = julianDayToDateTime(srJd, utcOffset);
-    data.returnDate = returnDateTime.date();
-    data.returnTime = returnDateTime.time();
-    data.returnJulianDay = srJd;
-
-    return data;
+    return calculateReturnNear(Body::Neptune, birthJd, approxJd, utcOffset,
+                               latitude.toDouble(), longitude.toDouble(), options);
 }
 
-ChartData ChartCalculator::calculatePlutoReturn(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const QString &houseSystem, int returnNumber)
+ChartData ChartCalculator::calculatePlutoReturn(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const CalculationOptions &options, int returnNumber)
 {
-    ChartData data;
-    if (!m_isInitialized) {
-        m_lastError = "Swiss Ephemeris not initialized";
-        return data;
-    }
-
+    // Pluto takes about 248 years for one orbit
     QDateTime birthDateTime(birthDate, birthTime);
     double birthJd = dateTimeToJulianDay(birthDateTime, utcOffset);
+    double approxJd = birthJd + (returnNumber * 248.00 * 365.25);
 
-    double xx[6];
-    char serr[256];
-    int flag = SEFLG_SWIEPH;
-    int ret = swe_calc_ut(birthJd, SE_PLUTO, flag, xx, serr);
-    if (ret < 0) {
-        m_lastError = QString("Error calculating Pluto position: %1").arg(serr);
-        return data;
-    }
-    double plutoLongitude = xx[0];
-
-    double plutoPeriod = 248.00;
-    double approxJd = birthJd + (returnNumber * plutoPeriod * 365.25);
-
-    double srJd = findPlanetaryEvent(SE_PLUTO, approxJd, plutoLongitude);
-    if (srJd <= 0) {
-        m_lastError = "Could not find Pluto return";
-        return data;
-    }
-
-    double lat = latitude.toDouble();
-    double lon = longitude.toDouble();
-
-    QVector<HouseData> houses = calculateHouseCusps(srJd, lat, lon, houseSystem);
-    data.houses = houses;
-    data.angles = calculateAngles(srJd, lat, lon, houseSystem);
-    data.planets = calculatePlanetPositions(srJd, houses);
-
-    addSyzygyAndParsFortuna(data.planets, srJd, houses, data.angles);
-    calculateAdditionalBodies(data.planets, srJd, houses);
-
-    double orbMax = getOrbMax();
-    data.aspects = calculateAspects(data.planets, orbMax);
-
-    QDateTime returnDateTime = julianDayToDateTime(srJd, utcOffset);
-    data.returnDate = returnDateTime.date();
-    data.returnTime = returnDateTime.time();
-    data.returnJulianDay = srJd;
-
-    return data;
+    return calculateReturnNear(Body::Pluto, birthJd, approxJd, utcOffset,
+                               latitude.toDouble(), longitude.toDouble(), options);
 }
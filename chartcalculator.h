@@ -6,6 +6,11 @@
 #include <QTime>
 #include <QString>
 #include <QVector>
+#include <functional>
+#include <memory>
+#include "transitengine.h"
+#include "compactchart.h"
+#include "calculationoptions.h"
 
 // Forward declare Swiss Ephemeris types to avoid including C headers in header
 typedef void* SWEPH_HANDLE;
@@ -64,9 +69,66 @@ struct EclipseData {
     double longitude;  // Geographic longitude where the eclipse is maximum
 };
 
+// One transiting body in aspect to a natal point on a given day
+struct TransitHit {
+    QDate date;
+    Body transitBody;
+    Body natalBody;
+    AspectKind aspect;
+    double orb = 0.0;
+    bool retrograde = false;
+};
+
+// Progress hook for long scans, called with the work done so far and the
+// total. Returning false cancels the scan.
+using ProgressCallback = std::function<bool(int done, int total)>;
+
+// Receives transit hits in date order, a few days at a time
+using TransitChunkCallback = std::function<void(const QVector<TransitHit> &chunk)>;
+
+// Natal positions that transit and return searches measure against. Get
+// one from ChartCalculator::natalChart(), which memoizes them by birth
+// parameters, and pass it to the NatalChart overloads so repeated requests
+// for the same person skip the natal ephemeris work.
+struct NatalChart {
+    double birthJd = 0.0;
+    QString utcOffset;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    // What the chart was calculated with. Its house system and body set
+    // decide which natal points exist, so searches against the chart use
+    // them whatever options they are given.
+    CalculationOptions options;
+    QVector<PlanetData> planets;
+
+    // Longitude of a natal point; false if the chart does not have it
+    bool longitudeOf(Body body, double &longitude) const;
+
+    // options with the house system and body set of this chart
+    CalculationOptions searchOptions(const CalculationOptions &options) const;
+};
+
+using NatalChartHandle = std::shared_ptr<const NatalChart>;
+
+// Input for one chart in a batch calculation
+struct ChartRequest {
+    QDate birthDate;
+    QTime birthTime;
+    QString utcOffset;
+    QString latitude;
+    QString longitude;
+    QString houseSystem = "Placidus";
+};
+
+// Instances are cheap: the ephemeris search runs once per process and the
+// Swiss Ephemeris state is per thread (see EphemerisContext). Use one
+// instance per thread; several instances may compute at the same time.
 class ChartCalculator : public QObject
 {
     Q_OBJECT
+    // Runs the chart stages one by one and caches their results
+    friend class ChartPipeline;
+
 public:
     explicit ChartCalculator(QObject *parent = nullptr);
     ~ChartCalculator();
@@ -75,23 +137,98 @@ public:
     bool initialize();
 
 
-    // Calculate chart with the given birth data
+    // Every calculation takes its settings from a CalculationOptions value
+    // and reads no globals, so the result depends on the arguments alone.
+
+    // Calculate chart with the given birth data, in options.houseSystem
     ChartData calculateChart(const QDate &birthDate,
                              const QTime &birthTime,
                              const QString &utcOffset,
                              const QString &latitude,
                              const QString &longitude,
-                             const QString &houseSystem,
-                             double orbMax = 8.0);
+                             const CalculationOptions &options);
+
+    // Calculate many charts concurrently on the shared ephemeris pool.
+    // Results come back in request order. Each request's house system
+    // replaces the one in options.
+    QVector<ChartData> calculateCharts(const QVector<ChartRequest> &requests,
+                                       const CalculationOptions &options);
 
-    // Calculate transits
+    // Same as calculateCharts, converted to CompactChart on the worker
+    // threads so that only the compact form is ever held for the batch
+    QVector<CompactChart> calculateCompactCharts(const QVector<ChartRequest> &requests,
+                                                 const CalculationOptions &options);
+
+    // Calculate transits as a "---TRANSITS---" text report, one line per day
     QString calculateTransits(const QDate &birthDate,
                               const QTime &birthTime,
                               const QString &utcOffset,
                               const QString &latitude,
                               const QString &longitude,
                               const QDate &transitStartDate,
-                              int numberOfDays);
+                              int numberOfDays,
+                              const CalculationOptions &options);
+
+    // Same daily scan as calculateTransits, as typed results in date order.
+    // progress counts days; a cancelled scan stops early. With chunkReady
+    // the hits go to the callback block by block as the scan proceeds, and
+    // the returned list stays empty.
+    QVector<TransitHit> calculateTransitList(const QDate &birthDate,
+                                             const QTime &birthTime,
+                                             const QString &utcOffset,
+                                             const QString &latitude,
+                                             const QString &longitude,
+                                             const QDate &transitStartDate,
+                                             int numberOfDays,
+                                             const CalculationOptions &options,
+                                             const ProgressCallback &progress = nullptr,
+                                             const TransitChunkCallback &chunkReady = nullptr);
+
+    // Natal chart for the birth data. Kept in a small process-wide cache,
+    // so a second request with the same birth data, house system and body
+    // set costs no ephemeris calls. Null on error.
+    NatalChartHandle natalChart(const QDate &birthDate,
+                                const QTime &birthTime,
+                                const QString &utcOffset,
+                                const QString &latitude,
+                                const QString &longitude,
+                                const CalculationOptions &options);
+
+    // calculateTransitList against a natal chart that is already computed.
+    // The chart's house system and body set override those in options.
+    QVector<TransitHit> calculateTransitList(const NatalChart &natal,
+                                             const QDate &transitStartDate,
+                                             int numberOfDays,
+                                             const CalculationOptions &options,
+                                             const ProgressCallback &progress = nullptr,
+                                             const TransitChunkCallback &chunkReady = nullptr);
+
+    // Text report used by calculateTransits and the AI prompt
+    static QString formatTransitReport(const QVector<TransitHit> &hits,
+                                       const QDate &transitStartDate,
+                                       int numberOfDays);
+
+    // Text report of aspect windows for the AI prompt: one line per window
+    // with its UT entry, exit and exact times
+    static QString formatTransitEventReport(const QVector<TransitEvent> &events);
+
+    // Find transit aspect windows with their exact times instead of a daily
+    // report. Uses the same bodies, aspects and orbs as calculateTransits.
+    QVector<TransitEvent> calculateTransitEvents(const QDate &birthDate,
+                                                 const QTime &birthTime,
+                                                 const QString &utcOffset,
+                                                 const QString &latitude,
+                                                 const QString &longitude,
+                                                 const QDate &transitStartDate,
+                                                 int numberOfDays,
+                                                 const CalculationOptions &options,
+                                                 const ProgressCallback &progress = nullptr);
+
+    QVector<TransitEvent> calculateTransitEvents(const NatalChart &natal,
+                                                 const QDate &transitStartDate,
+                                                 int numberOfDays,
+                                                 const CalculationOptions &options,
+                                                 const ProgressCallback &progress = nullptr);
 
     // New methods using Swiss Ephemeris
 
@@ -101,7 +238,7 @@ public:
                                    const QString &utcOffset,
                                    const QString &latitude,
                                    const QString &longitude,
-                                   const QString &houseSystem,
+                                   const CalculationOptions &options,
 
                                    int year);
 
@@ -111,15 +248,17 @@ public:
                                     const QString &utcOffset,
                                     const QString &latitude,
                                     const QString &longitude,
-                                    const QString &houseSystem,
+                                    const CalculationOptions &options,
                                     int returnNumber = 1);
 
     // Find eclipses in a date range
 
+    // progress counts days searched; a cancelled search returns nothing
     QVector<EclipseData> findEclipses(const QDate &startDate,
                                       const QDate &endDate,
                                       bool solarEclipses = true,
-                                      bool lunarEclipses = true);
+                                      bool lunarEclipses = true,
+                                      const ProgressCallback &progress = nullptr);
 
     ChartData calculateLunarReturn(
     const QDate &birthDate,
@@ -127,7 +266,7 @@ public:
     const QString &utcOffset,
     const QString &latitude,
     const QString &longitude,
-    const QString &houseSystem,
+    const CalculationOptions &options,
     const QDate &targetDate // The date for which to find the lunar return
     );
 
@@ -137,7 +276,7 @@ public:
         const QString &utcOffset,
         const QString &latitude,
         const QString &longitude,
-        const QString &houseSystem,
+        const CalculationOptions &options,
         int returnNumber);
 
     ChartData calculateVenusReturn(
@@ -146,7 +285,7 @@ public:
         const QString &utcOffset,
         const QString &latitude,
         const QString &longitude,
-        const QString &houseSystem,
+        const CalculationOptions &options,
         int returnNumber);
 
     ChartData calculateMarsReturn(
@@ -155,7 +294,7 @@ public:
         const QString &utcOffset,
         const QString &latitude,
         const QString &longitude,
-        const QString &houseSystem,
+        const CalculationOptions &options,
         int returnNumber);
 
     ChartData calculateMercuryReturn(
@@ -164,7 +303,7 @@ public:
         const QString &utcOffset,
         const QString &latitude,
         const QString &longitude,
-        const QString &houseSystem,
+        const CalculationOptions &options,
         int returnNumber);
 
     ChartData calculateUranusReturn(
@@ -173,7 +312,7 @@ public:
         const QString &utcOffset,
         const QString &latitude,
         const QString &longitude,
-        const QString &houseSystem,
+        const CalculationOptions &options,
         int returnNumber);
 
     ChartData calculateNeptuneReturn(
@@ -182,7 +321,7 @@ public:
         const QString &utcOffset,
         const QString &latitude,
         const QString &longitude,
-        const QString &houseSystem,
+        const CalculationOptions &options,
         int returnNumber);
 
     ChartData calculatePlutoReturn(
@@ -191,13 +330,35 @@ public:
         const QString &utcOffset,
         const QString &latitude,
         const QString &longitude,
-        const QString &houseSystem,
+        const CalculationOptions &options,
         int returnNumber);
 
 
+    // Every return of a body between two dates, retrograde passes included.
+    // The returns are found in one sweep and their charts built in parallel.
+    QVector<ChartData> calculateReturnSeries(Body body,
+                                             const QDate &birthDate,
+                                             const QTime &birthTime,
+                                             const QString &utcOffset,
+                                             const QString &latitude,
+                                             const QString &longitude,
+                                             const CalculationOptions &options,
+                                             const QDate &fromDate,
+                                             const QDate &toDate);
+
+    // calculateReturnSeries with the natal longitude taken from a natal chart
+    QVector<ChartData> calculateReturnSeries(Body body,
+                                             const NatalChart &natal,
+                                             const CalculationOptions &options,
+                                             const QDate &fromDate,
+                                             const QDate &toDate);
+
     // Check if the calculator is available
     bool isAvailable() const;
 
+    // Julian day (UT) of a local birth time, as used by every calculation
+    double julianDay(const QDate &date, const QTime &time, const QString &utcOffset) const;
+
     // Get the last error message
     QString getLastError() const;
 
@@ -211,27 +372,56 @@ private:
 
     QString getZodiacSign(double longitude) const;
     QString findHouse(double longitude, const QVector<HouseData> &houses) const;
-    QVector<AspectData> calculateAspects(const QVector<PlanetData> &planets, double orbMax) const;
+    QVector<AspectData> calculateAspects(const QVector<PlanetData> &planets, const AspectOrbTable &orbs) const;
+
+    // Everything one swe_houses_ex call gives for a chart
+    struct HouseFrame {
+        QVector<HouseData> houses;
+        QVector<AngleData> angles;   // Asc, MC, Desc, IC
+        double ascendant = 0.0;
+        double vertex = 0.0;
+        double eastPoint = 0.0;
+        bool valid = false;
+    };
 
     // Swiss Ephemeris calculation methods
-    QVector<HouseData> calculateHouseCusps(double jd, double lat, double lon, const QString &houseSystem) const;
-    QVector<PlanetData> calculatePlanetPositions(double jd, const QVector<HouseData> &houses) const;
-
-    void addSyzygyAndParsFortuna(QVector<PlanetData> &planets, double jd, const QVector<HouseData> &houses, const QVector<AngleData> &angles) const;
-
-    QVector<AngleData> calculateAngles(double jd, double lat, double lon, const QString &houseSystem) const;
-
-
-    // Find specific planetary event (for returns)
-    double findPlanetaryEvent(int planet, double startJd, double targetLongitude) const;
+    static char houseSystemCode(const QString &houseSystem);
+    HouseFrame calculateHouseFrame(double jd, double lat, double lon, const QString &houseSystem) const;
+
+    // Ephemeris positions of a chart in display order, before houses are
+    // known. Points taken from the houses (Lots, Vertex, East Point) are
+    // placeholders until placeBodies() fills them in.
+    struct BodyPositions {
+        QVector<PlanetData> planets;
+        QVector<Body> bodies;
+    };
+
+    BodyPositions calculateBodyPositions(double jd, bool additionalBodies) const;
+    QVector<PlanetData> placeBodies(const BodyPositions &positions, const HouseFrame &frame) const;
+
+    // Houses, angles and planets of a chart from one house calculation.
+    // additionalBodies adds the Syzygy, Lots, asteroids, Vertex and East Point.
+    ChartData calculatePositions(double jd, double lat, double lon, const QString &houseSystem,
+                                 bool additionalBodies) const;
+
+    // Natal points used as transit targets
+    QVector<PlanetData> calculateTransitNatalPlanets(double birthJd, double lat, double lon,
+                                                     const CalculationOptions &options) const;
+
+
+    // Shared by all return calculations
+    ChartData buildChartAt(double jd, const QString &utcOffset, double lat, double lon,
+                           const CalculationOptions &options) const;
+    ChartData calculateReturnNear(Body body, double birthJd, double approxJd,
+                                  const QString &utcOffset, double lat, double lon,
+                                  const CalculationOptions &options);
+    bool natalLongitude(Body body, double birthJd, double &longitude);
+    static QString returnName(Body body);
 
     QString m_lastError;
     QString m_ephemerisPath;private:
 
     bool m_isInitialized;
-    QString houseSystem = "Placidus";
-    //QString houseSystem;
-    void calculateAdditionalBodies(QVector<PlanetData> &planets, double jd,const QVector<HouseData> &houses) const;
 
 
     bool calculateSunriseSunset(
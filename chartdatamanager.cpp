@@ -2,11 +2,80 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDebug>
-#include"Globals.h"
+#include <QDateTime>
+#include <QTimeZone>
+#include <QDataStream>
+#include <QJsonDocument>
+
+namespace {
+
+// Serialized inputs and payloads for the on-disk result cache. Changing any
+// of these layouts needs a ResultCache::FormatVersion bump.
+void writeOptions(QDataStream &out, const CalculationOptions &options)
+{
+    out << options.houseSystem << options.additionalBodies << options.transitChartPoints;
+    for (int i = 0; i < AspectKindCount; ++i) {
+        out << options.orbs.aspectOrb(AspectKind(i));
+    }
+    for (int i = 0; i < BodyCount; ++i) {
+        out << options.orbs.bodyFactor(Body(i));
+    }
+}
+
+// Transit hits are stored back to back, HitBytes each, so an entry can be
+// written and replayed a chunk at a time
+const qint64 HitBytes = 20;
+
+void writeHits(QDataStream &out, const QVector<TransitHit> &hits)
+{
+    for (const TransitHit &hit : hits) {
+        out << qint64(hit.date.toJulianDay()) << quint8(hit.transitBody) << quint8(hit.natalBody)
+            << quint8(hit.aspect) << hit.orb << hit.retrograde;
+    }
+}
+
+bool readHits(QDataStream &in, int count, QVector<TransitHit> &hits)
+{
+    hits.resize(count);
+    for (TransitHit &hit : hits) {
+        qint64 day = 0;
+        quint8 transitBody = 0, natalBody = 0, aspect = 0;
+        in >> day >> transitBody >> natalBody >> aspect >> hit.orb >> hit.retrograde;
+        if (transitBody >= BodyCount || natalBody >= BodyCount || aspect >= AspectKindCount) {
+            return false;
+        }
+        hit.date = QDate::fromJulianDay(day);
+        hit.transitBody = Body(transitBody);
+        hit.natalBody = Body(natalBody);
+        hit.aspect = AspectKind(aspect);
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+QByteArray encodeArray(const QJsonArray &array)
+{
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+bool decodeArray(const QByteArray &bytes, QJsonArray &array)
+{
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(bytes, &error);
+    if (error.error != QJsonParseError::NoError || !document.isArray()) {
+        return false;
+    }
+    array = document.array();
+    return true;
+}
+
+}
 
 ChartDataManager::ChartDataManager(QObject *parent)
     : QObject(parent)
     , m_calculator(new ChartCalculator(this))
+    , m_pipeline(m_calculator)
+    , m_chartCache(16 * 1024 * 1024)
+    , m_resultCache(ResultCache::shared())
 {
 }
 
@@ -22,52 +91,157 @@ bool ChartDataManager::isCalculatorAvailable() const
     return m_calculator->isAvailable();
 }
 
+void ChartDataManager::setOptions(const CalculationOptions &options)
+{
+    m_options = options;
+}
+
+CalculationOptions ChartDataManager::options() const
+{
+    return m_options ? *m_options : CalculationOptions::fromGlobals();
+}
+
+CalculationOptions ChartDataManager::optionsFor(const QString &houseSystem) const
+{
+    CalculationOptions result = options();
+    result.houseSystem = houseSystem;
+    return result;
+}
+
+bool ChartDataManager::ChartCacheKey::operator==(const ChartCacheKey &other) const
+{
+    return jd == other.jd && utcOffset == other.utcOffset
+            && latitude == other.latitude && longitude == other.longitude
+            && kind == other.kind && detail == other.detail
+            && options == other.options;
+}
+
+ChartDataManager::ChartCacheKey ChartDataManager::chartCacheKey(const QDate &birthDate,
+                                                                const QTime &birthTime,
+                                                                const QString &utcOffset,
+                                                                const QString &latitude,
+                                                                const QString &longitude,
+                                                                const QString &houseSystem,
+                                                                int kind, qint64 detail) const
+{
+    // Inputs are compared as the numbers the calculator sees, so "51.5" and
+    // "51.50" or two spellings of the same offset share an entry
+    ChartCacheKey key;
+    key.jd = m_calculator->julianDay(birthDate, birthTime, utcOffset);
+    key.latitude = latitude.toDouble();
+    key.longitude = longitude.toDouble();
+    key.kind = kind;
+    key.detail = detail;
+    key.options = optionsFor(houseSystem);
+    // Return dates are shown in the birth time zone
+    if (kind >= 0) {
+        key.utcOffset = utcOffset;
+    }
+    return key;
+}
+
+ChartData ChartDataManager::cachedChart(const ChartCacheKey &key,
+                                        const std::function<ChartData()> &compute)
+{
+    m_lastError.clear();
+
+    if (const ChartData *cached = m_chartCache.object(key)) {
+        ++m_chartCacheHits;
+        return *cached;
+    }
+    ++m_chartCacheMisses;
+
+    ChartData data = compute();
+    if (!m_calculator->getLastError().isEmpty()) {
+        m_lastError = m_calculator->getLastError();
+        return data;
+    }
+
+    // A chart bigger than the whole budget is not kept (QCache deletes it)
+    m_chartCache.insert(key, new ChartData(data), estimatedBytes(data));
+    return data;
+}
+
+qint64 ChartDataManager::estimatedBytes(const ChartData &data)
+{
+    // Records plus their strings; the names are short, so a flat allowance
+    // per string is close enough for a budget
+    const qint64 perString = 48;
+    qint64 bytes = sizeof(ChartData);
+    bytes += data.planets.size() * (sizeof(PlanetData) + 3 * perString);
+    bytes += data.houses.size() * (sizeof(HouseData) + 2 * perString);
+    bytes += data.angles.size() * (sizeof(AngleData) + 2 * perString);
+    bytes += data.aspects.size() * (sizeof(AspectData) + 3 * perString);
+    return bytes;
+}
+
+void ChartDataManager::setChartCacheBudget(qint64 bytes)
+{
+    m_chartCache.setMaxCost(bytes);
+}
+
+ChartDataManager::ChartCacheStats ChartDataManager::chartCacheStats() const
+{
+    ChartCacheStats stats;
+    stats.hits = m_chartCacheHits;
+    stats.misses = m_chartCacheMisses;
+    stats.charts = int(m_chartCache.count());
+    stats.bytes = m_chartCache.totalCost();
+    stats.budget = m_chartCache.maxCost();
+    return stats;
+}
+
+void ChartDataManager::clearChartCache()
+{
+    m_chartCache.clear();
+    m_chartCacheHits = 0;
+    m_chartCacheMisses = 0;
+}
+
 ChartData ChartDataManager::calculateChart(const QDate &birthDate,
                                            const QTime &birthTime,
                                            const QString &utcOffset,
                                            const QString &latitude,
                                            const QString &longitude,
-                                           const QString &houseSystem,
-                                           double orbMax)
+                                           const QString &houseSystem)
+{
+    const ChartCacheKey key = chartCacheKey(birthDate, birthTime, utcOffset,
+                                            latitude, longitude, houseSystem);
+
+    // On a miss only the pipeline stages whose inputs changed since the
+    // last chart are rerun
+    return cachedChart(key, [&]() {
+        return m_pipeline.calculate(birthDate, birthTime, utcOffset,
+                                    latitude, longitude, key.options);
+    });
+}
+
+QVector<ChartData> ChartDataManager::calculateCharts(const QVector<ChartRequest> &requests)
 {
-    // Clear any previous error
     m_lastError.clear();
 
-    orbMax = getOrbMax();
-    // Calculate the chart
-    ChartData data = m_calculator->calculateChart(birthDate, birthTime, utcOffset,
-                                                  latitude, longitude, houseSystem, orbMax);
+    QVector<ChartData> charts = m_calculator->calculateCharts(requests, options());
 
-    // Check for errors
     if (!m_calculator->getLastError().isEmpty()) {
         m_lastError = m_calculator->getLastError();
     }
 
-    return data;
+    return charts;
 }
 
-QJsonObject ChartDataManager::calculateChartAsJson(const QDate &birthDate,
-                                                   const QTime &birthTime,
-                                                   const QString &utcOffset,
-                                                   const QString &latitude,
-                                                   const QString &longitude,
-                                                   const QString &houseSystem,
-                                                   double orbMax)
+QVector<CompactChart> ChartDataManager::calculateCompactCharts(const QVector<ChartRequest> &requests)
 {
-    // Calculate the chart
-    orbMax = getOrbMax();
+    m_lastError.clear();
 
-    ChartData data = calculateChart(birthDate, birthTime, utcOffset,
-                                    latitude, longitude, houseSystem, orbMax);
+    QVector<CompactChart> charts = m_calculator->calculateCompactCharts(requests, options());
 
-    // If there was an error, return an empty object
-    if (!m_lastError.isEmpty()) {
-        return QJsonObject{{"error", m_lastError}};
+    if (!m_calculator->getLastError().isEmpty()) {
+        m_lastError = m_calculator->getLastError();
     }
 
-    // Convert to JSON
-    return chartDataToJson(data);
+    return charts;
 }
+
 /*
 QJsonObject ChartDataManager::chartDataToJson(const ChartData &data)
 {
@@ -189,6 +363,7 @@ QString ChartDataManager::calculateTransits(const QDate &birthDate,
                                             const QString &utcOffset,
                                             const QString &latitude,
                                             const QString &longitude,
+                                            const QString &houseSystem,
                                             const QDate &transitStartDate,
                                             int numberOfDays) {
     // Clear any previous error
@@ -197,7 +372,8 @@ QString ChartDataManager::calculateTransits(const QDate &birthDate,
     // Calculate the transits
     QString output = m_calculator->calculateTransits(birthDate, birthTime, utcOffset,
                                                      latitude, longitude,
-                                                     transitStartDate, numberOfDays);
+                                                     transitStartDate, numberOfDays,
+                                                     optionsFor(houseSystem));
 
     // Check for errors
     if (!m_calculator->getLastError().isEmpty()) {
@@ -207,26 +383,177 @@ QString ChartDataManager::calculateTransits(const QDate &birthDate,
     return output;
 }
 
+QVector<TransitHit> ChartDataManager::calculateTransitList(const QDate &birthDate,
+                                                          const QTime &birthTime,
+                                                          const QString &utcOffset,
+                                                          const QString &latitude,
+                                                          const QString &longitude,
+                                                          const QString &houseSystem,
+                                                          const QDate &transitStartDate,
+                                                          int numberOfDays,
+                                                          const ProgressCallback &progress,
+                                                          const TransitChunkCallback &chunkReady) {
+    m_lastError.clear();
+    const CalculationOptions options = optionsFor(houseSystem);
+
+    // Hit dates depend on the start date only, so the birth time zone is
+    // not part of the key
+    QByteArray inputs;
+    {
+        QDataStream out(&inputs, QIODevice::WriteOnly);
+        out << m_calculator->julianDay(birthDate, birthTime, utcOffset)
+            << latitude.toDouble() << longitude.toDouble()
+            << qint64(transitStartDate.toJulianDay()) << qint32(numberOfDays);
+        writeOptions(out, options);
+    }
+
+    // Longer scans are not kept, so one of them cannot push everything
+    // else out of the cache
+    const int maxStoredHits = 1000000;
+
+    if (std::unique_ptr<ResultCache::Reader> entry = m_resultCache.openEntry("transits", inputs)) {
+        const qint64 bytes = entry->payloadSize();
+        const int count = bytes % HitBytes == 0 && bytes / HitBytes <= maxStoredHits
+                ? int(bytes / HitBytes) : -1;
+        QVector<TransitHit> hits;
+        if (count >= 0 && !chunkReady) {
+            if (readHits(entry->stream(), count, hits)) {
+                return hits;
+            }
+        } else if (count >= 0) {
+            // Same delivery as a scan, a slice at a time read from the file
+            // so it can be cancelled
+            const int sliceSize = 4096;
+            for (int i = 0; i < count; i += sliceSize) {
+                if (progress && !progress(i, count)) {
+                    m_lastError = "Calculation cancelled";
+                    return QVector<TransitHit>();
+                }
+                if (!readHits(entry->stream(), qMin(sliceSize, count - i), hits)) {
+                    // Part of the list has gone out already, so it cannot
+                    // fall back to a scan; the next search makes one
+                    entry.reset();
+                    m_resultCache.remove("transits", inputs);
+                    m_lastError = "The stored transit list is damaged, please search again";
+                    return QVector<TransitHit>();
+                }
+                chunkReady(hits);
+            }
+            return QVector<TransitHit>();
+        }
+
+        // Damaged before anything was delivered: drop it and scan
+        entry.reset();
+        m_resultCache.remove("transits", inputs);
+    }
+
+    // The scan goes to the cache entry as it arrives, so a streamed scan is
+    // never held in memory; past maxStoredHits the entry is abandoned
+    std::unique_ptr<ResultCache::Writer> entry = m_resultCache.beginEntry("transits", inputs);
+    int storedHits = 0;
+    const auto storeHits = [&](const QVector<TransitHit> &chunk) {
+        if (!entry) {
+            return;
+        }
+        storedHits += chunk.size();
+        if (storedHits > maxStoredHits) {
+            entry.reset();
+            return;
+        }
+        writeHits(entry->stream(), chunk);
+    };
+
+    TransitChunkCallback forward;
+    if (chunkReady) {
+        forward = [&](const QVector<TransitHit> &chunk) {
+            storeHits(chunk);
+            chunkReady(chunk);
+        };
+    }
+
+    const QVector<TransitHit> hits = m_calculator->calculateTransitList(birthDate, birthTime, utcOffset,
+                                                                        latitude, longitude,
+                                                                        transitStartDate, numberOfDays,
+                                                                        options, progress, forward);
+
+    // A failed or cancelled scan leaves no entry: the writer is dropped uncommitted
+    if (!m_calculator->getLastError().isEmpty()) {
+        m_lastError = m_calculator->getLastError();
+    } else {
+        if (!chunkReady) {
+            storeHits(hits);
+        }
+        m_resultCache.commit(std::move(entry));
+    }
+
+    return hits;
+}
+
+NatalChartHandle ChartDataManager::natalChart(const QDate &birthDate,
+                                              const QTime &birthTime,
+                                              const QString &utcOffset,
+                                              const QString &latitude,
+                                              const QString &longitude,
+                                              const QString &houseSystem) {
+    m_lastError.clear();
+
+    NatalChartHandle natal = m_calculator->natalChart(birthDate, birthTime, utcOffset,
+                                                      latitude, longitude,
+                                                      optionsFor(houseSystem));
+
+    if (!m_calculator->getLastError().isEmpty()) {
+        m_lastError = m_calculator->getLastError();
+    }
+
+    return natal;
+}
+
+QVector<TransitHit> ChartDataManager::calculateTransitList(const NatalChart &natal,
+                                                          const QDate &transitStartDate,
+                                                          int numberOfDays,
+                                                          const ProgressCallback &progress,
+                                                          const TransitChunkCallback &chunkReady) {
+    m_lastError.clear();
+
+    QVector<TransitHit> hits = m_calculator->calculateTransitList(natal, transitStartDate, numberOfDays,
+                                                                  natal.searchOptions(options()),
+                                                                  progress, chunkReady);
+
+    if (!m_calculator->getLastError().isEmpty()) {
+        m_lastError = m_calculator->getLastError();
+    }
+
+    return hits;
+}
+
 QJsonObject ChartDataManager::calculateTransitsAsJson(const QDate &birthDate,
                                                       const QTime &birthTime,
                                                       const QString &utcOffset,
                                                       const QString &latitude,
                                                       const QString &longitude,
+                                                      const QString &houseSystem,
                                                       const QDate &transitStartDate,
                                                       int numberOfDays) {
-    // Calculate the transits
-    QString output = calculateTransits(birthDate, birthTime, utcOffset,
-                                       latitude, longitude,
-                                       transitStartDate, numberOfDays);
-
-    // Debug the raw output
+    QVector<TransitHit> hits = calculateTransitList(birthDate, birthTime, utcOffset,
+                                                    latitude, longitude, houseSystem,
+                                                    transitStartDate, numberOfDays);
 
     // If there was an error, return an empty object
     if (!m_lastError.isEmpty()) {
         return QJsonObject{{"error", m_lastError}};
     }
 
-    // Create a simple JSON object with the raw output
+    return transitListToJson(hits, birthDate, birthTime, latitude, longitude,
+                             transitStartDate, numberOfDays);
+}
+
+QJsonObject ChartDataManager::transitListToJson(const QVector<TransitHit> &hits,
+                                                const QDate &birthDate,
+                                                const QTime &birthTime,
+                                                const QString &latitude,
+                                                const QString &longitude,
+                                                const QDate &transitStartDate,
+                                                int numberOfDays) {
     QJsonObject json;
     json["birthDate"] = birthDate.toString("yyyy-MM-dd");
     json["birthTime"] = birthTime.toString("HH:mm");
@@ -234,22 +561,192 @@ QJsonObject ChartDataManager::calculateTransitsAsJson(const QDate &birthDate,
     json["longitude"] = longitude;
     json["transitStartDate"] = transitStartDate.toString("yyyy-MM-dd");
     json["numberOfDays"] = QString::number(numberOfDays);
-    json["rawTransitData"] = output;
+    json["rawTransitData"] = ChartCalculator::formatTransitReport(hits, transitStartDate, numberOfDays);
+    return json;
+}
 
-    // Debug the JSON object
+QVector<TransitEvent> ChartDataManager::calculateTransitEvents(const QDate &birthDate,
+                                                               const QTime &birthTime,
+                                                               const QString &utcOffset,
+                                                               const QString &latitude,
+                                                               const QString &longitude,
+                                                               const QString &houseSystem,
+                                                               const QDate &transitStartDate,
+                                                               int numberOfDays,
+                                                               const ProgressCallback &progress) {
+    m_lastError.clear();
+
+    QVector<TransitEvent> events = m_calculator->calculateTransitEvents(birthDate, birthTime, utcOffset,
+                                                                        latitude, longitude,
+                                                                        transitStartDate, numberOfDays,
+                                                                        optionsFor(houseSystem), progress);
+
+    if (!m_calculator->getLastError().isEmpty()) {
+        m_lastError = m_calculator->getLastError();
+    }
+
+    return events;
+}
+
+QJsonObject ChartDataManager::calculateTransitEventsAsJson(const QDate &birthDate,
+                                                           const QTime &birthTime,
+                                                           const QString &utcOffset,
+                                                           const QString &latitude,
+                                                           const QString &longitude,
+                                                           const QString &houseSystem,
+                                                           const QDate &transitStartDate,
+                                                           int numberOfDays) {
+    QVector<TransitEvent> events = calculateTransitEvents(birthDate, birthTime, utcOffset,
+                                                          latitude, longitude, houseSystem,
+                                                          transitStartDate, numberOfDays);
+
+    if (!m_lastError.isEmpty()) {
+        return QJsonObject{{"error", m_lastError}};
+    }
+
+    return transitEventListToJson(events, birthDate, birthTime, latitude, longitude,
+                                  transitStartDate, numberOfDays);
+}
 
+QJsonObject ChartDataManager::transitEventListToJson(const QVector<TransitEvent> &events,
+                                                     const QDate &birthDate,
+                                                     const QTime &birthTime,
+                                                     const QString &latitude,
+                                                     const QString &longitude,
+                                                     const QDate &transitStartDate,
+                                                     int numberOfDays) {
+    QJsonObject json;
+    json["birthDate"] = birthDate.toString("yyyy-MM-dd");
+    json["birthTime"] = birthTime.toString("HH:mm");
+    json["latitude"] = latitude;
+    json["longitude"] = longitude;
+    json["transitStartDate"] = transitStartDate.toString("yyyy-MM-dd");
+    json["numberOfDays"] = QString::number(numberOfDays);
+    json["reportKind"] = "windows";
+    json["rawTransitData"] = ChartCalculator::formatTransitEventReport(events);
+    json["transitEvents"] = transitEventsToJson(events);
     return json;
 }
 
+QJsonArray ChartDataManager::transitEventsToJson(const QVector<TransitEvent> &events)
+{
+    // Julian day (UT) to an ISO timestamp; JD 2440587.5 is the Unix epoch
+    auto jdToString = [](double jd) {
+        qint64 msecs = qRound64((jd - 2440587.5) * 86400000.0);
+        return QDateTime::fromMSecsSinceEpoch(msecs, QTimeZone::UTC).toString("yyyy-MM-ddTHH:mm:ssZ");
+    };
+
+    QJsonArray array;
+    for (const TransitEvent &event : events) {
+        QJsonObject obj;
+        obj["transitPlanet"] = bodyName(event.transitBody);
+        obj["aspect"] = aspectCode(event.aspect);
+        obj["natalPlanet"] = bodyName(event.natalBody);
+        obj["start"] = jdToString(event.startJd);
+        obj["end"] = jdToString(event.endJd);
+        obj["minOrb"] = event.minOrb;
+        obj["startsBeforeRange"] = event.startsBeforeRange;
+        obj["endsAfterRange"] = event.endsAfterRange;
+
+        QJsonArray exact;
+        for (int i = 0; i < event.exactJds.size(); ++i) {
+            QJsonObject hit;
+            hit["time"] = jdToString(event.exactJds.at(i));
+            hit["retrograde"] = event.exactRetrograde.at(i);
+            exact.append(hit);
+        }
+        obj["exact"] = exact;
+        array.append(obj);
+    }
+    return array;
+}
+
+QFuture<void> ChartDataManager::streamTransitListAsync(const QDate &birthDate,
+                                                      const QTime &birthTime,
+                                                      const QString &utcOffset,
+                                                      const QString &latitude,
+                                                      const QString &longitude,
+                                                      const QString &houseSystem,
+                                                      const QDate &transitStartDate,
+                                                      int numberOfDays,
+                                                      const TransitChunkCallback &chunkReady)
+{
+    m_lastError.clear();
+    QPointer<ChartDataManager> owner(this);
+    // Settings are taken here, so changing them while the scan runs does
+    // not touch it
+    const CalculationOptions snapshot = options();
+    return ChartJobs::stream<TransitHit>(this, [=](const ProgressCallback &progress,
+                                                   const TransitChunkCallback &deliver) {
+        ChartDataManager worker;
+        worker.setOptions(snapshot);
+        worker.calculateTransitList(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                                    transitStartDate, numberOfDays, progress, deliver);
+        forwardJobError(owner, worker.getLastError());
+    }, chunkReady);
+}
+
+void ChartDataManager::forwardJobError(const QPointer<ChartDataManager> &owner, const QString &message)
+{
+    if (!owner || message.isEmpty() || message == QLatin1String("Calculation cancelled")) {
+        return;
+    }
+    // Dropped by Qt if the manager is deleted before the call runs
+    QMetaObject::invokeMethod(owner.data(), [owner, message]() {
+        owner->m_lastError = message;
+        emit owner->error(message);
+    }, Qt::QueuedConnection);
+}
+
+QFuture<QVector<TransitEvent>> ChartDataManager::calculateTransitEventsAsync(const QDate &birthDate,
+                                                                             const QTime &birthTime,
+                                                                             const QString &utcOffset,
+                                                                             const QString &latitude,
+                                                                             const QString &longitude,
+                                                                             const QString &houseSystem,
+                                                                             const QDate &transitStartDate,
+                                                                             int numberOfDays)
+{
+    return runAsync<QVector<TransitEvent>>([=](ChartDataManager &manager, const ProgressCallback &progress) {
+        return manager.calculateTransitEvents(birthDate, birthTime, utcOffset, latitude, longitude,
+                                              houseSystem, transitStartDate, numberOfDays, progress);
+    });
+}
+
+QFuture<QJsonArray> ChartDataManager::calculateEclipsesAsJsonAsync(const QDate &fromDate,
+                                                                  const QDate &toDate,
+                                                                  bool solarEclipses,
+                                                                  bool lunarEclipses)
+{
+    return runAsync<QJsonArray>([=](ChartDataManager &manager, const ProgressCallback &progress) {
+        return manager.calculateEclipsesAsJson(fromDate, toDate, solarEclipses, lunarEclipses,
+                                               progress);
+    });
+}
+
 QJsonArray ChartDataManager::calculateEclipsesAsJson(
     const QDate &fromDate,
     const QDate &toDate,
     bool solarEclipses,
-    bool lunarEclipses)
+    bool lunarEclipses,
+    const ProgressCallback &progress)
 {
     m_lastError.clear();
 
-    QVector<EclipseData> eclipses = m_calculator->findEclipses(fromDate, toDate, solarEclipses, lunarEclipses);
+    QByteArray inputs;
+    {
+        QDataStream out(&inputs, QIODevice::WriteOnly);
+        out << qint64(fromDate.toJulianDay()) << qint64(toDate.toJulianDay())
+            << solarEclipses << lunarEclipses;
+    }
+    QByteArray payload;
+    QJsonArray cached;
+    if (m_resultCache.load("eclipses", inputs, payload) && decodeArray(payload, cached)) {
+        return cached;
+    }
+
+    QVector<EclipseData> eclipses = m_calculator->findEclipses(fromDate, toDate, solarEclipses,
+                                                               lunarEclipses, progress);
 
     if (!m_calculator->getLastError().isEmpty()) {
         m_lastError = m_calculator->getLastError();
@@ -268,10 +765,11 @@ QJsonArray ChartDataManager::calculateEclipsesAsJson(
         obj["magnitude"] = eclipse.magnitude;
         eclipseArray.append(obj);
     }
+    m_resultCache.store("eclipses", inputs, encodeArray(eclipseArray));
     return eclipseArray;
 }
 
-QJsonObject ChartDataManager::calculateSolarReturnAsJson(
+ChartData ChartDataManager::calculateSolarReturn(
     const QDate &birthDate,
     const QTime &birthTime,
     const QString &utcOffset,
@@ -281,25 +779,16 @@ QJsonObject ChartDataManager::calculateSolarReturnAsJson(
 
     const int year)
 {
-    // Clear any previous error
-    m_lastError.clear();
-
-    // Call the solar return calculation
-    ChartData data = m_calculator->calculateSolarReturn(
-        birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, year
-        );
-
-    // If there was an error, return an error object
-    if (!m_calculator->getLastError().isEmpty()) {
-        m_lastError = m_calculator->getLastError();
-        return QJsonObject{{"error", m_lastError}};
-    }
-
-    // Convert the result to JSON
-    return chartDataToJson(data);
+    return cachedChart(
+        chartCacheKey(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                      int(Body::Sun), year),
+        [&]() {
+            return m_calculator->calculateSolarReturn(
+                birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem), year);
+        });
 }
 
-QJsonObject ChartDataManager::calculateLunarReturnAsJson(
+ChartData ChartDataManager::calculateLunarReturn(
     const QDate &birthDate,
     const QTime &birthTime,
     const QString &utcOffset,
@@ -309,25 +798,16 @@ QJsonObject ChartDataManager::calculateLunarReturnAsJson(
     const QDate &targetDate
     )
 {
-    // Clear any previous error
-    m_lastError.clear();
-
-    // Call the lunar return calculation
-    ChartData data = m_calculator->calculateLunarReturn(
-        birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, targetDate
-        );
-
-    // If there was an error, return an error object
-    if (!m_calculator->getLastError().isEmpty()) {
-        m_lastError = m_calculator->getLastError();
-        return QJsonObject{{"error", m_lastError}};
-    }
-
-    // Convert the result to JSON
-    return chartDataToJson(data);
+    return cachedChart(
+        chartCacheKey(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                      int(Body::Moon), targetDate.toJulianDay()),
+        [&]() {
+            return m_calculator->calculateLunarReturn(
+                birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem), targetDate);
+        });
 }
 
-QJsonObject ChartDataManager::calculateSaturnReturnAsJson(
+ChartData ChartDataManager::calculateSaturnReturn(
     const QDate &birthDate,
     const QTime &birthTime,
     const QString &utcOffset,
@@ -335,18 +815,18 @@ QJsonObject ChartDataManager::calculateSaturnReturnAsJson(
     const QString &longitude,
     const QString &houseSystem,
     int returnNumber
-    ) {
-    m_lastError.clear();
-    ChartData data = m_calculator->calculateSaturnReturn(
-        birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-        );
-    if (!m_lastError.isEmpty()) {
-        return QJsonObject();
-    }
-    return chartDataToJson(data);
+    )
+{
+    return cachedChart(
+        chartCacheKey(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                      int(Body::Saturn), returnNumber),
+        [&]() {
+            return m_calculator->calculateSaturnReturn(
+                birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem), returnNumber);
+        });
 }
 
-QJsonObject ChartDataManager::calculateJupiterReturnAsJson(
+ChartData ChartDataManager::calculateJupiterReturn(
     const QDate &birthDate,
     const QTime &birthTime,
     const QString &utcOffset,
@@ -354,18 +834,18 @@ QJsonObject ChartDataManager::calculateJupiterReturnAsJson(
     const QString &longitude,
     const QString &houseSystem,
     int returnNumber
-    ) {
-    m_lastError.clear();
-    ChartData data = m_calculator->calculateJupiterReturn(
-        birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-        );
-    if (!m_lastError.isEmpty()) {
-        return QJsonObject();
-    }
-    return chartDataToJson(data);
+    )
+{
+    return cachedChart(
+        chartCacheKey(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                      int(Body::Jupiter), returnNumber),
+        [&]() {
+            return m_calculator->calculateJupiterReturn(
+                birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem), returnNumber);
+        });
 }
 
-QJsonObject ChartDataManager::calculateVenusReturnAsJson(
+ChartData ChartDataManager::calculateVenusReturn(
     const QDate &birthDate,
     const QTime &birthTime,
     const QString &utcOffset,
@@ -374,20 +854,16 @@ QJsonObject ChartDataManager::calculateVenusReturnAsJson(
     const QString &houseSystem,
     int returnNumber)
 {
-    m_lastError.clear();
-
-    ChartData data = m_calculator->calculateVenusReturn(
-        birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-        );
-
-    if (!m_lastError.isEmpty()) {
-        return QJsonObject();
-    }
-
-    return chartDataToJson(data);
+    return cachedChart(
+        chartCacheKey(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                      int(Body::Venus), returnNumber),
+        [&]() {
+            return m_calculator->calculateVenusReturn(
+                birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem), returnNumber);
+        });
 }
 
-QJsonObject ChartDataManager::calculateMarsReturnAsJson(
+ChartData ChartDataManager::calculateMarsReturn(
     const QDate &birthDate,
     const QTime &birthTime,
     const QString &utcOffset,
@@ -396,20 +872,16 @@ QJsonObject ChartDataManager::calculateMarsReturnAsJson(
     const QString &houseSystem,
     int returnNumber)
 {
-    m_lastError.clear();
-
-    ChartData data = m_calculator->calculateMarsReturn(
-        birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-        );
-
-    if (!m_lastError.isEmpty()) {
-        return QJsonObject();
-    }
-
-    return chartDataToJson(data);
+    return cachedChart(
+        chartCacheKey(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                      int(Body::Mars), returnNumber),
+        [&]() {
+            return m_calculator->calculateMarsReturn(
+                birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem), returnNumber);
+        });
 }
 
-QJsonObject ChartDataManager::calculateMercuryReturnAsJson(
+ChartData ChartDataManager::calculateMercuryReturn(
     const QDate &birthDate,
     const QTime &birthTime,
     const QString &utcOffset,
@@ -418,53 +890,108 @@ QJsonObject ChartDataManager::calculateMercuryReturnAsJson(
     const QString &houseSystem,
     int returnNumber)
 {
-    m_lastError.clear();
-
-    ChartData data = m_calculator->calculateMercuryReturn(
-        birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-        );
+    return cachedChart(
+        chartCacheKey(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                      int(Body::Mercury), returnNumber),
+        [&]() {
+            return m_calculator->calculateMercuryReturn(
+                birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem), returnNumber);
+        });
+}
 
-    if (!m_lastError.isEmpty()) {
-        return QJsonObject();
-    }
+// Uranus Neptune Pluto
 
-    return chartDataToJson(data);
+ChartData ChartDataManager::calculateUranusReturn(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const QString &houseSystem, int returnNumber)
+{
+    return cachedChart(
+        chartCacheKey(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                      int(Body::Uranus), returnNumber),
+        [&]() {
+            return m_calculator->calculateUranusReturn(
+                birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem), returnNumber);
+        });
 }
 
-// Uranus Neptune Pluto
+ChartData ChartDataManager::calculateNeptuneReturn(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const QString &houseSystem, int returnNumber)
+{
+    return cachedChart(
+        chartCacheKey(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                      int(Body::Neptune), returnNumber),
+        [&]() {
+            return m_calculator->calculateNeptuneReturn(
+                birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem), returnNumber);
+        });
+}
 
-QJsonObject ChartDataManager::calculateUranusReturnAsJson(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const QString &houseSystem, int returnNumber)
+ChartData ChartDataManager::calculatePlutoReturn(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const QString &houseSystem, int returnNumber)
 {
-    m_lastError.clear();
-    ChartData data = m_calculator->calculateUranusReturn(
-        birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-        );
-    if (!m_lastError.isEmpty()) {
-        return QJsonObject();
-    }
-    return chartDataToJson(data);
+    return cachedChart(
+        chartCacheKey(birthDate, birthTime, utcOffset, latitude, longitude, houseSystem,
+                      int(Body::Pluto), returnNumber),
+        [&]() {
+            return m_calculator->calculatePlutoReturn(
+                birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem), returnNumber);
+        });
 }
 
-QJsonObject ChartDataManager::calculateNeptuneReturnAsJson(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const QString &houseSystem, int returnNumber)
+QVector<ChartData> ChartDataManager::calculateReturnSeries(Body body,
+                                                           const QDate &birthDate,
+                                                           const QTime &birthTime,
+                                                           const QString &utcOffset,
+                                                           const QString &latitude,
+                                                           const QString &longitude,
+                                                           const QString &houseSystem,
+                                                           const QDate &fromDate,
+                                                           const QDate &toDate)
 {
     m_lastError.clear();
-    ChartData data = m_calculator->calculateNeptuneReturn(
-        birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-        );
-    if (!m_lastError.isEmpty()) {
-        return QJsonObject();
+
+    QVector<ChartData> charts = m_calculator->calculateReturnSeries(
+        body, birthDate, birthTime, utcOffset, latitude, longitude, optionsFor(houseSystem),
+        fromDate, toDate);
+
+    if (!m_calculator->getLastError().isEmpty()) {
+        m_lastError = m_calculator->getLastError();
     }
-    return chartDataToJson(data);
+
+    return charts;
 }
 
-QJsonObject ChartDataManager::calculatePlutoReturnAsJson(const QDate &birthDate, const QTime &birthTime, const QString &utcOffset, const QString &latitude, const QString &longitude, const QString &houseSystem, int returnNumber)
+QJsonArray ChartDataManager::calculateReturnSeriesAsJson(Body body,
+                                                         const QDate &birthDate,
+                                                         const QTime &birthTime,
+                                                         const QString &utcOffset,
+                                                         const QString &latitude,
+                                                         const QString &longitude,
+                                                         const QString &houseSystem,
+                                                         const QDate &fromDate,
+                                                         const QDate &toDate)
 {
     m_lastError.clear();
-    ChartData data = m_calculator->calculatePlutoReturn(
-        birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-        );
-    if (!m_lastError.isEmpty()) {
-        return QJsonObject();
+
+    QByteArray inputs;
+    {
+        QDataStream out(&inputs, QIODevice::WriteOnly);
+        out << qint32(body) << m_calculator->julianDay(birthDate, birthTime, utcOffset) << utcOffset
+            << latitude.toDouble() << longitude.toDouble()
+            << qint64(fromDate.toJulianDay()) << qint64(toDate.toJulianDay());
+        writeOptions(out, optionsFor(houseSystem));
+    }
+    QByteArray payload;
+    QJsonArray array;
+    if (m_resultCache.load("returns", inputs, payload) && decodeArray(payload, array)) {
+        return array;
+    }
+
+    QVector<ChartData> charts = calculateReturnSeries(body, birthDate, birthTime, utcOffset,
+                                                      latitude, longitude, houseSystem,
+                                                      fromDate, toDate);
+
+    for (const ChartData &data : charts) {
+        array.append(chartDataToJson(data));
+    }
+    if (m_lastError.isEmpty()) {
+        m_resultCache.store("returns", inputs, encodeArray(array));
     }
-    return chartDataToJson(data);
+    return array;
 }
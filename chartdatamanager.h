@@ -7,7 +7,13 @@
 #include <QString>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QPointer>
+#include <QCache>
+#include <optional>
 #include "chartcalculator.h"
+#include "chartpipeline.h"
+#include "chartjobs.h"
+#include "resultcache.h"
 
 class ChartDataManager : public QObject
 {
@@ -22,27 +28,84 @@ public:
     // Check if the calculator is available
     bool isCalculatorAvailable() const;
 
+    // Settings the calculations run with (orbs, body set, flags). Until
+    // setOptions() is called every call takes a fresh snapshot of the app
+    // settings; the house system always comes from the call's argument.
+    void setOptions(const CalculationOptions &options);
+    CalculationOptions options() const;
+
+    // Charts from calculateChart and the returns are kept in an LRU cache,
+    // keyed by the birth moment, place, return and options, so going back to
+    // a recent chart costs a lookup. The budget is an estimate of the bytes
+    // held; the least recently used charts are dropped to stay under it.
+    struct ChartCacheStats {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        int charts = 0;
+        qint64 bytes = 0;
+        qint64 budget = 0;
+    };
+
+    void setChartCacheBudget(qint64 bytes);
+    ChartCacheStats chartCacheStats() const;
+    void clearChartCache();
+
+    // Return series, eclipse lists and transit scans are also kept on disk
+    // between sessions (see ResultCache)
+    ResultCache &resultCache() { return m_resultCache; }
+
     // Calculate chart and return structured data
     ChartData calculateChart(const QDate &birthDate,
                              const QTime &birthTime,
                              const QString &utcOffset,
                              const QString &latitude,
                              const QString &longitude,
-                             const QString &houseSystem = "Placidus",
-                             double orbMax = 8.0);
+                             const QString &houseSystem = "Placidus");
 
-    // Calculate chart and return JSON data
-    QJsonObject calculateChartAsJson(const QDate &birthDate,
-                                     const QTime &birthTime,
-                                     const QString &utcOffset,
-                                     const QString &latitude,
-                                     const QString &longitude,
-                                     const QString &houseSystem = "Placidus",
-                                     double orbMax = 8.0);
+    // Calculate a batch of charts in parallel, results in request order
+    QVector<ChartData> calculateCharts(const QVector<ChartRequest> &requests);
+
+    // Same batch held as CompactChart, for large in-memory sets
+    QVector<CompactChart> calculateCompactCharts(const QVector<ChartRequest> &requests);
 
     // Convert ChartData to JSON
     QJsonObject chartDataToJson(const ChartData &data);
 
+    // Run any manager operation as a background job. The job gets its own
+    // manager on the worker thread, so this one stays free for the UI. The
+    // worker runs with this manager's options() as they were at the start.
+    // Errors other than cancellation set getLastError() and emit error() on
+    // this object's thread once the job is done.
+    template<typename T>
+    QFuture<T> runAsync(std::function<T(ChartDataManager &manager, const ProgressCallback &progress)> job);
+
+    // The transit scan as a stream: hits are passed to chunkReady on this
+    // manager's thread in date order, a block of days at a time. The future
+    // carries progress and cancellation only, so any range length works.
+    QFuture<void> streamTransitListAsync(const QDate &birthDate,
+                                         const QTime &birthTime,
+                                         const QString &utcOffset,
+                                         const QString &latitude,
+                                         const QString &longitude,
+                                         const QString &houseSystem,
+                                         const QDate &transitStartDate,
+                                         int numberOfDays,
+                                         const TransitChunkCallback &chunkReady);
+
+    QFuture<QVector<TransitEvent>> calculateTransitEventsAsync(const QDate &birthDate,
+                                                               const QTime &birthTime,
+                                                               const QString &utcOffset,
+                                                               const QString &latitude,
+                                                               const QString &longitude,
+                                                               const QString &houseSystem,
+                                                               const QDate &transitStartDate,
+                                                               int numberOfDays);
+
+    QFuture<QJsonArray> calculateEclipsesAsJsonAsync(const QDate &fromDate,
+                                                     const QDate &toDate,
+                                                     bool solarEclipses,
+                                                     bool lunarEclipses);
+
     // Get the last error message
     QString getLastError() const;
 
@@ -53,8 +116,52 @@ private:
     QJsonArray anglesToJson(const QVector<AngleData> &angles);
     QJsonArray aspectsToJson(const QVector<AspectData> &aspects);
 
+    // Hand a background job's error to the manager that started it
+    static void forwardJobError(const QPointer<ChartDataManager> &owner, const QString &message);
+
+    // options() with the given house system
+    CalculationOptions optionsFor(const QString &houseSystem) const;
+
+    // What a cached chart was computed from. kind is -1 for a chart at the
+    // birth moment and the returning Body for returns; detail is the return
+    // year, number or target day.
+    struct ChartCacheKey {
+        double jd = 0.0;
+        QString utcOffset;
+        double latitude = 0.0;
+        double longitude = 0.0;
+        int kind = -1;
+        qint64 detail = 0;
+        CalculationOptions options;
+
+        bool operator==(const ChartCacheKey &other) const;
+        friend size_t qHash(const ChartCacheKey &key, size_t seed = 0)
+        {
+            seed = qHashMulti(seed, key.jd, key.utcOffset, key.latitude, key.longitude,
+                              key.kind, key.detail);
+            return qHash(key.options, seed);
+        }
+    };
+
+    ChartCacheKey chartCacheKey(const QDate &birthDate, const QTime &birthTime,
+                                const QString &utcOffset, const QString &latitude,
+                                const QString &longitude, const QString &houseSystem,
+                                int kind = -1, qint64 detail = 0) const;
+
+    // The cached chart for key, or compute() stored under it on a miss.
+    // Failed calculations set m_lastError and are not stored.
+    ChartData cachedChart(const ChartCacheKey &key, const std::function<ChartData()> &compute);
+
+    static qint64 estimatedBytes(const ChartData &data);
+
     ChartCalculator *m_calculator;
+    ChartPipeline m_pipeline;   // Reuses unchanged stages between calculateChart calls
     QString m_lastError;
+    std::optional<CalculationOptions> m_options;
+    QCache<ChartCacheKey, ChartData> m_chartCache;
+    qint64 m_chartCacheHits = 0;
+    qint64 m_chartCacheMisses = 0;
+    ResultCache &m_resultCache;   // ResultCache::shared()
 
 signals:
     void error(const QString &errorMessage);
@@ -65,115 +172,211 @@ public:
                               const QString &utcOffset,
                               const QString &latitude,
                               const QString &longitude,
+                              const QString &houseSystem,
                               const QDate &transitStartDate,
                               int numberOfDays);
 
+    QVector<TransitHit> calculateTransitList(const QDate &birthDate,
+                                             const QTime &birthTime,
+                                             const QString &utcOffset,
+                                             const QString &latitude,
+                                             const QString &longitude,
+                                             const QString &houseSystem,
+                                             const QDate &transitStartDate,
+                                             int numberOfDays,
+                                             const ProgressCallback &progress = nullptr,
+                                             const TransitChunkCallback &chunkReady = nullptr);
+
+    // Memoized natal chart for the birth data; see ChartCalculator::natalChart
+    NatalChartHandle natalChart(const QDate &birthDate,
+                                const QTime &birthTime,
+                                const QString &utcOffset,
+                                const QString &latitude,
+                                const QString &longitude,
+                                const QString &houseSystem);
+
+    QVector<TransitHit> calculateTransitList(const NatalChart &natal,
+                                             const QDate &transitStartDate,
+                                             int numberOfDays,
+                                             const ProgressCallback &progress = nullptr,
+                                             const TransitChunkCallback &chunkReady = nullptr);
+
+    // JSON for the AI prompt, with the hits formatted as "rawTransitData"
+    QJsonObject transitListToJson(const QVector<TransitHit> &hits,
+                                  const QDate &birthDate,
+                                  const QTime &birthTime,
+                                  const QString &latitude,
+                                  const QString &longitude,
+                                  const QDate &transitStartDate,
+                                  int numberOfDays);
+
     QJsonObject calculateTransitsAsJson(const QDate &birthDate,
                                         const QTime &birthTime,
                                         const QString &utcOffset,
                                         const QString &latitude,
                                         const QString &longitude,
+                                        const QString &houseSystem,
                                         const QDate &transitStartDate,
                                         int numberOfDays);
 
+    // Transit aspect windows with exact times (see TransitEngine)
+    QVector<TransitEvent> calculateTransitEvents(const QDate &birthDate,
+                                                 const QTime &birthTime,
+                                                 const QString &utcOffset,
+                                                 const QString &latitude,
+                                                 const QString &longitude,
+                                                 const QString &houseSystem,
+                                                 const QDate &transitStartDate,
+                                                 int numberOfDays,
+                                                 const ProgressCallback &progress = nullptr);
+
+    QJsonObject calculateTransitEventsAsJson(const QDate &birthDate,
+                                             const QTime &birthTime,
+                                             const QString &utcOffset,
+                                             const QString &latitude,
+                                             const QString &longitude,
+                                             const QString &houseSystem,
+                                             const QDate &transitStartDate,
+                                             int numberOfDays);
+
+    QJsonArray transitEventsToJson(const QVector<TransitEvent> &events);
+
+    // Prompt data for interpretTransits: the birth data, the events as an
+    // array and as the compact text report in "rawTransitData"
+    QJsonObject transitEventListToJson(const QVector<TransitEvent> &events,
+                                       const QDate &birthDate,
+                                       const QTime &birthTime,
+                                       const QString &latitude,
+                                       const QString &longitude,
+                                       const QDate &transitStartDate,
+                                       int numberOfDays);
+
     QJsonArray calculateEclipsesAsJson(
         const QDate &fromDate,
         const QDate &toDate,
         bool solarEclipses,
-        bool lunarEclipses);
+        bool lunarEclipses,
+        const ProgressCallback &progress = nullptr);
 
-    QJsonObject calculateSolarReturnAsJson(const QDate &birthDate,
+    // Return charts for display. Each one goes through the chart cache;
+    // chartDataToJson() gives the form used for saving and the AI prompt.
+    ChartData calculateSolarReturn(const QDate &birthDate,
+                                   const QTime &birthTime,
+                                   const QString &utcOffset,
+                                   const QString &latitude,
+                                   const QString &longitude,
+                                   const QString &houseSystem,
+                                   int year);
+
+    ChartData calculateLunarReturn(const QDate &birthDate,
+                                   const QTime &birthTime,
+                                   const QString &utcOffset,
+                                   const QString &latitude,
+                                   const QString &longitude,
+                                   const QString &houseSystem,
+                                   const QDate &targetDate);
+
+    ChartData calculateSaturnReturn(const QDate &birthDate,
+                                    const QTime &birthTime,
+                                    const QString &utcOffset,
+                                    const QString &latitude,
+                                    const QString &longitude,
+                                    const QString &houseSystem,
+                                    int returnNumber);
+
+    ChartData calculateJupiterReturn(const QDate &birthDate,
+                                     const QTime &birthTime,
+                                     const QString &utcOffset,
+                                     const QString &latitude,
+                                     const QString &longitude,
+                                     const QString &houseSystem,
+                                     int returnNumber);
+
+    ChartData calculateVenusReturn(const QDate &birthDate,
+                                   const QTime &birthTime,
+                                   const QString &utcOffset,
+                                   const QString &latitude,
+                                   const QString &longitude,
+                                   const QString &houseSystem,
+                                   int returnNumber);
+
+    ChartData calculateMarsReturn(const QDate &birthDate,
+                                  const QTime &birthTime,
+                                  const QString &utcOffset,
+                                  const QString &latitude,
+                                  const QString &longitude,
+                                  const QString &houseSystem,
+                                  int returnNumber);
+
+    ChartData calculateMercuryReturn(const QDate &birthDate,
+                                     const QTime &birthTime,
+                                     const QString &utcOffset,
+                                     const QString &latitude,
+                                     const QString &longitude,
+                                     const QString &houseSystem,
+                                     int returnNumber);
+
+    ChartData calculateUranusReturn(const QDate &birthDate,
+                                    const QTime &birthTime,
+                                    const QString &utcOffset,
+                                    const QString &latitude,
+                                    const QString &longitude,
+                                    const QString &houseSystem,
+                                    int returnNumber);
+
+    ChartData calculateNeptuneReturn(const QDate &birthDate,
+                                     const QTime &birthTime,
+                                     const QString &utcOffset,
+                                     const QString &latitude,
+                                     const QString &longitude,
+                                     const QString &houseSystem,
+                                     int returnNumber);
+
+    ChartData calculatePlutoReturn(const QDate &birthDate,
+                                   const QTime &birthTime,
+                                   const QString &utcOffset,
+                                   const QString &latitude,
+                                   const QString &longitude,
+                                   const QString &houseSystem,
+                                   int returnNumber);
+
+    // All returns of a body in a date range (e.g. a lifetime of Saturn returns)
+    QVector<ChartData> calculateReturnSeries(Body body,
+                                             const QDate &birthDate,
+                                             const QTime &birthTime,
+                                             const QString &utcOffset,
+                                             const QString &latitude,
+                                             const QString &longitude,
+                                             const QString &houseSystem,
+                                             const QDate &fromDate,
+                                             const QDate &toDate);
+
+    QJsonArray calculateReturnSeriesAsJson(Body body,
+                                           const QDate &birthDate,
                                            const QTime &birthTime,
                                            const QString &utcOffset,
                                            const QString &latitude,
                                            const QString &longitude,
                                            const QString &houseSystem,
-
-                                           const int year);
-
-    QJsonObject calculateLunarReturnAsJson(
-        const QDate &birthDate,
-        const QTime &birthTime,
-        const QString &utcOffset,
-        const QString &latitude,
-        const QString &longitude,
-        const QString &houseSystem,
-        const QDate &targetDate
-        );
-
-    QJsonObject calculateSaturnReturnAsJson(
-        const QDate &birthDate,
-        const QTime &birthTime,
-        const QString &utcOffset,
-        const QString &latitude,
-        const QString &longitude,
-        const QString &houseSystem,
-        int returnNumber
-        );
-    QJsonObject calculateJupiterReturnAsJson(
-        const QDate &birthDate,
-        const QTime &birthTime,
-        const QString &utcOffset,
-        const QString &latitude,
-        const QString &longitude,
-        const QString &houseSystem,
-        int returnNumber
-        );
-
-    QJsonObject calculateVenusReturnAsJson(
-        const QDate &birthDate,
-        const QTime &birthTime,
-        const QString &utcOffset,
-        const QString &latitude,
-        const QString &longitude,
-        const QString &houseSystem,
-        int returnNumber);
-
-    QJsonObject calculateMarsReturnAsJson(
-        const QDate &birthDate,
-        const QTime &birthTime,
-        const QString &utcOffset,
-        const QString &latitude,
-        const QString &longitude,
-        const QString &houseSystem,
-        int returnNumber);
-
-    QJsonObject calculateMercuryReturnAsJson(
-        const QDate &birthDate,
-        const QTime &birthTime,
-        const QString &utcOffset,
-        const QString &latitude,
-        const QString &longitude,
-        const QString &houseSystem,
-        int returnNumber);
-
-    QJsonObject calculateUranusReturnAsJson(
-        const QDate &birthDate,
-        const QTime &birthTime,
-        const QString &utcOffset,
-        const QString &latitude,
-        const QString &longitude,
-        const QString &houseSystem,
-        int returnNumber);
-
-    QJsonObject calculateNeptuneReturnAsJson(
-        const QDate &birthDate,
-        const QTime &birthTime,
-        const QString &utcOffset,
-        const QString &latitude,
-        const QString &longitude,
-        const QString &houseSystem,
-        int returnNumber);
-
-    QJsonObject calculatePlutoReturnAsJson(
-        const QDate &birthDate,
-        const QTime &birthTime,
-        const QString &utcOffset,
-        const QString &latitude,
-        const QString &longitude,
-        const QString &houseSystem,
-        int returnNumber);
+                                           const QDate &fromDate,
+                                           const QDate &toDate);
 
 };
 
+template<typename T>
+QFuture<T> ChartDataManager::runAsync(std::function<T(ChartDataManager &manager, const ProgressCallback &progress)> job)
+{
+    m_lastError.clear();
+    QPointer<ChartDataManager> owner(this);
+    const CalculationOptions snapshot = options();
+    return ChartJobs::run<T>([owner, job, snapshot](const ProgressCallback &progress) {
+        ChartDataManager worker;
+        worker.setOptions(snapshot);
+        T result = job(worker, progress);
+
+        forwardJobError(owner, worker.getLastError());
+        return result;
+    });
+}
+
 #endif // CHARTDATAMANAGER_H
@@ -0,0 +1,95 @@
+#ifndef CHARTJOBS_H
+#define CHARTJOBS_H
+
+#include <QFuture>
+#include <QPointer>
+#include <QPromise>
+#include <QThreadPool>
+#include <memory>
+#include "chartcalculator.h"
+#include "ephemeriscontext.h"
+
+// Background jobs on the ephemeris pool. A job runs on a worker thread and
+// delivers its result through a QFuture; watch it with a QFutureWatcher to
+// get progressValueChanged() and finished() on the UI thread. Cancelling the
+// future is the cancellation token: the job's progress hook starts returning
+// false and no result is reported.
+class ChartJobs
+{
+public:
+    // Runs work(progress) -> T on the pool. The hook forwards (done, total)
+    // to the future's progress range and value.
+    template<typename T, typename Work>
+    static QFuture<T> run(Work work)
+    {
+        auto promise = std::make_shared<QPromise<T>>();
+        QFuture<T> future = promise->future();
+        promise->start();
+
+        EphemerisPool::threadPool()->start([promise, work]() mutable {
+            if (promise->isCanceled()) {
+                promise->finish();
+                return;
+            }
+
+            ProgressCallback progress = [&promise](int done, int total) {
+                if (promise->future().progressMaximum() != total) {
+                    promise->setProgressRange(0, total);
+                }
+                promise->setProgressValue(done);
+                return !promise->isCanceled();
+            };
+
+            T result = work(progress);
+            if (!promise->isCanceled()) {
+                promise->addResult(std::move(result));
+            }
+            promise->finish();
+        });
+
+        return future;
+    }
+
+    // Runs work(progress, deliver) on the pool, where deliver(chunk) passes
+    // a block of results to sink(chunk) on receiver's thread as soon as it is
+    // ready. Chunks arrive in order and before the future reports finished.
+    // They are not kept in the future, so a long scan holds no more than the
+    // chunks in flight.
+    template<typename T, typename Work, typename Sink>
+    static QFuture<void> stream(QObject *receiver, Work work, Sink sink)
+    {
+        auto promise = std::make_shared<QPromise<void>>();
+        QFuture<void> future = promise->future();
+        promise->start();
+        QPointer<QObject> target(receiver);
+
+        EphemerisPool::threadPool()->start([promise, work, target, sink]() mutable {
+            if (promise->isCanceled()) {
+                promise->finish();
+                return;
+            }
+
+            ProgressCallback progress = [&promise](int done, int total) {
+                if (promise->future().progressMaximum() != total) {
+                    promise->setProgressRange(0, total);
+                }
+                promise->setProgressValue(done);
+                return !promise->isCanceled();
+            };
+            auto deliver = [&promise, &target, &sink](const QVector<T> &chunk) {
+                if (!chunk.isEmpty() && !promise->isCanceled() && target) {
+                    QMetaObject::invokeMethod(target.data(), [sink, chunk]() {
+                        sink(chunk);
+                    }, Qt::QueuedConnection);
+                }
+            };
+
+            work(progress, deliver);
+            promise->finish();
+        });
+
+        return future;
+    }
+};
+
+#endif // CHARTJOBS_H
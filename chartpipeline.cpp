@@ -0,0 +1,86 @@
+#include "chartpipeline.h"
+#include "ephemeriscontext.h"
+#include <QDateTime>
+
+ChartPipeline::ChartPipeline(ChartCalculator *calculator)
+    : m_calculator(calculator)
+{
+}
+
+void ChartPipeline::invalidate()
+{
+    m_hasPositions = false;
+    m_hasFrame = false;
+    m_hasPlanets = false;
+    m_hasAspects = false;
+}
+
+ChartData ChartPipeline::calculate(const QDate &birthDate,
+                                   const QTime &birthTime,
+                                   const QString &utcOffset,
+                                   const QString &latitude,
+                                   const QString &longitude,
+                                   const CalculationOptions &options)
+{
+    ChartData data;
+    m_calculator->m_lastError.clear();
+    if (!m_calculator->m_isInitialized) {
+        m_calculator->m_lastError = "Swiss Ephemeris not initialized";
+        return data;
+    }
+    EphemerisContext::Lease lease;
+
+    double jd = m_calculator->dateTimeToJulianDay(QDateTime(birthDate, birthTime), utcOffset);
+    double lat = latitude.toDouble();
+    double lon = longitude.toDouble();
+    const QString &houseSystem = options.houseSystem;
+
+    bool placementStale = !m_hasPlanets;
+
+    if (!m_hasPositions || m_positionsJd != jd) {
+        m_positions = m_calculator->calculateBodyPositions(jd, true);
+        m_positionsJd = jd;
+        m_hasPositions = true;
+        placementStale = true;
+        ++m_stats.positions;
+    }
+
+    if (!m_hasFrame || m_frameJd != jd || m_frameLat != lat || m_frameLon != lon
+            || m_frameSystem != houseSystem) {
+        m_frame = m_calculator->calculateHouseFrame(jd, lat, lon, houseSystem);
+        m_frameJd = jd;
+        m_frameLat = lat;
+        m_frameLon = lon;
+        m_frameSystem = houseSystem;
+        m_hasFrame = true;
+        placementStale = true;
+        ++m_stats.houses;
+    }
+
+    if (placementStale) {
+        m_planets = m_calculator->placeBodies(m_positions, m_frame);
+        m_hasPlanets = true;
+        ++m_stats.placements;
+    }
+
+    // A new house system moves no body, so the aspects usually survive it
+    QVector<double> longitudes;
+    longitudes.reserve(m_planets.size());
+    for (const PlanetData &planet : m_planets) {
+        longitudes.append(planet.longitude);
+    }
+    const AspectOrbTable &orbs = options.orbs;
+    if (!m_hasAspects || m_aspectLongitudes != longitudes || m_aspectOrbs != orbs) {
+        m_aspects = m_calculator->calculateAspects(m_planets, orbs);
+        m_aspectLongitudes = longitudes;
+        m_aspectOrbs = orbs;
+        m_hasAspects = true;
+        ++m_stats.aspects;
+    }
+
+    data.planets = m_planets;
+    data.houses = m_frame.houses;
+    data.angles = m_frame.angles;
+    data.aspects = m_aspects;
+    return data;
+}
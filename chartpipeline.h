@@ -0,0 +1,70 @@
+#ifndef CHARTPIPELINE_H
+#define CHARTPIPELINE_H
+
+#include "chartcalculator.h"
+
+// Incremental chart calculation for interactive use. A chart is split into
+// stages with explicit inputs, and each stage keeps its last result together
+// with the inputs it was computed from:
+//
+//   positions  <- JD                           (ephemeris calls)
+//   houses     <- JD, latitude, longitude, system  (one swe_houses_ex call)
+//   placement  <- positions, houses            (house of each body, Lots,
+//                                               Vertex, East Point)
+//   aspects    <- placed longitudes, orb table
+//
+// Only stages whose inputs changed rerun. Moving the location or switching
+// the house system reuses the positions; changing orbs only reruns aspects.
+// Not thread safe; use one pipeline per thread like ChartCalculator.
+class ChartPipeline
+{
+public:
+    // Stage runs since construction, for profiling
+    struct Stats {
+        int positions = 0;
+        int houses = 0;
+        int placements = 0;
+        int aspects = 0;
+    };
+
+    explicit ChartPipeline(ChartCalculator *calculator);
+
+    // Same result as ChartCalculator::calculateChart. Errors are reported
+    // through the calculator's getLastError().
+    ChartData calculate(const QDate &birthDate,
+                        const QTime &birthTime,
+                        const QString &utcOffset,
+                        const QString &latitude,
+                        const QString &longitude,
+                        const CalculationOptions &options);
+
+    // Drop every cached stage, e.g. after the ephemeris files changed
+    void invalidate();
+
+    const Stats &stats() const { return m_stats; }
+
+private:
+    ChartCalculator *m_calculator;
+    Stats m_stats;
+
+    bool m_hasPositions = false;
+    double m_positionsJd = 0.0;
+    ChartCalculator::BodyPositions m_positions;
+
+    bool m_hasFrame = false;
+    double m_frameJd = 0.0;
+    double m_frameLat = 0.0;
+    double m_frameLon = 0.0;
+    QString m_frameSystem;
+    ChartCalculator::HouseFrame m_frame;
+
+    bool m_hasPlanets = false;
+    QVector<PlanetData> m_planets;
+
+    bool m_hasAspects = false;
+    QVector<double> m_aspectLongitudes;
+    AspectOrbTable m_aspectOrbs;
+    QVector<AspectData> m_aspects;
+};
+
+#endif // CHARTPIPELINE_H
@@ -0,0 +1,138 @@
+#include "compactchart.h"
+#include "chartcalculator.h"
+
+namespace {
+
+template<typename T>
+qsizetype storageOf(const QVector<T> &values)
+{
+    return values.capacity() * qsizetype(sizeof(T));
+}
+
+}
+
+CompactChart CompactChart::fromChartData(const ChartData &chart)
+{
+    CompactChart compact;
+
+    const int planetCount = chart.planets.size();
+    compact.bodies.reserve(planetCount);
+    compact.longitudes.reserve(planetCount);
+    compact.latitudes.reserve(planetCount);
+    compact.houses.reserve(planetCount);
+    compact.retrograde.reserve(planetCount);
+    for (const PlanetData &planet : chart.planets) {
+        Body body;
+        if (!bodyFromName(planet.id, &body)) {
+            continue;
+        }
+        compact.bodies.append(body);
+        compact.longitudes.append(planet.longitude);
+        compact.latitudes.append(planet.latitude);
+        // "House7" -> 7
+        compact.houses.append(quint8(planet.house.mid(5).toInt()));
+        compact.retrograde.append(planet.isRetrograde);
+    }
+
+    compact.cusps.reserve(chart.houses.size());
+    for (const HouseData &house : chart.houses) {
+        compact.cusps.append(house.longitude);
+    }
+
+    // The calculator always lists the angles as Asc, MC, Desc, IC
+    compact.angles.reserve(chart.angles.size());
+    for (const AngleData &angle : chart.angles) {
+        compact.angles.append(angle.longitude);
+    }
+
+    const int aspectCount = chart.aspects.size();
+    compact.aspectFirst.reserve(aspectCount);
+    compact.aspectSecond.reserve(aspectCount);
+    compact.aspectKinds.reserve(aspectCount);
+    compact.aspectOrbs.reserve(aspectCount);
+    for (const AspectData &aspect : chart.aspects) {
+        Body first;
+        Body second;
+        AspectKind kind;
+        if (!bodyFromName(aspect.planet1, &first) || !bodyFromName(aspect.planet2, &second)
+                || !aspectFromCode(aspect.aspectType, &kind)) {
+            continue;
+        }
+        const int firstIndex = compact.indexOf(first);
+        const int secondIndex = compact.indexOf(second);
+        if (firstIndex < 0 || secondIndex < 0) {
+            continue;
+        }
+        compact.aspectFirst.append(quint8(firstIndex));
+        compact.aspectSecond.append(quint8(secondIndex));
+        compact.aspectKinds.append(kind);
+        compact.aspectOrbs.append(aspect.orb);
+    }
+
+    compact.returnDate = chart.returnDate;
+    compact.returnTime = chart.returnTime;
+    compact.returnJulianDay = chart.returnJulianDay;
+    return compact;
+}
+
+ChartData CompactChart::toChartData() const
+{
+    ChartData chart;
+
+    chart.planets.reserve(planetCount());
+    for (int i = 0; i < planetCount(); ++i) {
+        PlanetData planet;
+        planet.id = bodyName(bodies[i]);
+        planet.sign = formatSignPosition(longitudes[i]);
+        planet.longitude = longitudes[i];
+        planet.latitude = latitudes[i];
+        if (houses[i] > 0) {
+            planet.house = QString("House%1").arg(int(houses[i]));
+        }
+        planet.isRetrograde = retrograde[i];
+        chart.planets.append(planet);
+    }
+
+    chart.houses.reserve(cusps.size());
+    for (int i = 0; i < cusps.size(); ++i) {
+        HouseData house;
+        house.id = QString("House%1").arg(i + 1);
+        house.sign = formatSignPosition(cusps[i]);
+        house.longitude = cusps[i];
+        chart.houses.append(house);
+    }
+
+    chart.angles.reserve(angles.size());
+    for (int i = 0; i < angles.size(); ++i) {
+        AngleData angle;
+        angle.id = bodyName(Body(int(Body::Asc) + i));
+        angle.sign = formatSignPosition(angles[i]);
+        angle.longitude = angles[i];
+        chart.angles.append(angle);
+    }
+
+    chart.aspects.reserve(aspectCount());
+    for (int i = 0; i < aspectCount(); ++i) {
+        AspectData aspect;
+        aspect.planet1 = bodyName(bodies[aspectFirst[i]]);
+        aspect.planet2 = bodyName(bodies[aspectSecond[i]]);
+        aspect.aspectType = aspectCode(aspectKinds[i]);
+        aspect.orb = aspectOrbs[i];
+        chart.aspects.append(aspect);
+    }
+
+    chart.returnDate = returnDate;
+    chart.returnTime = returnTime;
+    chart.returnJulianDay = returnJulianDay;
+    return chart;
+}
+
+qsizetype CompactChart::memoryUsage() const
+{
+    return qsizetype(sizeof(CompactChart))
+            + storageOf(bodies) + storageOf(longitudes) + storageOf(latitudes)
+            + storageOf(houses) + storageOf(retrograde)
+            + storageOf(cusps) + storageOf(angles)
+            + storageOf(aspectFirst) + storageOf(aspectSecond)
+            + storageOf(aspectKinds) + storageOf(aspectOrbs);
+}
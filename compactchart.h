@@ -0,0 +1,52 @@
+#ifndef COMPACTCHART_H
+#define COMPACTCHART_H
+
+#include <QDate>
+#include <QTime>
+#include <QVector>
+#include "astrotypes.h"
+
+struct ChartData;
+
+// A chart held as enums and flat arrays instead of the string-keyed
+// PlanetData/HouseData/AngleData/AspectData records. Meant for keeping large
+// numbers of charts in memory; sign and house labels are produced only when
+// the chart is converted back with toChartData() at the UI edge.
+struct CompactChart {
+    // Planets and points, in calculation order
+    QVector<Body> bodies;
+    QVector<double> longitudes;
+    QVector<double> latitudes;
+    QVector<quint8> houses;         // 1-12, 0 if the chart has no cusps
+    QVector<bool> retrograde;
+
+    // House cusps 1-12 and the angles Asc, MC, Desc, IC
+    QVector<double> cusps;
+    QVector<double> angles;
+
+    // Aspects; first/second index the planet arrays
+    QVector<quint8> aspectFirst;
+    QVector<quint8> aspectSecond;
+    QVector<AspectKind> aspectKinds;
+    QVector<double> aspectOrbs;
+
+    QDate returnDate;
+    QTime returnTime;
+    double returnJulianDay = 0.0;
+
+    int planetCount() const { return bodies.size(); }
+    int aspectCount() const { return aspectKinds.size(); }
+
+    // Index of a body in the planet arrays, or -1
+    int indexOf(Body body) const { return bodies.indexOf(body); }
+
+    Sign sign(int planet) const { return signOf(longitudes[planet]); }
+
+    static CompactChart fromChartData(const ChartData &chart);
+    ChartData toChartData() const;
+
+    // Bytes held by the chart, including array storage
+    qsizetype memoryUsage() const;
+};
+
+#endif // COMPACTCHART_H
@@ -0,0 +1,130 @@
+#include "crossingsolver.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Near +/-180 the normalized difference wraps, which is not a crossing
+const double kTrackingLimit = 90.0;
+
+// Strides only cover this share of the distance the angle could travel
+const double kStrideSafety = 0.9;
+
+// About 0.01 s, or 1e-7 degrees of residual
+const double kTimeTolerance = 1e-7;
+const double kResidualTolerance = 1e-7;
+const int kMaxIterations = 50;
+
+}
+
+CrossingSolver::CrossingSolver(Evaluator evaluate, double maxRate, double minStep)
+    : m_evaluate(std::move(evaluate))
+    , m_maxRate(maxRate)
+    , m_minStep(minStep)
+{
+}
+
+double CrossingSolver::normalize180(double angle)
+{
+    angle = fmod(angle, 360.0);
+    if (angle > 180.0) angle -= 360.0;
+    else if (angle <= -180.0) angle += 360.0;
+    return angle;
+}
+
+bool CrossingSolver::evaluate(double jd, double target, double offset, double &f, double &rate) const
+{
+    ++m_evaluations;
+    double angle = 0.0;
+    if (!m_evaluate(jd, angle, rate)) {
+        return false;
+    }
+    f = normalize180(angle - target) - offset;
+    return true;
+}
+
+Crossing CrossingSolver::refine(double target, double offset,
+                                double ta, double fa, double ra,
+                                double tb, double fb, double rb) const
+{
+    if (fa == 0.0) return {ta, ra};
+    if (fb == 0.0) return {tb, rb};
+
+    // Orient the bracket so that f(lo) < 0 < f(hi)
+    double lo = fa < 0.0 ? ta : tb;
+    double hi = fa < 0.0 ? tb : ta;
+
+    // Start from the end closer to the root
+    double t = fabs(fa) < fabs(fb) ? ta : tb;
+    double f = fabs(fa) < fabs(fb) ? fa : fb;
+    double rate = fabs(fa) < fabs(fb) ? ra : rb;
+
+    for (int i = 0; i < kMaxIterations; ++i) {
+        // Newton step, unless it leaves the bracket or the rate is useless
+        double next = 0.5 * (lo + hi);
+        if (rate != 0.0) {
+            double newton = t - f / rate;
+            if (newton > std::min(lo, hi) && newton < std::max(lo, hi)) {
+                next = newton;
+            }
+        }
+
+        double step = fabs(next - t);
+        t = next;
+        if (!evaluate(t, target, offset, f, rate)) {
+            break;
+        }
+
+        if (fabs(f) < kResidualTolerance || step < kTimeTolerance) {
+            break;
+        }
+
+        if (f < 0.0) lo = t;
+        else hi = t;
+
+        if (fabs(hi - lo) < kTimeTolerance) {
+            break;
+        }
+    }
+
+    return {t, rate};
+}
+
+QVector<Crossing> CrossingSolver::findCrossings(double target, double startJd, double endJd,
+                                                double offset) const
+{
+    QVector<Crossing> crossings;
+    if (endJd <= startJd) {
+        return crossings;
+    }
+
+    double jd = startJd;
+    double f = 0.0;
+    double rate = 0.0;
+    if (!evaluate(jd, target, offset, f, rate)) {
+        return crossings;
+    }
+
+    while (jd < endJd) {
+        // The angle cannot reach the target before it has covered |f|
+        double stride = std::max(m_minStep, kStrideSafety * fabs(f) / m_maxRate);
+        double nextJd = std::min(jd + stride, endJd);
+
+        double nextF = 0.0;
+        double nextRate = 0.0;
+        if (!evaluate(nextJd, target, offset, nextF, nextRate)) {
+            return crossings;
+        }
+
+        if ((f < 0.0) != (nextF < 0.0)
+                && fabs(f) < kTrackingLimit && fabs(nextF) < kTrackingLimit) {
+            crossings.append(refine(target, offset, jd, f, rate, nextJd, nextF, nextRate));
+        }
+
+        jd = nextJd;
+        f = nextF;
+        rate = nextRate;
+    }
+
+    return crossings;
+}
@@ -0,0 +1,55 @@
+#ifndef CROSSINGSOLVER_H
+#define CROSSINGSOLVER_H
+
+#include <QVector>
+#include <functional>
+
+// A moment an angle reaches its target
+struct Crossing {
+    double jd;      // UT
+    double rate;    // deg/day at the crossing; negative means moving backwards
+};
+
+// Finds the times an angle (a longitude, an elongation, ...) passes a target
+// value. The caller supplies the angle together with its rate of change, as
+// Swiss Ephemeris gives with SEFLG_SPEED. Enumeration strides through the
+// window as fast as the rate bound allows; each bracketed crossing is then
+// refined with Newton steps, falling back to bisection whenever a step would
+// leave the bracket. A crossing usually takes three or four evaluations.
+class CrossingSolver
+{
+public:
+    // Angle in degrees and its rate in deg/day at jd; false on failure
+    using Evaluator = std::function<bool(double jd, double &angle, double &rate)>;
+
+    // maxRate bounds |rate| over any window searched. minStep is the finest
+    // stride, and must be short enough that the angle cannot pass the target
+    // twice within it (e.g. at a retrograde station).
+    CrossingSolver(Evaluator evaluate, double maxRate, double minStep);
+
+    // Every time in [startJd, endJd] where angle - target equals offset
+    QVector<Crossing> findCrossings(double target, double startJd, double endJd,
+                                    double offset = 0.0) const;
+
+    // Refine a crossing inside a bracket whose ends have opposite signs of
+    // f = (angle - target) - offset. fa/fb and ra/rb are f and rate at ta/tb.
+    Crossing refine(double target, double offset,
+                    double ta, double fa, double ra,
+                    double tb, double fb, double rb) const;
+
+    // Normalize an angular difference to (-180, 180]
+    static double normalize180(double angle);
+
+    // Evaluations made so far, for profiling
+    int evaluations() const { return m_evaluations; }
+
+private:
+    bool evaluate(double jd, double target, double offset, double &f, double &rate) const;
+
+    Evaluator m_evaluate;
+    double m_maxRate;
+    double m_minStep;
+    mutable int m_evaluations = 0;
+};
+
+#endif // CROSSINGSOLVER_H
@@ -0,0 +1,313 @@
+#include "ephemeriscache.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+// Include Swiss Ephemeris headers
+extern "C" {
+#include "swephexp.h"
+}
+
+namespace {
+
+// Normalize an angular difference to (-180, 180]
+double normalize180(double angle)
+{
+    angle = fmod(angle, 360.0);
+    if (angle > 180.0) angle -= 360.0;
+    else if (angle <= -180.0) angle += 360.0;
+    return angle;
+}
+
+double normalize360(double angle)
+{
+    angle = fmod(angle, 360.0);
+    if (angle < 0.0) angle += 360.0;
+    return angle;
+}
+
+bool swePosition(int sweId, double jd, double &longitude, double &latitude, double &speed)
+{
+    double xx[6];
+    char serr[256];
+    if (swe_calc_ut(jd, sweId, SEFLG_SWIEPH | SEFLG_SPEED, xx, serr) < 0) {
+        qWarning() << "Error calculating position for body" << sweId << ":" << serr;
+        return false;
+    }
+    longitude = xx[0];
+    latitude = xx[1];
+    speed = xx[3];
+    return true;
+}
+
+// Clenshaw evaluation of sum c[j] * T_j(x)
+double chebyshev(const double *c, int n, double x)
+{
+    double b1 = 0.0;
+    double b2 = 0.0;
+    for (int j = n - 1; j >= 1; --j) {
+        double b0 = 2.0 * x * b1 - b2 + c[j];
+        b2 = b1;
+        b1 = b0;
+    }
+    return x * b1 - b2 + c[0];
+}
+
+}
+
+EphemerisCache::EphemerisCache(double tolerance, double speedTolerance)
+    : m_tolerance(tolerance)
+    , m_speedTolerance(speedTolerance)
+{
+}
+
+EphemerisCache &EphemerisCache::shared()
+{
+    static EphemerisCache cache;
+    return cache;
+}
+
+double EphemerisCache::segmentLength(Body body)
+{
+    switch (body) {
+    case Body::Moon:
+        return 4.0;
+    case Body::Mercury:
+    case Body::NorthNode:
+    case Body::SouthNode:
+        return 8.0;
+    case Body::Sun:
+    case Body::Venus:
+    case Body::Mars:
+        return 16.0;
+    default:
+        return 32.0;
+    }
+}
+
+Body EphemerisCache::seriesBody(Body body)
+{
+    return body == Body::SouthNode ? Body::NorthNode : body;
+}
+
+bool EphemerisCache::prepare(Body body, double startJd, double endJd)
+{
+    body = seriesBody(body);
+    if (sweBodyId(body) < 0 || endJd < startJd) {
+        return false;
+    }
+
+    QWriteLocker locker(&m_lock);
+    const double length = segmentLength(body);
+    const qint64 firstCell = qint64(std::floor(startJd / length));
+    const qint64 lastCell = qint64(std::floor(endJd / length));
+
+    for (qint64 cell = firstCell; cell <= lastCell; ++cell) {
+        if (m_series[int(body)].cells.contains(cell)) {
+            continue;
+        }
+        if (m_segmentTotal >= MaxSegments) {
+            clearSeries();
+        }
+
+        Series &series = m_series[int(body)];
+        QVector<Segment> fitted;
+        if (!fitSegment(body, cell * length, (cell + 1) * length, 0, fitted, series)) {
+            return false;
+        }
+
+        // Scans mostly move forward, so this is usually an append
+        const int index = int(std::lower_bound(series.segments.cbegin(), series.segments.cend(),
+                                               fitted.first().startJd,
+                                               [](const Segment &segment, double jd) {
+                                                   return segment.startJd < jd;
+                                               }) - series.segments.cbegin());
+        series.segments.insert(index, fitted.size(), Segment());
+        std::copy(fitted.cbegin(), fitted.cend(), series.segments.begin() + index);
+        series.cells.insert(cell);
+        m_segmentTotal += fitted.size();
+    }
+    return true;
+}
+
+void EphemerisCache::clear()
+{
+    QWriteLocker locker(&m_lock);
+    clearSeries();
+}
+
+void EphemerisCache::clearSeries()
+{
+    for (Series &series : m_series) {
+        series = Series();
+    }
+    m_segmentTotal = 0;
+}
+
+bool EphemerisCache::fitSegment(Body body, double startJd, double endJd, int depth,
+                                QVector<Segment> &out, Series &series) const
+{
+    const int sweId = sweBodyId(body);
+    const double mid = 0.5 * (startJd + endJd);
+    const double half = 0.5 * (endJd - startJd);
+
+    // Sample at the Chebyshev nodes, in time order (x from -1 to 1)
+    double nodeX[Nodes];
+    double lon[Nodes];
+    double lat[Nodes];
+    for (int k = 0; k < Nodes; ++k) {
+        nodeX[k] = -std::cos(M_PI * (k + 0.5) / Nodes);
+        double nodeSpeed;
+        if (!swePosition(sweId, mid + half * nodeX[k], lon[k], lat[k], nodeSpeed)) {
+            return false;
+        }
+        // Unwrap so the series does not jump at 0/360
+        if (k > 0) {
+            lon[k] = lon[k - 1] + normalize180(lon[k] - lon[k - 1]);
+        }
+    }
+
+    Segment segment;
+    segment.startJd = startJd;
+    segment.endJd = endJd;
+
+    for (int j = 0; j < Nodes; ++j) {
+        double sumLon = 0.0;
+        double sumLat = 0.0;
+        for (int k = 0; k < Nodes; ++k) {
+            double t = std::cos(j * std::acos(nodeX[k]));
+            sumLon += lon[k] * t;
+            sumLat += lat[k] * t;
+        }
+        double scale = (j == 0 ? 1.0 : 2.0) / Nodes;
+        segment.longitude[j] = sumLon * scale;
+        segment.latitude[j] = sumLat * scale;
+    }
+
+    // Derivative series: d[j-1] = d[j+1] + 2 j c[j], with d[0] halved
+    double d[Nodes + 1] = {};
+    for (int j = Nodes - 1; j >= 1; --j) {
+        d[j - 1] = d[j + 1] + 2.0 * j * segment.longitude[j];
+    }
+    d[0] *= 0.5;
+    for (int j = 0; j < Nodes; ++j) {
+        segment.speed[j] = d[j] / half;
+    }
+
+    // Verify between the nodes and at both ends, where the error peaks.
+    // The speed series is a derivative, so its error grows faster than the
+    // position error and gets its own bound.
+    double worst = 0.0;
+    double worstSpeed = 0.0;
+    for (int k = 0; k <= Nodes; ++k) {
+        double x;
+        if (k == 0) x = -1.0;
+        else if (k == Nodes) x = 1.0;
+        else x = 0.5 * (nodeX[k - 1] + nodeX[k]);
+
+        double refLon, refLat, refSpeed;
+        if (!swePosition(sweId, mid + half * x, refLon, refLat, refSpeed)) {
+            return false;
+        }
+        double fitLon = chebyshev(segment.longitude, Nodes, x);
+        double fitLat = chebyshev(segment.latitude, Nodes, x);
+        double fitSpeed = chebyshev(segment.speed, Nodes, x);
+        worst = std::max(worst, std::fabs(normalize180(fitLon - refLon)));
+        worst = std::max(worst, std::fabs(fitLat - refLat));
+        worstSpeed = std::max(worstSpeed, std::fabs(fitSpeed - refSpeed));
+    }
+
+    const bool withinBounds = worst <= m_tolerance && worstSpeed <= m_speedTolerance;
+    if (!withinBounds && depth < MaxSplitDepth) {
+        return fitSegment(body, startJd, mid, depth + 1, out, series)
+                && fitSegment(body, mid, endJd, depth + 1, out, series);
+    }
+
+    // Out of splits: keep the span covered but leave it to the ephemeris
+    segment.accurate = withinBounds;
+    if (segment.accurate) {
+        series.maxError = std::max(series.maxError, worst);
+        series.maxSpeedError = std::max(series.maxSpeedError, worstSpeed);
+    } else {
+        ++series.rejected;
+        qWarning() << "Chebyshev fit for" << bodyName(body) << "misses the tolerance by"
+                   << worst << "degrees and" << worstSpeed << "degrees/day over JD"
+                   << startJd << "-" << endJd << "; using direct ephemeris calls there";
+    }
+    out.append(segment);
+    return true;
+}
+
+const EphemerisCache::Segment *EphemerisCache::findSegment(Body body, double jd) const
+{
+    const QVector<Segment> &segments = m_series[int(seriesBody(body))].segments;
+    if (segments.isEmpty() || jd < segments.first().startJd || jd > segments.last().endJd) {
+        return nullptr;
+    }
+
+    auto it = std::upper_bound(segments.cbegin(), segments.cend(), jd,
+                               [](double value, const Segment &segment) {
+                                   return value < segment.endJd;
+                               });
+    if (it == segments.cend()) {
+        --it;  // jd is exactly the end of the last segment
+    }
+    // jd may fall in a gap between prepared cells
+    return jd >= it->startJd ? &*it : nullptr;
+}
+
+bool EphemerisCache::covers(Body body, double jd) const
+{
+    QReadLocker locker(&m_lock);
+    return findSegment(body, jd) != nullptr;
+}
+
+bool EphemerisCache::position(Body body, double jd, double &longitude, double &latitude, double &speed) const
+{
+    QReadLocker locker(&m_lock);
+    const Segment *segment = findSegment(body, jd);
+    if (!segment || !segment->accurate) {
+        return false;
+    }
+
+    const double x = (2.0 * jd - segment->startJd - segment->endJd) / (segment->endJd - segment->startJd);
+    longitude = normalize360(chebyshev(segment->longitude, Nodes, x));
+    latitude = chebyshev(segment->latitude, Nodes, x);
+    speed = chebyshev(segment->speed, Nodes, x);
+
+    if (body == Body::SouthNode) {
+        longitude = normalize360(longitude + 180.0);
+        latitude = -latitude;
+    }
+    return true;
+}
+
+bool EphemerisCache::longitude(Body body, double jd, double &longitude, double &speed) const
+{
+    double latitude;
+    return position(body, jd, longitude, latitude, speed);
+}
+
+double EphemerisCache::maxError(Body body) const
+{
+    QReadLocker locker(&m_lock);
+    return m_series[int(seriesBody(body))].maxError;
+}
+
+double EphemerisCache::maxSpeedError(Body body) const
+{
+    QReadLocker locker(&m_lock);
+    return m_series[int(seriesBody(body))].maxSpeedError;
+}
+
+int EphemerisCache::rejectedSegmentCount(Body body) const
+{
+    QReadLocker locker(&m_lock);
+    return m_series[int(seriesBody(body))].rejected;
+}
+
+int EphemerisCache::segmentCount(Body body) const
+{
+    QReadLocker locker(&m_lock);
+    return m_series[int(seriesBody(body))].segments.size();
+}
@@ -0,0 +1,106 @@
+#ifndef EPHEMERISCACHE_H
+#define EPHEMERISCACHE_H
+
+#include <QReadWriteLock>
+#include <QSet>
+#include <QVector>
+#include "astrotypes.h"
+
+// Chebyshev approximation of body positions over a time span. prepare() fits
+// piecewise polynomials to Swiss Ephemeris (SWIEPH) positions; afterwards
+// longitude, latitude and speed come from evaluating a polynomial instead of
+// an ephemeris call. Every segment is checked against SWIEPH between its fit
+// nodes and at both ends, position against the tolerance and speed (the
+// derivative of the longitude series) against speedTolerance, and split
+// until both are within bounds. A segment that still misses them after
+// MaxSplitDepth splits is logged and kept out of the lookups, so callers
+// fall back to direct ephemeris calls there.
+//
+// Segments are fitted per cell of a fixed grid (segmentLength() days), so
+// spans prepared at different times share their fits and nothing is fitted
+// between them. A fit costs 2 x Nodes + 1 ephemeris calls, which pays off
+// for dense sampling (transit scans, event searches) and not for a handful
+// of lookups; sparse searches should only look up what is already there.
+// Past MaxSegments the cache is emptied before fitting more.
+//
+// prepare() calls Swiss Ephemeris, so the caller must hold an
+// EphemerisContext::Lease. All members are safe to call from any thread.
+class EphemerisCache
+{
+public:
+    // Tolerances in degrees for longitude and latitude, and in degrees/day
+    // for the speed
+    explicit EphemerisCache(double tolerance = 1e-6, double speedTolerance = 1e-4);
+
+    // Process-wide cache with the default tolerances. Fits made by one scan
+    // are reused by every later one over the same period.
+    static EphemerisCache &shared();
+
+    // Fit the grid cells covering [startJd, endJd] that are not fitted yet.
+    // Returns false if Swiss Ephemeris reported an error.
+    bool prepare(Body body, double startJd, double endJd);
+    bool covers(Body body, double jd) const;
+    void clear();
+
+    // Polynomial lookups; false when jd is outside the prepared cells or in
+    // a segment that could not be fitted within the tolerances.
+    // The speed is the derivative of the longitude polynomial (deg/day). It
+    // is within speedTolerance() of SWIEPH, so its sign is only reliable
+    // when it is larger than that (not right at a station).
+    bool position(Body body, double jd, double &longitude, double &latitude, double &speed) const;
+    bool longitude(Body body, double jd, double &longitude, double &speed) const;
+
+    double tolerance() const { return m_tolerance; }
+    double speedTolerance() const { return m_speedTolerance; }
+
+    // Largest deviations from SWIEPH found while verifying the fit (degrees
+    // and degrees/day), over the segments used for lookups
+    double maxError(Body body) const;
+    double maxSpeedError(Body body) const;
+    // Segments left to direct ephemeris calls
+    int rejectedSegmentCount(Body body) const;
+    int segmentCount(Body body) const;
+
+    // Grid cell length (days) before adaptive splitting
+    static double segmentLength(Body body);
+
+    static constexpr int MaxSegments = 65536;
+
+private:
+    static constexpr int Nodes = 14;
+    static constexpr int MaxSplitDepth = 8;
+
+    struct Segment {
+        double startJd;
+        double endJd;
+        double longitude[Nodes];  // Unwrapped longitude
+        double latitude[Nodes];
+        double speed[Nodes];      // Derivative of the longitude series
+        bool accurate;            // Within the tolerances; lookups use it
+    };
+
+    struct Series {
+        QVector<Segment> segments;  // In time order, with gaps between
+                                    // cells that were never prepared
+        QSet<qint64> cells;         // Grid cells fitted so far
+        double maxError = 0.0;
+        double maxSpeedError = 0.0;
+        int rejected = 0;
+    };
+
+    bool fitSegment(Body body, double startJd, double endJd, int depth,
+                    QVector<Segment> &out, Series &series) const;
+    const Segment *findSegment(Body body, double jd) const;
+    void clearSeries();
+
+    // The South Node shares the North Node series
+    static Body seriesBody(Body body);
+
+    Series m_series[BodyCount];
+    int m_segmentTotal = 0;
+    double m_tolerance;
+    double m_speedTolerance;
+    mutable QReadWriteLock m_lock;
+};
+
+#endif // EPHEMERISCACHE_H
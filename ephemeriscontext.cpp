@@ -0,0 +1,234 @@
+#include "ephemeriscontext.h"
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRecursiveMutex>
+#include <QSemaphore>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+
+// Include Swiss Ephemeris headers
+extern "C" {
+#include "swephexp.h"
+}
+
+namespace {
+
+QMutex s_initMutex;
+bool s_initialized = false;
+QString s_ephemerisPath;
+
+// Only used when Swiss Ephemeris was built without thread-local storage
+QRecursiveMutex s_globalEphemerisMutex;
+
+// Per-thread binding of the Swiss Ephemeris state. The destructor runs when
+// the thread exits and releases the files that thread had open.
+struct ThreadBinding {
+    bool bound = false;
+
+    ~ThreadBinding() {
+        if (bound && EphemerisContext::isThreadSafe()) {
+            swe_close();
+        }
+    }
+};
+
+thread_local ThreadBinding t_binding;
+
+}
+
+QStringList EphemerisContext::searchPaths()
+{
+    // Possible locations for ephemeris files
+    QStringList searchPaths;
+
+#ifdef FLATHUB_BUILD
+    // For Flatpak builds, the ephemeris files are in /app/share/swisseph
+    searchPaths << "/app/share/swisseph";
+#else
+    // Standard locations for non-Flatpak builds
+    searchPaths << QCoreApplication::applicationDirPath() + "/ephemeris"
+                << QCoreApplication::applicationDirPath() + "/../share/Asteria/ephemeris"
+                << "/app/share/Asteria/ephemeris"
+                << QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/ephemeris";
+#endif
+
+    return searchPaths;
+}
+
+bool EphemerisContext::initialize(QString *errorMessage)
+{
+    QMutexLocker locker(&s_initMutex);
+    if (s_initialized) {
+        return true;
+    }
+
+    const QStringList paths = searchPaths();
+
+    // Find first valid path
+    for (const QString &path : paths) {
+        if (path.isEmpty()) continue;
+
+        QDir dir(path);
+        if (dir.exists()) {
+            // Check for existence of key ephemeris files
+            if (dir.exists("sepl_18.se1") || dir.exists("sepl_20.se1") ||
+                dir.exists("seas_18.se1") || dir.exists("semo_18.se1")) {
+                s_ephemerisPath = path;
+
+                // Without thread-local storage there is a single global state,
+                // so setting the path once here covers every thread
+                if (!isThreadSafe()) {
+                    QByteArray pathBytes = s_ephemerisPath.toLocal8Bit();
+                    swe_set_ephe_path(pathBytes.constData());
+                }
+
+                s_initialized = true;
+                return true;
+            }
+        }
+    }
+
+    // If we get here, no valid path was found
+    qWarning() << "Ephemeris files not found in any standard location!";
+    qWarning() << "Searched paths:";
+    for (const QString &path : paths) {
+        qWarning() << "  " << path;
+    }
+
+    if (errorMessage) {
+        *errorMessage = "Ephemeris files not found. Please check installation.";
+    }
+    return false;
+}
+
+bool EphemerisContext::isInitialized()
+{
+    QMutexLocker locker(&s_initMutex);
+    return s_initialized;
+}
+
+QString EphemerisContext::ephemerisPath()
+{
+    QMutexLocker locker(&s_initMutex);
+    return s_ephemerisPath;
+}
+
+QByteArray EphemerisContext::fingerprint()
+{
+    const QString path = ephemerisPath();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    char version[256] = {};
+    swe_version(version);
+    hash.addData(QByteArray(version));
+    hash.addData(path.toUtf8());
+
+    const QFileInfoList files = QDir(path).entryInfoList(QDir::Files, QDir::Name);
+    for (const QFileInfo &file : files) {
+        hash.addData(file.fileName().toUtf8());
+        hash.addData(QByteArray::number(file.size()));
+        hash.addData(QByteArray::number(file.lastModified().toMSecsSinceEpoch()));
+    }
+    return hash.result().toHex();
+}
+
+bool EphemerisContext::isThreadSafe()
+{
+#ifdef TLSOFF
+    return false;
+#else
+    return true;
+#endif
+}
+
+EphemerisContext::Lease::Lease()
+{
+    if (!initialize()) {
+        return;
+    }
+
+    if (!isThreadSafe()) {
+        s_globalEphemerisMutex.lock();
+        m_locked = true;
+    } else if (!t_binding.bound) {
+        // First use of Swiss Ephemeris on this thread
+        QByteArray pathBytes = ephemerisPath().toLocal8Bit();
+        swe_set_ephe_path(pathBytes.constData());
+        t_binding.bound = true;
+    }
+
+    m_valid = true;
+}
+
+EphemerisContext::Lease::~Lease()
+{
+    if (m_locked) {
+        s_globalEphemerisMutex.unlock();
+    }
+}
+
+QThreadPool *EphemerisPool::threadPool()
+{
+    static QThreadPool *pool = [] {
+        QThreadPool *p = new QThreadPool;
+        p->setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+        // Keep workers (and their open ephemeris files) around between batches
+        p->setExpiryTimeout(-1);
+        return p;
+    }();
+    return pool;
+}
+
+int EphemerisPool::maxConcurrency()
+{
+    // Serialized access gains nothing from more threads
+    if (!EphemerisContext::isThreadSafe()) {
+        return 1;
+    }
+    return threadPool()->maxThreadCount();
+}
+
+void EphemerisPool::parallelFor(int count, const std::function<void(int)> &body)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    int helpers = std::min(count, maxConcurrency()) - 1;
+    if (helpers <= 0) {
+        for (int i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    QAtomicInt next(0);
+    QSemaphore finished;
+
+    auto worker = [&]() {
+        for (int i = next.fetchAndAddRelaxed(1); i < count; i = next.fetchAndAddRelaxed(1)) {
+            body(i);
+        }
+    };
+
+    // Only hand work to threads that are free right now; whatever does not
+    // start is picked up by the calling thread below
+    int started = 0;
+    for (int h = 0; h < helpers; ++h) {
+        if (!threadPool()->tryStart([&]() { worker(); finished.release(); })) {
+            break;
+        }
+        ++started;
+    }
+
+    worker();
+    finished.acquire(started);
+}
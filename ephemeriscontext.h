@@ -0,0 +1,71 @@
+#ifndef EPHEMERISCONTEXT_H
+#define EPHEMERISCONTEXT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+class QThreadPool;
+
+// Swiss Ephemeris keeps its state (ephemeris path, open files, position
+// caches) in thread-local storage. Each thread that calls swe_* has to set the
+// ephemeris path for itself, and swe_close() must only close the state of the
+// thread that is done with it. EphemerisContext takes care of both, so any
+// number of ChartCalculator instances can run side by side on worker threads.
+class EphemerisContext
+{
+public:
+    // Locate the ephemeris files. Runs once per process, safe from any thread.
+    static bool initialize(QString *errorMessage = nullptr);
+    static bool isInitialized();
+    static QString ephemerisPath();
+    static QStringList searchPaths();
+
+    // Identifies the ephemeris in use: the library version and the name,
+    // size and modification time of every file in ephemerisPath(). Changes
+    // whenever the files are replaced, so results stored with it can be
+    // told apart from results of another ephemeris.
+    static QByteArray fingerprint();
+
+    // Swiss Ephemeris built with TLSOFF shares one global state between all
+    // threads; in that case every lease is serialized. Set by the
+    // SWISSEPH_TLSOFF CMake option, which builds the library the same way.
+    static bool isThreadSafe();
+
+    // RAII guard held around swe_* calls. Binds the calling thread's
+    // ephemeris state to the resolved path on first use, and serializes
+    // access when the library has no thread-local storage. Leases nest.
+    class Lease
+    {
+    public:
+        Lease();
+        ~Lease();
+
+        bool isValid() const { return m_valid; }
+
+    private:
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+
+        bool m_valid = false;
+        bool m_locked = false;
+    };
+};
+
+// Shared worker pool for ephemeris-heavy batch work (chart batches, return
+// series, long scans). Each worker thread gets its own ephemeris state the
+// first time it takes a lease.
+class EphemerisPool
+{
+public:
+    static QThreadPool *threadPool();
+    static int maxConcurrency();
+
+    // Run body(i) for every i in [0, count) across the pool and wait until all
+    // of them are done. The calling thread takes part in the work, so calling
+    // this from inside a pool task cannot deadlock.
+    static void parallelFor(int count, const std::function<void(int)> &body);
+};
+
+#endif // EPHEMERISCONTEXT_H
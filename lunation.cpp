@@ -0,0 +1,83 @@
+#include "lunation.h"
+#include "crossingsolver.h"
+#include "ephemeriscache.h"
+#include <QDebug>
+#include <cmath>
+
+// Include Swiss Ephemeris headers
+extern "C" {
+#include "swephexp.h"
+}
+
+namespace {
+
+// Bounds of the Moon's daily gain on the Sun (deg/day); the mean is 12.19
+const double kMinElongationRate = 10.0;
+const double kMaxElongationRate = 15.5;
+
+bool elongation(double jd, double &angle, double &rate)
+{
+    double sun[6];
+    double moon[6];
+
+    // Charts made day by day in a transit scan search around days the scan
+    // has fitted; otherwise the few evaluations go to the ephemeris
+    const EphemerisCache &cache = EphemerisCache::shared();
+    if (!cache.longitude(Body::Sun, jd, sun[0], sun[3])
+            || !cache.longitude(Body::Moon, jd, moon[0], moon[3])) {
+        char serr[256];
+        const int flags = SEFLG_SWIEPH | SEFLG_SPEED;
+        if (swe_calc_ut(jd, SE_SUN, flags, sun, serr) < 0 ||
+            swe_calc_ut(jd, SE_MOON, flags, moon, serr) < 0) {
+            qWarning() << "Error calculating Sun/Moon elongation:" << serr;
+            return false;
+        }
+    }
+
+    angle = fmod(moon[0] - sun[0], 360.0);
+    if (angle < 0.0) angle += 360.0;
+    rate = moon[3] - sun[3];
+    return true;
+}
+
+}
+
+bool findPreviousLunation(double jd, Lunation *lunation)
+{
+    double angle = 0.0;
+    double rate = 0.0;
+    if (!elongation(jd, angle, rate)) {
+        return false;
+    }
+
+    // Below 180 the last lunation was a New Moon, above it a Full Moon.
+    // distance is how far the elongation has moved on since then.
+    const bool newMoon = angle < 180.0;
+    const double target = newMoon ? 0.0 : 180.0;
+    const double distance = newMoon ? angle : angle - 180.0;
+
+    if (distance == 0.0) {
+        lunation->jd = jd;
+        lunation->newMoon = newMoon;
+        return true;
+    }
+
+    // Even at the slowest rate the lunation lies within this bracket
+    const double earliestJd = jd - distance / kMinElongationRate;
+
+    CrossingSolver solver(elongation, kMaxElongationRate, 1.0);
+
+    double earliestAngle = 0.0;
+    double earliestRate = 0.0;
+    if (!elongation(earliestJd, earliestAngle, earliestRate)) {
+        return false;
+    }
+    double earliestF = CrossingSolver::normalize180(earliestAngle - target);
+
+    Crossing crossing = solver.refine(target, 0.0,
+                                      earliestJd, earliestF, earliestRate,
+                                      jd, distance, rate);
+    lunation->jd = crossing.jd;
+    lunation->newMoon = newMoon;
+    return true;
+}
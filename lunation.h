@@ -0,0 +1,17 @@
+#ifndef LUNATION_H
+#define LUNATION_H
+
+// A New Moon (Sun-Moon conjunction) or Full Moon (opposition)
+struct Lunation {
+    double jd = 0.0;    // UT
+    bool newMoon = false;
+};
+
+// The most recent New or Full Moon at or before jd (the syzygy of a chart).
+// The Moon always gains on the Sun, so the current elongation tells how far
+// back the last lunation was; one Newton-refined solve on the elongation and
+// its rate finds it, typically in three or four Sun/Moon evaluations.
+// Callers must hold an EphemerisContext::Lease.
+bool findPreviousLunation(double jd, Lunation *lunation);
+
+#endif // LUNATION_H
@@ -5,23 +5,12 @@
 #include <QFontDatabase>
 #include <QString>
 #include"Globals.h"
+#include "ephemeriscontext.h"
+#include "resultcache.h"
 #include<QDir>
 #include<QPalette>
 #include<QStyleFactory>
 
-namespace {
-double g_orbMax = 8.0; // Default orb value
-}
-
-// Add a getter/setter function
-double getOrbMax() {
-    return g_orbMax;
-}
-
-void setOrbMax(double value) {
-    g_orbMax = value;
-}
-
 QString g_astroFontFamily;
 
 
@@ -69,6 +58,11 @@ int main(int argc, char *argv[])
 
     QCoreApplication::setApplicationName("Asteria");
     QDir().mkpath(GlobalFlags::appDir);
+
+    // Set up the shared result cache here on the GUI thread, so calculation
+    // threads never read appDir or hash the ephemeris files
+    EphemerisContext::initialize();
+    ResultCache::shared();
     QCoreApplication::setApplicationVersion("2.4.7");
 
 
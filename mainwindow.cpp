@@ -31,6 +31,7 @@
 #include<QScrollBar>
 #include"Globals.h"
 #include"aspectsettingsdialog.h"
+#include"aspectkernel.h"
 #include <QCheckBox>
 #include <QRegularExpression>
 #include<QClipboard>
@@ -45,9 +46,42 @@
 #include<QCoreApplication>
 #include<QDesktopServices>
 #include<QApplication>
+#include<QFutureWatcher>
+#include<QSet>
 
 extern QString g_astroFontFamily;
 
+namespace {
+
+// Show a cancellable progress dialog for a background job and call done with
+// the future once it has finished or was cancelled. The window keeps
+// repainting while the job runs.
+template<typename T, typename Done>
+void watchJob(QWidget *parent, const QString &label, const QFuture<T> &future, Done done)
+{
+    auto *watcher = new QFutureWatcher<T>(parent);
+    auto *dialog = new QProgressDialog(label, QObject::tr("Cancel"), 0, 0, parent);
+    dialog->setWindowModality(Qt::WindowModal);
+    dialog->setMinimumDuration(300);
+
+    QObject::connect(watcher, &QFutureWatcherBase::progressRangeChanged,
+                     dialog, &QProgressDialog::setRange);
+    QObject::connect(watcher, &QFutureWatcherBase::progressValueChanged,
+                     dialog, &QProgressDialog::setValue);
+    QObject::connect(dialog, &QProgressDialog::canceled, watcher, &QFutureWatcherBase::cancel);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, parent, [watcher, dialog, done]() {
+        QObject::disconnect(dialog, nullptr, watcher, nullptr);
+        dialog->reset();
+        dialog->deleteLater();
+        done(watcher->future());
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(future);
+}
+
+}
+
 const QRegularExpression MainWindow::dateRegex(
         R"(^(0[1-9]|[12][0-9]|3[01])/(0[1-9]|1[0-2])/(000[1-9]|00[1-9][0-9]|0[1-9][0-9]{2}|[12][0-9]{3}|3000)$)"
 );
@@ -292,10 +326,22 @@ void MainWindow::setupCentralWidget() {
 
     //////////Prediction Data
     // Create a new tab for raw prediction data
-    rawTransitTable = new QTableWidget(0, 4, detailsTabs);
+    // A model/view table: cell text is made only for the visible rows
+    m_transitModel = new TransitTableModel(this);
+    m_transitProxy = new TransitFilterProxyModel(this);
+    m_transitProxy->setSourceModel(m_transitModel);
+    rawTransitTable = new QTableView(detailsTabs);
     rawTransitTable->setObjectName("RawTransits");
-    rawTransitTable->setHorizontalHeaderLabels({"Date", "Transit Planet", "Aspect", "Natal Planet (Orb)"});
+    rawTransitTable->setModel(m_transitProxy);
     rawTransitTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    rawTransitTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    // Rows arrive in date order; keep that until a header is clicked
+    rawTransitTable->horizontalHeader()->setSortIndicator(TransitTableModel::DateColumn, Qt::AscendingOrder);
+    rawTransitTable->setSortingEnabled(true);
+    // Aspect windows take the table's place when they are calculated
+    m_transitEventModel = new TransitEventTableModel(this);
+    m_transitEventProxy = new TransitEventFilterProxyModel(this);
+    m_transitEventProxy->setSourceModel(m_transitEventModel);
 
 
     // Eclipse Data table
@@ -304,9 +350,9 @@ void MainWindow::setupCentralWidget() {
     eclipseTable->setHorizontalHeaderLabels({"Date", "Time", "Type", "Magnitude", "Latitude", "Longitude"});
     eclipseTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     // make all tables copiable
-    QList<QTableWidget*> tables = {planetsTable, anglesTable, housesTable, aspectsTable, rawTransitTable, eclipseTable};
+    QList<QTableView*> tables = {planetsTable, anglesTable, housesTable, aspectsTable, rawTransitTable, eclipseTable};
 
-    for (QTableWidget *table : tables) {
+    for (QTableView *table : tables) {
         table->setSelectionBehavior(QAbstractItemView::SelectItems);
         table->setSelectionMode(QAbstractItemView::ExtendedSelection);
         table->setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -342,8 +388,7 @@ void MainWindow::setupCentralWidget() {
                         copiedText += '\t';
                     }
                 }
-                QTableWidgetItem *item = table->item(index.row(), index.column());
-                copiedText += item ? item->text() : "";
+                copiedText += index.data().toString();
             }
 
             QClipboard *clipboard = QGuiApplication::clipboard();
@@ -690,7 +735,7 @@ void MainWindow::setupInputDock() {
         GlobalFlags::additionalBodiesEnabled = checked;
 
         if (m_chartCalculated) {
-            displayChart(m_currentChartData);
+            displayChart(m_currentChart);
         }
 
     });
@@ -733,6 +778,22 @@ void MainWindow::setupInputDock() {
     // Add to form layout
     predictiveLayout->addRow("From:", m_predictiveFromEdit);
     predictiveLayout->addRow("Up to:", m_predictiveToEdit);
+
+    QCheckBox *transitChartPointsCB = new QCheckBox("Transiting Chart Points", predictiveGroup);
+    transitChartPointsCB->setToolTip("Also move the Syzygy, Pars Fortuna, Part of Spirit, Vertex and East Point\n"
+                                     "day by day (with Additional Bodies). Much slower: a whole chart is\n"
+                                     "calculated for every day of the period.");
+    connect(transitChartPointsCB, &QCheckBox::toggled, this, [](bool checked) {
+        GlobalFlags::transitChartPointsEnabled = checked;
+    });
+    predictiveLayout->addRow(transitChartPointsCB);
+
+    m_transitWindowsCB = new QCheckBox("Aspect Windows", predictiveGroup);
+    m_transitWindowsCB->setChecked(true);
+    m_transitWindowsCB->setToolTip("List each transit once, with the times it comes into orb, is exact and\n"
+                                   "leaves orb, instead of a row for every day it is in orb. Much more\n"
+                                   "compact for long periods. Chart points only move in the daily list.");
+    predictiveLayout->addRow(m_transitWindowsCB);
     //Prediction Button
     /*
     getPredictionButton = new QPushButton("Get AI Prediction", predictiveGroup);
@@ -918,7 +979,7 @@ void MainWindow::setupMenus()
             chartData["interpretationText"] = m_interpretationtextEdit->toPlainText();
         }
 
-        chartData["chartData"] = m_currentChartData;
+        chartData["chartData"] = currentChartJson();
 
         // Create new window and import the data
         MainWindow *newWindow = new MainWindow();
@@ -1326,7 +1387,7 @@ void MainWindow::calculateChart()
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject(); // Reset relationship info
 
     m_chartRenderer->scene()->clear();
@@ -1334,13 +1395,13 @@ void MainWindow::calculateChart()
     // Calculate chart
     birthDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
 
-    m_currentChartData = m_chartDataManager.calculateChartAsJson(
-                birthDate, birthTime, utcOffset, latitude, longitude, houseSystem);
+    setCurrentChart(m_chartDataManager.calculateChart(
+                birthDate, birthTime, utcOffset, latitude, longitude, houseSystem));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
 
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         // Set chart type for interpretation
 
@@ -1366,53 +1427,9 @@ void MainWindow::calculateChart()
 
 
 
-void MainWindow::displayChart(const QJsonObject &chartData) {
-
-    // Define which bodies are considered "additional"
-    QStringList additionalBodies = {
-        "Ceres", "Pallas", "Juno", "Vesta", "Lilith",
-        "Vertex", "Part of Spirit", "East Point"
-    };
-
-    // Create a filtered copy of the chart data
-    QJsonObject filteredChartData = chartData;
-
-    // Filter out additional bodies if checkbox is not checked
-    if (!m_additionalBodiesCB->isChecked()) {
-        // Filter planets
-        QJsonArray planets = filteredChartData["planets"].toArray();
-        QJsonArray filteredPlanets;
-
-        for (int i = 0; i < planets.size(); i++) {
-            QJsonObject planet = planets[i].toObject();
-            QString planetId = planet["id"].toString();
-
-            // Keep the planet if it's not in the additional bodies list
-            if (!additionalBodies.contains(planetId)) {
-                filteredPlanets.append(planet);
-            }
-        }
-        filteredChartData["planets"] = filteredPlanets;
-
-        // Filter aspects
-        QJsonArray aspects = filteredChartData["aspects"].toArray();
-        QJsonArray filteredAspects;
-
-        for (int i = 0; i < aspects.size(); i++) {
-            QJsonObject aspect = aspects[i].toObject();
-            QString planet1 = aspect["planet1"].toString();
-            QString planet2 = aspect["planet2"].toString();
-
-            // Keep the aspect if neither planet is an additional body
-            if (!additionalBodies.contains(planet1) && !additionalBodies.contains(planet2)) {
-                filteredAspects.append(aspect);
-            }
-        }
-        filteredChartData["aspects"] = filteredAspects;
-    }
+void MainWindow::displayChart(const ChartData &chart) {
 
-    // Convert QJsonObject to ChartData
-    ChartData data = convertJsonToChartData(filteredChartData);
+    ChartData data = visibleChart(chart);
 
     // Update chart renderer with new data
     m_chartRenderer->setChartData(data);
@@ -1424,7 +1441,7 @@ void MainWindow::displayChart(const QJsonObject &chartData) {
     m_modalityElementWidget->updateData(data);
 
     // Update chart details tables
-    updateChartDetailsTables(filteredChartData);
+    updateChartDetailsTables(data);
 
     //info overlay
     chartInfoOverlay->setVisible(m_showInfoOverlay);
@@ -1435,8 +1452,62 @@ void MainWindow::displayChart(const QJsonObject &chartData) {
     // this->setWindowTitle("Asteria - Astrological Chart Analysis - Birth Chart");
 }
 
+ChartData MainWindow::visibleChart(const ChartData &chart) const
+{
+    if (m_additionalBodiesCB->isChecked()) {
+        return chart;
+    }
+
+    // Define which bodies are considered "additional"
+    static const QStringList additionalBodies = {
+        "Ceres", "Pallas", "Juno", "Vesta", "Lilith",
+        "Vertex", "Part of Spirit", "East Point"
+    };
+
+    ChartData data = chart;
+    data.planets.clear();
+    data.aspects.clear();
+    for (const PlanetData &planet : chart.planets) {
+        if (!additionalBodies.contains(planet.id)) {
+            data.planets.append(planet);
+        }
+    }
+    // Keep the aspect if neither planet is an additional body
+    for (const AspectData &aspect : chart.aspects) {
+        if (!additionalBodies.contains(aspect.planet1) && !additionalBodies.contains(aspect.planet2)) {
+            data.aspects.append(aspect);
+        }
+    }
+    return data;
+}
+
+void MainWindow::setCurrentChart(const ChartData &chart)
+{
+    m_currentChart = chart;
+    m_currentChartData = QJsonObject();
+}
+
+void MainWindow::setCurrentChartJson(const QJsonObject &chartData)
+{
+    m_currentChart = convertJsonToChartData(chartData);
+    m_currentChartData = chartData;
+}
+
+void MainWindow::clearCurrentChart()
+{
+    m_currentChart = ChartData();
+    m_currentChartData = QJsonObject();
+}
+
+QJsonObject MainWindow::currentChartJson()
+{
+    if (m_currentChartData.isEmpty() && !m_currentChart.planets.isEmpty()) {
+        m_currentChartData = m_chartDataManager.chartDataToJson(m_currentChart);
+    }
+    return m_currentChartData;
+}
 
-void MainWindow::updateChartDetailsTables(const QJsonObject &chartData)
+void MainWindow::updateChartDetailsTables(const ChartData &chart)
 {
     // Get table widgets
     QTableWidget *planetsTable = m_chartDetailsWidget->findChild<QTabWidget*>()->findChild<QTableWidget*>("Planets");
@@ -1454,37 +1525,29 @@ void MainWindow::updateChartDetailsTables(const QJsonObject &chartData)
     housesTable->setRowCount(0);
     aspectsTable->setRowCount(0);
 
-    // Fill planets table
-    if (chartData.contains("planets") && chartData["planets"].isArray()) {
-        QJsonArray planets = chartData["planets"].toArray();
-        planetsTable->setRowCount(planets.size());
-
-        for (int i = 0; i < planets.size(); ++i) {
-            QJsonObject planet = planets[i].toObject();
-
-            QString planetName = planet["id"].toString();
-            if (planet["isRetrograde"].toBool() && planetName != "North Node" && planetName != "South Node") {
-                planetName += "   ℞"; // Using the official retrograde symbol (℞)
-            }
-
-            // Split the sign string to get just the sign name and degrees
-            QString fullSign = planet["sign"].toString();
-            QString signName = fullSign.split(' ').first();
-            QStringList parts = fullSign.split(' ');
-            QString degreesPart = parts.size() > 1 ? parts.mid(1).join(' ') : "";
-
-            QTableWidgetItem *nameItem = new QTableWidgetItem(planetName);
-            QTableWidgetItem *signItem = new QTableWidgetItem(signName);
-            QTableWidgetItem *degreeItem = new QTableWidgetItem(degreesPart);
-            QTableWidgetItem *houseItem = new QTableWidgetItem(planet["house"].toString());
+    // Fill planets table, noting which planets are retrograde for the aspects
+    QSet<QString> retrogradePlanets;
+    planetsTable->setRowCount(chart.planets.size());
+    for (int i = 0; i < chart.planets.size(); ++i) {
+        const PlanetData &planet = chart.planets.at(i);
 
+        QString planetName = planet.id;
+        if (planet.isRetrograde) {
+            retrogradePlanets.insert(planet.id);
+        }
+        if (planet.isRetrograde && planetName != "North Node" && planetName != "South Node") {
+            planetName += "   ℞"; // Using the official retrograde symbol (℞)
+        }
 
+        // Split the sign string to get just the sign name and degrees
+        QStringList parts = planet.sign.split(' ');
+        QString signName = parts.first();
+        QString degreesPart = parts.size() > 1 ? parts.mid(1).join(' ') : "";
 
-            planetsTable->setItem(i, 0, nameItem);
-            planetsTable->setItem(i, 1, signItem);
-            planetsTable->setItem(i, 2, degreeItem);
-            planetsTable->setItem(i, 3, houseItem);
-        }
+        planetsTable->setItem(i, 0, new QTableWidgetItem(planetName));
+        planetsTable->setItem(i, 1, new QTableWidgetItem(signName));
+        planetsTable->setItem(i, 2, new QTableWidgetItem(degreesPart));
+        planetsTable->setItem(i, 3, new QTableWidgetItem(planet.house));
     }
 
     // Mapping from angle IDs to long names
@@ -1495,98 +1558,47 @@ void MainWindow::updateChartDetailsTables(const QJsonObject &chartData)
         {"IC", "Imum Coeli (Nadir)"}
     };
     // Fill angles table
-    if (chartData.contains("angles") && chartData["angles"].isArray()) {
-        QJsonArray angles = chartData["angles"].toArray();
-        anglesTable->setRowCount(angles.size());
-        for (int i = 0; i < angles.size(); ++i) {
-            QJsonObject angle = angles[i].toObject();
-            QString angleName = angle["id"].toString(); // e.g., ASC, DESC, IC, MC
-            QString longName = angleLongNames.value(angleName, angleName); // fallback to id if not found
-
-            QString signName = angle["sign"].toString();
-            QString degreeStr = QString::number(angle["longitude"].toDouble(), 'f', 2) + "°";
-            //QTableWidgetItem *nameItem = new QTableWidgetItem(angleName);
-            QTableWidgetItem *nameItem = new QTableWidgetItem(longName);
-
-
-            QTableWidgetItem *signItem = new QTableWidgetItem(signName);
-            QTableWidgetItem *degreeItem = new QTableWidgetItem(degreeStr);
-            anglesTable->setItem(i, 0, nameItem);
-            anglesTable->setItem(i, 1, signItem);
-            anglesTable->setItem(i, 2, degreeItem);
-        }
+    anglesTable->setRowCount(chart.angles.size());
+    for (int i = 0; i < chart.angles.size(); ++i) {
+        const AngleData &angle = chart.angles.at(i);
+        QString longName = angleLongNames.value(angle.id, angle.id); // fallback to id if not found
+
+        anglesTable->setItem(i, 0, new QTableWidgetItem(longName));
+        anglesTable->setItem(i, 1, new QTableWidgetItem(angle.sign));
+        anglesTable->setItem(i, 2, new QTableWidgetItem(QString::number(angle.longitude, 'f', 2) + "°"));
     }
 
     // Fill houses table
+    housesTable->setRowCount(chart.houses.size());
+    for (int i = 0; i < chart.houses.size(); ++i) {
+        const HouseData &house = chart.houses.at(i);
 
-    if (chartData.contains("houses") && chartData["houses"].isArray()) {
-        QJsonArray houses = chartData["houses"].toArray();
-        housesTable->setRowCount(houses.size());
-
-        for (int i = 0; i < houses.size(); ++i) {
-            QJsonObject house = houses[i].toObject();
-
-            QTableWidgetItem *nameItem = new QTableWidgetItem(house["id"].toString());
-            QTableWidgetItem *signItem = new QTableWidgetItem(house["sign"].toString());
-            QTableWidgetItem *degreeItem = new QTableWidgetItem(QString::number(house["longitude"].toDouble(), 'f', 2) + "°");
-
-            housesTable->setItem(i, 0, nameItem);
-            housesTable->setItem(i, 1, signItem);
-            housesTable->setItem(i, 2, degreeItem);
-
-
-        }
+        housesTable->setItem(i, 0, new QTableWidgetItem(house.id));
+        housesTable->setItem(i, 1, new QTableWidgetItem(house.sign));
+        housesTable->setItem(i, 2, new QTableWidgetItem(QString::number(house.longitude, 'f', 2) + "°"));
     }
 
-    if (chartData.contains("aspects") && chartData["aspects"].isArray()) {
-        QJsonArray aspects = chartData["aspects"].toArray();
-        QJsonArray planets = chartData["planets"].toArray();
-        aspectsTable->setRowCount(aspects.size());
-
-        for (int i = 0; i < aspects.size(); ++i) {
-            QJsonObject aspect = aspects[i].toObject();
-
-            // Get planet names from the aspect
-            QString planet1Name = aspect["planet1"].toString();
-            QString planet2Name = aspect["planet2"].toString();
-
-            // Check if planets are retrograde by looking them up in the planets array
-            bool planet1Retrograde = false;
-            bool planet2Retrograde = false;
-
-            // Find retrograde status for both planets
-            for (int j = 0; j < planets.size(); ++j) {
-                QJsonObject planet = planets[j].toObject();
-                if (planet["id"].toString() == planet1Name) {
-                    planet1Retrograde = planet["isRetrograde"].toBool();
-                }
-                if (planet["id"].toString() == planet2Name) {
-                    planet2Retrograde = planet["isRetrograde"].toBool();
-                }
-            }
-
-            // Create display text with retrograde symbol if needed
-            QString planet1Display = planet1Name;
-            if (planet1Retrograde && planet1Name != "North Node" && planet1Name != "South Node") {
-                planet1Display += " ℞";
-            }
-
-            QString planet2Display = planet2Name;
-            if (planet2Retrograde && planet2Name != "North Node" && planet2Name != "South Node") {
-                planet2Display += " ℞";
-            }
+    aspectsTable->setRowCount(chart.aspects.size());
+    for (int i = 0; i < chart.aspects.size(); ++i) {
+        const AspectData &aspect = chart.aspects.at(i);
 
-            // Create table items
-            QTableWidgetItem *planet1Item = new QTableWidgetItem(planet1Display);
-            QTableWidgetItem *aspectTypeItem = new QTableWidgetItem(aspect["aspectType"].toString());
-            QTableWidgetItem *planet2Item = new QTableWidgetItem(planet2Display);
-            QTableWidgetItem *orbItem = new QTableWidgetItem(QString::number(aspect["orb"].toDouble(), 'f', 2) + "°");
+        // Create display text with retrograde symbol if needed
+        QString planet1Display = aspect.planet1;
+        if (retrogradePlanets.contains(aspect.planet1)
+                && aspect.planet1 != "North Node" && aspect.planet1 != "South Node") {
+            planet1Display += " ℞";
+        }
 
-            aspectsTable->setItem(i, 0, planet1Item);
-            aspectsTable->setItem(i, 1, aspectTypeItem);
-            aspectsTable->setItem(i, 2, planet2Item);
-            aspectsTable->setItem(i, 3, orbItem);
+        QString planet2Display = aspect.planet2;
+        if (retrogradePlanets.contains(aspect.planet2)
+                && aspect.planet2 != "North Node" && aspect.planet2 != "South Node") {
+            planet2Display += " ℞";
         }
+
+        aspectsTable->setItem(i, 0, new QTableWidgetItem(planet1Display));
+        aspectsTable->setItem(i, 1, new QTableWidgetItem(aspect.aspectType));
+        aspectsTable->setItem(i, 2, new QTableWidgetItem(planet2Display));
+        aspectsTable->setItem(i, 3, new QTableWidgetItem(QString::number(aspect.orb, 'f', 2) + "°"));
     }
 }
 
@@ -1608,7 +1620,7 @@ void MainWindow::getInterpretation() {
     }
 
     // Create filtered chart data based on additional bodies checkbox
-    QJsonObject dataToSend = m_currentChartData;
+    QJsonObject dataToSend = currentChartJson();
 
     // Define which bodies are considered "additional"
     QStringList additionalBodies = {
@@ -1755,7 +1767,7 @@ void MainWindow::newChart() {
 
     // Clear chart and interpretation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentInterpretation.clear();
     m_currentRelationshipInfo = QJsonObject();  // Reset relationship info
 
@@ -1811,7 +1823,7 @@ void MainWindow::saveChart() {
 
     // Create JSON document with chart data and interpretation
     QJsonObject saveData;
-    saveData["chartData"] = m_currentChartData;
+    saveData["chartData"] = currentChartJson();
     saveData["interpretation"] = m_currentInterpretation;
 
     // Add birth information for reference
@@ -1886,8 +1898,8 @@ void MainWindow::loadChart() {
 
             // Load chart data
             if (saveData.contains("chartData") && saveData["chartData"].isObject()) {
-                m_currentChartData = saveData["chartData"].toObject();
-                displayChart(m_currentChartData);
+                setCurrentChartJson(saveData["chartData"].toObject());
+                displayChart(m_currentChart);
                 m_chartCalculated = true;
                 m_getInterpretationButton->setEnabled(true);
             }
@@ -2154,6 +2166,7 @@ void MainWindow::saveSettings()
     settings.setValue("view/showInfoOverlay", m_showInfoOverlay);
 
     AspectSettings::instance().saveToSettings(settings);
+    saveOrbFactors(settings);
 
 }
 
@@ -2207,6 +2220,7 @@ void MainWindow::loadSettings()
     }
 
     AspectSettings::instance().loadFromSettings(settings);
+    loadOrbFactors(settings);
 
 }
 
@@ -2355,8 +2369,14 @@ void MainWindow::getPrediction() {
     // Calculate days between (inclusive)
     int transitDays = fromDate.daysTo(toDate) + 1;
 
-    if (transitDays <= 0 || transitDays > 30) {
-        QMessageBox::warning(this, "Input Error", "Prediction period must be between 1 and 30 days.");
+    // Aspect windows are a line per transit rather than per day, so the
+    // prompt stays small for much longer periods
+    const bool windows = m_transitWindowsCB->isChecked();
+    const int maxPredictionDays = windows ? 366 : 30;
+    if (transitDays <= 0 || transitDays > maxPredictionDays) {
+        QMessageBox::warning(this, "Input Error", windows
+                             ? "Prediction period must be between 1 day and 1 year."
+                             : "Prediction period must be between 1 and 30 days.");
         return;
     }
 
@@ -2370,16 +2390,44 @@ void MainWindow::getPrediction() {
                              .arg(fromDate.toString("yyyy-MM-dd"))
                              .arg(toDate.toString("yyyy-MM-dd")));
 
+    if (windows) {
+        QFuture<QVector<TransitEvent>> job = m_chartDataManager.calculateTransitEventsAsync(
+                    birthDate, birthTime, utcOffset, latitude, longitude,
+                    m_houseSystemCombo->currentText(), fromDate, transitDays);
+
+        watchJob(this, "Calculating transits...", job,
+                 [this, birthDate, birthTime, latitude, longitude, fromDate, transitDays](
+                         const QFuture<QVector<TransitEvent>> &future) {
+            // Errors were already reported through ChartDataManager::error
+            if (future.isCanceled() || !m_chartDataManager.getLastError().isEmpty()
+                    || future.resultCount() == 0) {
+                statusBar()->clearMessage();
+                getPredictionButton->setEnabled(true);
+                return;
+            }
+
+            const QVector<TransitEvent> events = future.result();
+            displayTransitEvents(events);
+            m_mistralApi.interpretTransits(m_chartDataManager.transitEventListToJson(
+                                               events, birthDate, birthTime, latitude, longitude,
+                                               fromDate, transitDays));
+        });
+        return;
+    }
+
     // Calculate transits
-    QJsonObject transitData = m_chartDataManager.calculateTransitsAsJson(
-                birthDate, birthTime, utcOffset, latitude, longitude, fromDate, transitDays);
+    QVector<TransitHit> hits = m_chartDataManager.calculateTransitList(
+                birthDate, birthTime, utcOffset, latitude, longitude,
+                m_houseSystemCombo->currentText(), fromDate, transitDays);
 
     if (m_chartDataManager.getLastError().isEmpty()) {
         //populate tab
-        displayRawTransitData(transitData);
+        displayRawTransitData(hits);
 
         // Send to API for interpretation
-        m_mistralApi.interpretTransits(transitData);
+        m_mistralApi.interpretTransits(m_chartDataManager.transitListToJson(
+                                           hits, birthDate, birthTime, latitude, longitude,
+                                           fromDate, transitDays));
     } else {
         handleError("Transit calculation error: " + m_chartDataManager.getLastError());
         getPredictionButton->setEnabled(true);
@@ -2452,115 +2500,46 @@ void MainWindow::populateInfoOverlay() {
     m_locationLabel->setText(m_googleCoordsEdit->text());
 
     // Add Sun and Ascendant information from chart data
-    if (!m_currentChartData.isEmpty()) {
-        // Get Sun information
-        if (m_currentChartData.contains("planets") && m_currentChartData["planets"].isArray()) {
-            QJsonArray planets = m_currentChartData["planets"].toArray();
-
-            for (const QJsonValue &planetValue : planets) {
-                QJsonObject planet = planetValue.toObject();
-                QString planetId = planet["id"].toString();
-
-                if (planetId.toLower() == "sun") {
-                    QString sunSign = planet["sign"].toString();
-                    double sunDegree = planet["longitude"].toDouble();
-                    //m_sunSignLabel->setText(QString("Sun: %1 %2°").arg(sunSign).arg(sunDegree, 0, 'f', 1));
-                    m_sunSignLabel->setText(QString("Sun: %1").arg(sunSign));
-
-                    break;
-                }
-            }
+    for (const PlanetData &planet : m_currentChart.planets) {
+        if (planet.id.toLower() == "sun") {
+            //m_sunSignLabel->setText(QString("Sun: %1 %2°").arg(planet.sign).arg(planet.longitude, 0, 'f', 1));
+            m_sunSignLabel->setText(QString("Sun: %1").arg(planet.sign));
+            break;
         }
-
-        // Get Ascendant information
-        if (m_currentChartData.contains("angles") && m_currentChartData["angles"].isArray()) {
-            QJsonArray angles = m_currentChartData["angles"].toArray();
-
-            for (const QJsonValue &angleValue : angles) {
-                QJsonObject angle = angleValue.toObject();
-                QString angleId = angle["id"].toString();
-
-                if (angleId.toLower() == "asc") {
-                    QString ascSign = angle["sign"].toString();
-                    double ascDegree = angle["longitude"].toDouble();
-                    //m_ascendantLabel->setText(QString("Asc: %1 %2°").arg(ascSign).arg(ascDegree, 0, 'f', 1));
-                    m_ascendantLabel->setText(QString("Asc: %1").arg(ascSign));
-
-                    break;
-                }
-            }
+    }
+    for (const AngleData &angle : m_currentChart.angles) {
+        if (angle.id.toLower() == "asc") {
+            //m_ascendantLabel->setText(QString("Asc: %1 %2°").arg(angle.sign).arg(angle.longitude, 0, 'f', 1));
+            m_ascendantLabel->setText(QString("Asc: %1").arg(angle.sign));
+            break;
         }
     }
     m_housesystemLabel->setText(m_houseSystemCombo->currentText());
 }
 
-void MainWindow::displayRawTransitData(const QJsonObject &transitData) {
-    QString rawData = transitData["rawTransitData"].toString();
-    rawTransitTable->setRowCount(0);
-
-    QStringList lines = rawData.split('\n', Qt::SkipEmptyParts);
-    bool inTransitsSection = false;
-    QDate currentDate;
-
-    for (const QString &line : lines) {
-        if (line.startsWith("---TRANSITS---")) {
-            inTransitsSection = true;
-            continue;
-        }
-        if (!inTransitsSection) {
-            continue;
-        }
-
-        if (line.contains(QRegularExpression("^\\d{4}/\\d{2}/\\d{2}:"))) {
-            QRegularExpression dateRe("^(\\d{4}/\\d{2}/\\d{2}):");
-            QRegularExpressionMatch dateMatch = dateRe.match(line);
-            if (dateMatch.hasMatch()) {
-                currentDate = QDate::fromString(dateMatch.captured(1), "yyyy/MM/dd");
-            }
-
-            int startPos = line.indexOf(':') + 1;
-            QString aspectsStr = line.mid(startPos).trimmed();
-            QStringList aspects = aspectsStr.split(',', Qt::SkipEmptyParts);
-
-            for (QString aspect : aspects) {
-                aspect = aspect.trimmed();
-                //QRegularExpression aspectRe("((?:North|South) Node|Pars Fortuna|Part of Spirit|East Point|\\w+)(?:\\s+\\(R\\))? (\\w+) ((?:North|South) Node|Pars Fortuna|Part of Spirit|East Point|\\w+)\\( ([\\d.]+)°\\)");
-
-                QRegularExpression aspectRe("((?:North|South) Node|Pars Fortuna|Part of Spirit|East Point|\\w+)(?:\\s+\\(R\\))? (\\w+) ((?:North|South) Node|Pars Fortuna|Part of Spirit|East Point|\\w+(?:\\s+\\(R\\))?)\\( ([\\d.]+)°\\)");
-
-                QRegularExpressionMatch aspectMatch = aspectRe.match(aspect);
-
-                if (aspectMatch.hasMatch()) {
-                    int row = rawTransitTable->rowCount();
-                    rawTransitTable->insertRow(row);
-
-                    QString transitPlanet = aspectMatch.captured(1);
-                    //bool isRetrograde = aspect.contains("(R)");
-                    bool isRetrograde = aspect.contains("(R)") &&
-                            !transitPlanet.contains("Node");
-                    QString natalPlanet = aspectMatch.captured(3);
-
-                    if (transitPlanet == "North Node") transitPlanet = "NNode";
-                    if (transitPlanet == "South Node") transitPlanet = "SNode";
-                    if (transitPlanet == "Pars Fortuna") transitPlanet = "PFortuna";
-                    if (transitPlanet == "Part of Spirit") transitPlanet = "PSpirit";
-                    if (transitPlanet == "East Point") transitPlanet = "EPoint";
+void MainWindow::displayRawTransitData(const QVector<TransitHit> &hits) {
+    m_transitModel->clear();
+    if (rawTransitTable->model() != m_transitProxy) {
+        m_transitEventModel->setEvents({});
+        rawTransitTable->setModel(m_transitProxy);
+        rawTransitTable->horizontalHeader()->setSortIndicator(TransitTableModel::DateColumn, Qt::AscendingOrder);
+    }
+    appendRawTransitData(hits);
+}
 
-                    if (natalPlanet == "North Node") natalPlanet = "NNode";
-                    if (natalPlanet == "South Node") natalPlanet = "SNode";
-                    if (natalPlanet == "Pars Fortuna") natalPlanet = "PFortuna";
-                    if (natalPlanet == "Part of Spirit") natalPlanet = "PSpirit";
-                    if (natalPlanet == "East Point") natalPlanet = "EPoint";
+void MainWindow::appendRawTransitData(const QVector<TransitHit> &hits) {
+    // Each chunk follows the last in date order
+    m_transitModel->appendHits(hits);
+}
 
-                    rawTransitTable->setItem(row, 0, new QTableWidgetItem(currentDate.toString("yyyy-MM-dd")));
-                    rawTransitTable->setItem(row, 1, new QTableWidgetItem(transitPlanet + (isRetrograde ? " (R)" : "")));
-                    rawTransitTable->setItem(row, 2, new QTableWidgetItem(aspectMatch.captured(2)));
-                    rawTransitTable->setItem(row, 3, new QTableWidgetItem(natalPlanet + " (" + aspectMatch.captured(4) + "°)"));
-                }
-            }
-        }
+void MainWindow::displayTransitEvents(const QVector<TransitEvent> &events) {
+    // The daily rows are not needed while the windows are shown
+    m_transitModel->clear();
+    m_transitEventModel->setEvents(events);
+    if (rawTransitTable->model() != m_transitEventProxy) {
+        rawTransitTable->setModel(m_transitEventProxy);
+        rawTransitTable->horizontalHeader()->setSortIndicator(TransitEventTableModel::StartColumn, Qt::AscendingOrder);
     }
-    rawTransitTable->sortItems(0);
 }
 
 void MainWindow::exportChartImage()
@@ -2686,8 +2665,9 @@ void MainWindow::exportAsPdf() {
     currentY += rowHeight;
     pdfPainter.drawLine(tableX, currentY, tableX + tableWidth, currentY);
     
-    if (m_currentChartData.contains("planets") && m_currentChartData["planets"].isArray()) {
-        const QJsonArray planets = m_currentChartData["planets"].toArray();
+    const QJsonObject chartJson = currentChartJson();
+    if (chartJson.contains("planets") && chartJson["planets"].isArray()) {
+        const QJsonArray planets = chartJson["planets"].toArray();
         for (const auto &planetValue : planets) {
             const QJsonObject planet = planetValue.toObject();
             QString planetName = planet["id"].toString();
@@ -2720,8 +2700,8 @@ void MainWindow::exportAsPdf() {
     pdfPainter.drawLine(tableX, currentY, tableX + tableWidth, currentY);
     
     QMap<int, QJsonObject> houseMap;
-    if (m_currentChartData.contains("houses") && m_currentChartData["houses"].isArray()) {
-        for (const auto &houseValue : m_currentChartData["houses"].toArray()) {
+    if (chartJson.contains("houses") && chartJson["houses"].isArray()) {
+        for (const auto &houseValue : chartJson["houses"].toArray()) {
             const QJsonObject house = houseValue.toObject();
             int id = house["id"].toString().mid(5).toInt();  // "house5" -> 5
             houseMap[id] = house;
@@ -2755,7 +2735,7 @@ void MainWindow::exportAsPdf() {
     pdfPainter.drawLine(tableX, currentY, tableX + tableWidth, currentY);
     pdfPainter.setFont(textFont);
     
-    const QJsonArray aspects = m_currentChartData["aspects"].toArray();
+    const QJsonArray aspects = chartJson["aspects"].toArray();
     for (const auto &aspectValue : aspects) {
         if (currentY + rowHeight > pageHeight - margin) {
             pdfWriter.newPage();
@@ -3261,7 +3241,7 @@ void MainWindow::showAspectSettings()
     // If the user accepts the dialog (clicks Save)
     if (dialog.exec() == QDialog::Accepted) {
         if (m_chartCalculated) {
-            displayChart(m_currentChartData);
+            displayChart(m_currentChart);
         }
     }
 }
@@ -3510,54 +3490,33 @@ void MainWindow::createCompositeChart() {
     // Copy aspects from first chart (this is a simplification)
     // In a real implementation, you would recalculate aspects between composite planets
     QJsonArray compositeAspects;
-    // Define aspect types and their orbs
-    struct AspectType {
-        QString name;
-        double angle;
-        double orb;
-    };
-    double orbMax = getOrbMax();
-    QVector<AspectType> aspectTypes = {
-        {"CON", 0.0, orbMax},      // Conjunction
-        {"OPP", 180.0, orbMax},    // Opposition
-        {"TRI", 120.0, orbMax},    // Trine
-        {"SQR", 90.0, orbMax},     // Square
-        {"SEX", 60.0, orbMax},     // Sextile
-        {"QUI", 150.0, orbMax * 0.75},  // Quintile
-        {"SSQ", 45.0, orbMax * 0.75},  // Semi-square
-        {"SQQ", 135.0, orbMax * 0.75}, // Sesquiquadrate
-
-
-        {"SSX", 30.0, orbMax * 0.75}   // Semi-sextile
-    };
-
-    // Check for aspects between each pair of planets
+    QVector<double> compositeLongitudes;
+    QVector<Body> compositeBodies;
+    QVector<QString> compositeIds;
     for (int i = 0; i < compositePlanets.size(); i++) {
-        QJsonObject planet1 = compositePlanets[i].toObject();
-        for (int j = i + 1; j < compositePlanets.size(); j++) {
-            QJsonObject planet2 = compositePlanets[j].toObject();
-            double long1 = planet1["longitude"].toDouble();
-            double long2 = planet2["longitude"].toDouble();
-            // Calculate the angular distance between planets
-            double distance = fabs(long1 - long2);
-            if (distance > 180.0) distance = 360.0 - distance;
-            // Check if this distance matches any aspect type
-            for (const AspectType &aspectType : aspectTypes) {
-                double orb = fabs(distance - aspectType.angle);
-                if (orb <= aspectType.orb) {
-                    // Create aspect object
-                    QJsonObject aspect;
-                    aspect["planet1"] = planet1["id"].toString();
-                    aspect["planet2"] = planet2["id"].toString();
-                    aspect["aspectType"] = aspectType.name;  // Use "aspectType" not "type"
-                    aspect["orb"] = orb;
-                    compositeAspects.append(aspect);
-                    break; // Only record the closest matching aspect
-                }
-            }
+        QJsonObject planet = compositePlanets[i].toObject();
+        Body body;
+        if (bodyFromName(planet["id"].toString(), &body)) {
+            compositeLongitudes.append(planet["longitude"].toDouble());
+            compositeBodies.append(body);
+            compositeIds.append(planet["id"].toString());
         }
     }
 
+    // Same kernel and orbs as the natal aspects; each pair keeps its tightest aspect
+    AspectKernel kernel(CalculationOptions::fromGlobals().orbs);
+    const QVector<AspectHit> hits = kernel.findWithin(compositeLongitudes.constData(),
+                                                      compositeBodies.constData(),
+                                                      compositeLongitudes.size());
+    for (const AspectHit &hit : hits) {
+        QJsonObject aspect;
+        aspect["planet1"] = compositeIds[hit.first];
+        aspect["planet2"] = compositeIds[hit.second];
+        aspect["aspectType"] = aspectCode(hit.aspect);  // Use "aspectType" not "type"
+        aspect["orb"] = hit.orb;
+        compositeAspects.append(aspect);
+    }
+
     // Update the composite chart data with the calculated aspects
     compositeChartData["aspects"] = compositeAspects;
 
@@ -3675,8 +3634,8 @@ void MainWindow::createCompositeChart() {
     m_googleCoordsEdit->setText(compositeGoogleCoords);  // Use the formatted Google coordinates
 
     // Display the chart
-    m_currentChartData = compositeChartData;
-    displayChart(compositeChartData);
+    setCurrentChartJson(compositeChartData);
+    displayChart(m_currentChart);
     m_chartCalculated = true;
     GlobalFlags::lastGeneratedChartType = "Composite Relationship";
     populateInfoOverlay();
@@ -3924,7 +3883,7 @@ void MainWindow::createDavisonChart() {
     davisonBirthInfo["googleCoords"] = googleCoords;
     //m_googleCoordsEdit->setText(googleCoords);
     QJsonObject saveData;
-    saveData["chartData"] = m_currentChartData;
+    saveData["chartData"] = currentChartJson();
     saveData["birthInfo"] = davisonBirthInfo;
     saveData["relationshipInfo"] = relationshipInfo;  // ← THIS is the only required addition
 
@@ -3949,7 +3908,7 @@ void MainWindow::createDavisonChart() {
         QMessageBox::warning(this, "Save Failed", "Could not save Davison chart to:\n" + outputFilePath);
     }
 
-    displayChart(m_currentChartData);
+    displayChart(m_currentChart);
     m_chartCalculated = true;
     GlobalFlags::lastGeneratedChartType = "Davison Relationship";
 
@@ -4329,49 +4288,71 @@ void MainWindow::CalculateTransits() {
     // Calculate days between (inclusive)
     int transitDays = fromDate.daysTo(toDate) + 1;
 
-    if (transitDays <= 0 || transitDays > 370) {
-        QMessageBox::warning(this, "Input Error", "Prediction period must be between 1 and 370 days.");
+    // Results are kept on disk; the bound only guards against typos
+    const int maxTransitDays = 100 * 366;
+    if (transitDays <= 0 || transitDays > maxTransitDays) {
+        QMessageBox::warning(this, "Input Error", "Prediction period must be between 1 day and 100 years.");
         return;
     }
 
-    if (transitDays > 60) {
-        QMessageBox::information(
-                    this,
-                    "Please Be Patient",
-                    "This operation may take some time.\n"
-
-                    " When finished you will be notified."
-                    );
-    }
-
-
     // Update status
     statusBar()->showMessage(QString("Calculating transits for %1 to %2...")
                              .arg(fromDate.toString("yyyy-MM-dd"))
                              .arg(toDate.toString("yyyy-MM-dd")));
 
-    // Calculate transits
-    this->setEnabled(false); // Disable all widgets in the main window
+    if (m_transitWindowsCB->isChecked()) {
+        QFuture<QVector<TransitEvent>> job = m_chartDataManager.calculateTransitEventsAsync(
+                    birthDate, birthTime, utcOffset, latitude, longitude,
+                    m_houseSystemCombo->currentText(), fromDate, transitDays);
+
+        watchJob(this, "Calculating transits...", job, [this](const QFuture<QVector<TransitEvent>> &future) {
+            if (future.isCanceled()) {
+                statusBar()->showMessage("Transit calculation cancelled", 3000);
+                return;
+            }
+            // Errors were already reported through ChartDataManager::error
+            if (!m_chartDataManager.getLastError().isEmpty() || future.resultCount() == 0) {
+                return;
+            }
 
-    QJsonObject transitData = m_chartDataManager.calculateTransitsAsJson(
-                birthDate, birthTime, utcOffset, latitude, longitude, fromDate, transitDays);
+            displayTransitEvents(future.result());
+            statusBar()->clearMessage();
+            QMessageBox::information(this, "Transit Data", "Transit data has been generated successfully.\n"
+                                                           "Please Navigate to the 'Raw Transit Data Table' to view the data.\n"
+                                                           "You may use 'Tools->Transit Filter' for advanced filtering.");
+        });
+        return;
+    }
 
-    this->setEnabled(true); // Enable all widgets in the main window
+    // Calculate transits in the background; rows appear a week at a time
+    // while the dialog shows the days done. They go straight into the
+    // file-backed transit store, so the range is not limited by memory.
+    displayRawTransitData({});
+    QFuture<void> job = m_chartDataManager.streamTransitListAsync(
+                birthDate, birthTime, utcOffset, latitude, longitude,
+                m_houseSystemCombo->currentText(), fromDate, transitDays,
+                [this](const QVector<TransitHit> &chunk) {
+        appendRawTransitData(chunk);
+    });
 
+    watchJob(this, "Calculating transits...", job, [this](const QFuture<void> &future) {
+        // Rows delivered before a cancel or an error stay in the table
+        m_transitProxy->mergeAppendedRows();
+        if (future.isCanceled()) {
+            statusBar()->showMessage(QString("Transit calculation cancelled, %1 transits shown")
+                                     .arg(m_transitModel->rowCount()), 3000);
+            return;
+        }
+        // Errors were already reported through ChartDataManager::error
+        if (!m_chartDataManager.getLastError().isEmpty()) {
+            return;
+        }
 
-    if (m_chartDataManager.getLastError().isEmpty()) {
-        //populate tab
-        displayRawTransitData(transitData);
+        statusBar()->clearMessage();
         QMessageBox::information(this, "Transit Data", "Transit data has been generated successfully.\n"
                                                        "Please Navigate to the 'Raw Transit Data Table' to view the data.\n"
                                                        "You may use 'Tools->Transit Filter' for advanced filtering.");
-
-
-    } else {
-        handleError("Transit calculation error: " + m_chartDataManager.getLastError());
-
-    }
-
+    });
 }
 
 
@@ -4383,82 +4364,24 @@ void MainWindow::applyTransitFilter(const QString &datePattern,
 
                                     const QString &excludePattern)
 {
-    // Show "Applying filter..." before starting
-    if (m_transitSearchDialog && m_transitSearchDialog->statusLabel) {
-        m_transitSearchDialog->statusLabel->setText("Please wait...");
-        qApp->processEvents();
-    }
     // Save current state
     m_savedScrollPosition = rawTransitTable->verticalScrollBar()->value();
     m_savedSelection = rawTransitTable->selectionModel()->selection();
 
-    int matchCount = 0;
-
-    for(int row = 0; row < rawTransitTable->rowCount(); ++row) {
-        bool match = true;
-
-        // Apply include filters
-        if(!datePattern.isEmpty()) {
-            match &= rawTransitTable->item(row, 0)->text().contains(QRegularExpression(datePattern, QRegularExpression::CaseInsensitiveOption));
-        }
-        if(match && !transitPattern.isEmpty()) {
-            match &= rawTransitTable->item(row, 1)->text().contains(QRegularExpression(transitPattern, QRegularExpression::CaseInsensitiveOption));
-        }
-        if(match && !aspectPattern.isEmpty()) {
-            match &= rawTransitTable->item(row, 2)->text().contains(QRegularExpression(aspectPattern, QRegularExpression::CaseInsensitiveOption));
-        }
-        if(match && !natalPattern.isEmpty()) {
-            match &= rawTransitTable->item(row, 3)->text().contains(QRegularExpression(natalPattern, QRegularExpression::CaseInsensitiveOption));
-        }
-        // Orb Filter
-        if (match && !maxOrbPattern.isEmpty()) {
-            bool ok = false;
-            double maxOrb = maxOrbPattern.toDouble(&ok);
-            if (ok) {
-                // Extract orb from natal planet column (column 3)
-                QString natalText = rawTransitTable->item(row, 3)->text();
-                QRegularExpression orbRegex("\\((\\d+(?:\\.\\d+)?)°\\)");
-                QRegularExpressionMatch orbMatch = orbRegex.match(natalText);
-                if (orbMatch.hasMatch()) {
-                    double orbValue = orbMatch.captured(1).toDouble();
-                    if (orbValue > maxOrb) {
-                        match = false;
-                    }
-                }
-                // If no orb found, you may want to hide or show by default:
-                // else { match = false; } // Uncomment to hide rows without orb info
-            }
-        }
-
-
-        //
-        // Apply exclude filter
-        if(match && !excludePattern.isEmpty()) {
-            QStringList excludeTerms = excludePattern.split(',', Qt::SkipEmptyParts);
-            for(const QString &term : excludeTerms) {
-                QString trimmedTerm = term.trimmed();
-                if(!trimmedTerm.isEmpty()) {
-                    // Check if any column contains the exclude term
-                    bool containsExcludeTerm =
-                            rawTransitTable->item(row, 0)->text().contains(trimmedTerm, Qt::CaseInsensitive) ||
-                            rawTransitTable->item(row, 1)->text().contains(trimmedTerm, Qt::CaseInsensitive) ||
-                            rawTransitTable->item(row, 2)->text().contains(trimmedTerm, Qt::CaseInsensitive) ||
-                            rawTransitTable->item(row, 3)->text().contains(trimmedTerm, Qt::CaseInsensitive);
-
-                    if(containsExcludeTerm) {
-                        match = false;
-                        break; // No need to check other exclude terms
-                    }
-                }
-            }
-        }
-
-        rawTransitTable->setRowHidden(row, !match);
-        if(match) matchCount++;
-    }
-    // Show "Filter applied" after finishing
+    // The proxies compile the patterns once; the daily one filters through
+    // the indexes. Both get the filter, so it still holds after the table
+    // switches between daily rows and aspect windows.
+    m_transitProxy->setFilter(datePattern, transitPattern, aspectPattern,
+                              natalPattern, maxOrbPattern, excludePattern);
+    m_transitEventProxy->setFilter(datePattern, transitPattern, aspectPattern,
+                                   natalPattern, maxOrbPattern, excludePattern);
+    const bool windows = rawTransitTable->model() == m_transitEventProxy;
+    // Show how many transits passed
     if (m_transitSearchDialog && m_transitSearchDialog->statusLabel)
-        m_transitSearchDialog->statusLabel->setText("Filter applied");
+        m_transitSearchDialog->statusLabel->setText(QString("%1 of %2 transits")
+                                                    .arg(rawTransitTable->model()->rowCount())
+                                                    .arg(windows ? m_transitEventModel->rowCount()
+                                                                 : m_transitModel->rowCount()));
 }
 
 
@@ -4503,7 +4426,8 @@ void MainWindow::exportChartData(){
         for (int tabIndex = 0; tabIndex < detailsTabs->count(); ++tabIndex) {
             QWidget *tabWidget = detailsTabs->widget(tabIndex);
             QString tabName = detailsTabs->tabText(tabIndex).toUpper();
-            QTableWidget *table = qobject_cast<QTableWidget*>(tabWidget);
+            QTableView *view = qobject_cast<QTableView*>(tabWidget);
+            QAbstractItemModel *table = view ? view->model() : nullptr;
 
             if (!table || table->rowCount() == 0) {
                 continue; // Skip empty tables
@@ -4516,7 +4440,7 @@ void MainWindow::exportChartData(){
             // Write column headers
             QStringList headers;
             for (int col = 0; col < table->columnCount(); ++col) {
-                headers << table->horizontalHeaderItem(col)->text();
+                headers << table->headerData(col, Qt::Horizontal).toString();
             }
 
             // Calculate column widths for alignment
@@ -4524,10 +4448,7 @@ void MainWindow::exportChartData(){
             for (int col = 0; col < table->columnCount(); ++col) {
                 int maxWidth = headers[col].length();
                 for (int row = 0; row < table->rowCount(); ++row) {
-                    QTableWidgetItem *item = table->item(row, col);
-                    if (item) {
-                        maxWidth = qMax(maxWidth, item->text().length());
-                    }
+                    maxWidth = qMax(maxWidth, table->index(row, col).data().toString().length());
                 }
                 columnWidths << qMax(maxWidth + 2, 8); // Minimum width of 8
             }
@@ -4547,8 +4468,7 @@ void MainWindow::exportChartData(){
             // Write table data
             for (int row = 0; row < table->rowCount(); ++row) {
                 for (int col = 0; col < table->columnCount(); ++col) {
-                    QTableWidgetItem *item = table->item(row, col);
-                    QString cellText = item ? item->text() : "";
+                    QString cellText = table->index(row, col).data().toString();
                     stream << cellText.leftJustified(columnWidths[col]);
                 }
                 stream << "\n";
@@ -4605,16 +4525,24 @@ void MainWindow::CalculateEclipses()
                              .arg(fromDate.toString("yyyy-MM-dd"))
                              .arg(toDate.toString("yyyy-MM-dd")));
 
-    QJsonArray eclipseData = m_chartDataManager.calculateEclipsesAsJson(
+    QFuture<QJsonArray> job = m_chartDataManager.calculateEclipsesAsJsonAsync(
                 fromDate, toDate, solarEclipses, lunarEclipses);
 
-    if (m_chartDataManager.getLastError().isEmpty()) {
-        displayRawEclipseData(eclipseData);
+    watchJob(this, "Searching for eclipses...", job, [this](const QFuture<QJsonArray> &future) {
+        if (future.isCanceled()) {
+            statusBar()->showMessage("Eclipse search cancelled", 3000);
+            return;
+        }
+        // Errors were already reported through ChartDataManager::error
+        if (!m_chartDataManager.getLastError().isEmpty() || future.resultCount() == 0) {
+            return;
+        }
+
+        displayRawEclipseData(future.result());
+        statusBar()->clearMessage();
         QMessageBox::information(this, "Eclipse Data", "Eclipse data has been generated successfully.\n"
                                                        "Please navigate to 'Chart Details->Eclipses' tab tp view the data.");
-    } else {
-        handleError("Eclipse calculation error: " + m_chartDataManager.getLastError());
-    }
+    });
 }
 
 void MainWindow::displayRawEclipseData(const QJsonArray &eclipseData)
@@ -4723,20 +4651,20 @@ void MainWindow::doSolarReturnCalculation(const QDate& birthDate, const QTime& b
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject(); // Reset relationship info
     m_chartRenderer->scene()->clear();
 
     // Calculate solar return chart
     QDate chartDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
 
-    m_currentChartData = m_chartDataManager.calculateSolarReturnAsJson(
+    setCurrentChart(m_chartDataManager.calculateSolarReturn(
                 birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, year
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
 
         GlobalFlags::lastGeneratedChartType = "Solar Return";
@@ -4755,9 +4683,9 @@ void MainWindow::doSolarReturnCalculation(const QDate& birthDate, const QTime& b
         setWindowTitle("Asteria - Solar Return Chart");
 
 
-        QString dateStr = m_currentChartData.value("returnDate").toString();
-        QString timeStr = m_currentChartData.value("returnTime").toString();
-        QString jdStr   = m_currentChartData.value("returnJulianDay").toString();
+        QString dateStr = m_currentChart.returnDate.toString("dd/MM/yyyy");
+        QString timeStr = m_currentChart.returnTime.toString("HH:mm");
+        QString jdStr   = QString::number(m_currentChart.returnJulianDay, 'f', 6);
 
         QString infoText = QString(
                     "Solar Return Year: %1\n"
@@ -4874,20 +4802,20 @@ void MainWindow::doLunarReturnCalculation(const QDate& birthDate, const QTime& b
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject(); // Reset relationship info
     m_chartRenderer->scene()->clear();
 
     // Calculate lunar return chart
     QDate chartDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
 
-    m_currentChartData = m_chartDataManager.calculateLunarReturnAsJson(
+    setCurrentChart(m_chartDataManager.calculateLunarReturn(
                 birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, targetDate
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         // Set chart type for interpretation
         GlobalFlags::lastGeneratedChartType = "Lunar Return";
@@ -4906,9 +4834,9 @@ void MainWindow::doLunarReturnCalculation(const QDate& birthDate, const QTime& b
 
 
 
-        QString dateStr = m_currentChartData.value("returnDate").toString();
-        QString timeStr = m_currentChartData.value("returnTime").toString();
-        QString jdStr   = m_currentChartData.value("returnJulianDay").toString();
+        QString dateStr = m_currentChart.returnDate.toString("dd/MM/yyyy");
+        QString timeStr = m_currentChart.returnTime.toString("HH:mm");
+        QString jdStr   = QString::number(m_currentChart.returnJulianDay, 'f', 6);
 
         QString infoText = QString(
                     "Lunar Return Moment\n"
@@ -5023,7 +4951,7 @@ void MainWindow::doSaturnReturnCalculation(const QDate& birthDate, const QTime&
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject();
     m_chartRenderer->scene()->clear();
 
@@ -5033,13 +4961,13 @@ void MainWindow::doSaturnReturnCalculation(const QDate& birthDate, const QTime&
     QDate chartDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
 
 
-    m_currentChartData = m_chartDataManager.calculateSaturnReturnAsJson(
+    setCurrentChart(m_chartDataManager.calculateSaturnReturn(
                 chartDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         GlobalFlags::lastGeneratedChartType = "Saturn Return";
         m_getInterpretationButton->setEnabled(true);
@@ -5054,9 +4982,9 @@ void MainWindow::doSaturnReturnCalculation(const QDate& birthDate, const QTime&
         statusBar()->showMessage("Saturn return chart calculated successfully", 3000);
         setWindowTitle("Asteria - Saturn Return Chart");
 
-        QString dateStr = m_currentChartData.value("returnDate").toString();
-        QString timeStr = m_currentChartData.value("returnTime").toString();
-        QString jdStr = m_currentChartData.value("returnJulianDay").toString();
+        QString dateStr = m_currentChart.returnDate.toString("dd/MM/yyyy");
+        QString timeStr = m_currentChart.returnTime.toString("HH:mm");
+        QString jdStr = QString::number(m_currentChart.returnJulianDay, 'f', 6);
 
         QString infoText = QString(
                     "Saturn Return %1\n"
@@ -5168,20 +5096,20 @@ void MainWindow::doJupiterReturnCalculation(const QDate& birthDate, const QTime&
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject();
     m_chartRenderer->scene()->clear();
 
     // Calculate Jupiter return chart
     QDate chartDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
 
-    m_currentChartData = m_chartDataManager.calculateJupiterReturnAsJson(
+    setCurrentChart(m_chartDataManager.calculateJupiterReturn(
                 birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         GlobalFlags::lastGeneratedChartType = "Jupiter Return";
         m_getInterpretationButton->setEnabled(true);
@@ -5191,9 +5119,9 @@ void MainWindow::doJupiterReturnCalculation(const QDate& birthDate, const QTime&
         statusBar()->showMessage("Jupiter return chart calculated successfully", 3000);
         setWindowTitle("Asteria - Jupiter Return Chart");
 
-        QString dateStr = m_currentChartData.value("returnDate").toString();
-        QString timeStr = m_currentChartData.value("returnTime").toString();
-        QString jdStr = m_currentChartData.value("returnJulianDay").toString();
+        QString dateStr = m_currentChart.returnDate.toString("dd/MM/yyyy");
+        QString timeStr = m_currentChart.returnTime.toString("HH:mm");
+        QString jdStr = QString::number(m_currentChart.returnJulianDay, 'f', 6);
 
         QString infoText = QString(
                     "Jupiter Return %1\n"
@@ -5302,20 +5230,20 @@ void MainWindow::doVenusReturnCalculation(const QDate& birthDate, const QTime& b
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject();
     m_chartRenderer->scene()->clear();
 
     // Calculate Venus return chart
     QDate chartDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
 
-    m_currentChartData = m_chartDataManager.calculateVenusReturnAsJson(
+    setCurrentChart(m_chartDataManager.calculateVenusReturn(
                 birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         GlobalFlags::lastGeneratedChartType = "Venus Return";
         m_getInterpretationButton->setEnabled(true);
@@ -5324,9 +5252,9 @@ void MainWindow::doVenusReturnCalculation(const QDate& birthDate, const QTime& b
         statusBar()->showMessage("Venus return chart calculated successfully", 3000);
         setWindowTitle("Asteria - Venus Return Chart");
 
-        QString dateStr = m_currentChartData.value("returnDate").toString();
-        QString timeStr = m_currentChartData.value("returnTime").toString();
-        QString jdStr = m_currentChartData.value("returnJulianDay").toString();
+        QString dateStr = m_currentChart.returnDate.toString("dd/MM/yyyy");
+        QString timeStr = m_currentChart.returnTime.toString("HH:mm");
+        QString jdStr = QString::number(m_currentChart.returnJulianDay, 'f', 6);
 
         QString infoText = QString(
                     "Venus Return %1\n"
@@ -5434,20 +5362,20 @@ void MainWindow::doMarsReturnCalculation(const QDate& birthDate, const QTime& bi
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject();
     m_chartRenderer->scene()->clear();
 
     // Calculate Mars return chart
     QDate chartDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
 
-    m_currentChartData = m_chartDataManager.calculateMarsReturnAsJson(
+    setCurrentChart(m_chartDataManager.calculateMarsReturn(
                 birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         GlobalFlags::lastGeneratedChartType = "Mars Return";
         m_getInterpretationButton->setEnabled(true);
@@ -5456,9 +5384,9 @@ void MainWindow::doMarsReturnCalculation(const QDate& birthDate, const QTime& bi
         statusBar()->showMessage("Mars return chart calculated successfully", 3000);
         setWindowTitle("Asteria - Mars Return Chart");
 
-        QString dateStr = m_currentChartData.value("returnDate").toString();
-        QString timeStr = m_currentChartData.value("returnTime").toString();
-        QString jdStr = m_currentChartData.value("returnJulianDay").toString();
+        QString dateStr = m_currentChart.returnDate.toString("dd/MM/yyyy");
+        QString timeStr = m_currentChart.returnTime.toString("HH:mm");
+        QString jdStr = QString::number(m_currentChart.returnJulianDay, 'f', 6);
 
         QString infoText = QString(
                     "Mars Return %1\n"
@@ -5566,20 +5494,20 @@ void MainWindow::doMercuryReturnCalculation(const QDate& birthDate, const QTime&
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject();
     m_chartRenderer->scene()->clear();
 
     // Calculate Mercury return chart
     QDate chartDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
 
-    m_currentChartData = m_chartDataManager.calculateMercuryReturnAsJson(
+    setCurrentChart(m_chartDataManager.calculateMercuryReturn(
                 birthDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         GlobalFlags::lastGeneratedChartType = "Mercury Return";
         m_getInterpretationButton->setEnabled(true);
@@ -5588,9 +5516,9 @@ void MainWindow::doMercuryReturnCalculation(const QDate& birthDate, const QTime&
         statusBar()->showMessage("Mercury return chart calculated successfully", 3000);
         setWindowTitle("Asteria - Mercury Return Chart");
 
-        QString dateStr = m_currentChartData.value("returnDate").toString();
-        QString timeStr = m_currentChartData.value("returnTime").toString();
-        QString jdStr = m_currentChartData.value("returnJulianDay").toString();
+        QString dateStr = m_currentChart.returnDate.toString("dd/MM/yyyy");
+        QString timeStr = m_currentChart.returnTime.toString("HH:mm");
+        QString jdStr = QString::number(m_currentChart.returnJulianDay, 'f', 6);
 
         QString infoText = QString(
                     "Mercury Return %1\n"
@@ -5736,17 +5664,17 @@ void MainWindow::doUranusReturnCalculation(const QDate& birthDate, const QTime&
     }
 
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject();
     m_chartRenderer->scene()->clear();
 
     QDate chartDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
-    m_currentChartData = m_chartDataManager.calculateUranusReturnAsJson(
+    setCurrentChart(m_chartDataManager.calculateUranusReturn(
                 chartDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         GlobalFlags::lastGeneratedChartType = "Uranus Return";
         m_getInterpretationButton->setEnabled(true);
@@ -5756,9 +5684,9 @@ void MainWindow::doUranusReturnCalculation(const QDate& birthDate, const QTime&
         statusBar()->showMessage("Uranus return chart calculated successfully", 3000);
         setWindowTitle("Asteria - Uranus Return Chart");
 
-        QString dateStr = m_currentChartData.value("returnDate").toString();
-        QString timeStr = m_currentChartData.value("returnTime").toString();
-        QString jdStr = m_currentChartData.value("returnJulianDay").toString();
+        QString dateStr = m_currentChart.returnDate.toString("dd/MM/yyyy");
+        QString timeStr = m_currentChart.returnTime.toString("HH:mm");
+        QString jdStr = QString::number(m_currentChart.returnJulianDay, 'f', 6);
 
         QString infoText = QString(
                     "Uranus Return %1\n"
@@ -5853,17 +5781,17 @@ void MainWindow::doNeptuneReturnCalculation(const QDate& birthDate, const QTime&
     }
 
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject();
     m_chartRenderer->scene()->clear();
 
     QDate chartDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
-    m_currentChartData = m_chartDataManager.calculateNeptuneReturnAsJson(
+    setCurrentChart(m_chartDataManager.calculateNeptuneReturn(
                 chartDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         GlobalFlags::lastGeneratedChartType = "Neptune Return";
         m_getInterpretationButton->setEnabled(true);
@@ -5873,9 +5801,9 @@ void MainWindow::doNeptuneReturnCalculation(const QDate& birthDate, const QTime&
         statusBar()->showMessage("Neptune return chart calculated successfully", 3000);
         setWindowTitle("Asteria - Neptune Return Chart");
 
-        QString dateStr = m_currentChartData.value("returnDate").toString();
-        QString timeStr = m_currentChartData.value("returnTime").toString();
-        QString jdStr = m_currentChartData.value("returnJulianDay").toString();
+        QString dateStr = m_currentChart.returnDate.toString("dd/MM/yyyy");
+        QString timeStr = m_currentChart.returnTime.toString("HH:mm");
+        QString jdStr = QString::number(m_currentChart.returnJulianDay, 'f', 6);
 
         QString infoText = QString(
                     "Neptune Return %1\n"
@@ -5970,17 +5898,17 @@ void MainWindow::doPlutoReturnCalculation(const QDate& birthDate, const QTime& b
     }
 
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject();
     m_chartRenderer->scene()->clear();
 
     QDate chartDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
-    m_currentChartData = m_chartDataManager.calculatePlutoReturnAsJson(
+    setCurrentChart(m_chartDataManager.calculatePlutoReturn(
                 chartDate, birthTime, utcOffset, latitude, longitude, houseSystem, returnNumber
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         GlobalFlags::lastGeneratedChartType = "Pluto Return";
         m_getInterpretationButton->setEnabled(true);
@@ -5990,9 +5918,9 @@ void MainWindow::doPlutoReturnCalculation(const QDate& birthDate, const QTime& b
         statusBar()->showMessage("Pluto return chart calculated successfully", 3000);
         setWindowTitle("Asteria - Pluto Return Chart");
 
-        QString dateStr = m_currentChartData.value("returnDate").toString();
-        QString timeStr = m_currentChartData.value("returnTime").toString();
-        QString jdStr = m_currentChartData.value("returnJulianDay").toString();
+        QString dateStr = m_currentChart.returnDate.toString("dd/MM/yyyy");
+        QString timeStr = m_currentChart.returnTime.toString("HH:mm");
+        QString jdStr = QString::number(m_currentChart.returnJulianDay, 'f', 6);
 
         QString infoText = QString(
                     "Pluto Return %1\n"
@@ -6096,18 +6024,18 @@ void MainWindow::doSecondaryProgressionCalculation(int progressionYear)
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject();
     m_chartRenderer->scene()->clear();
 
     progressedDate = checkAndConvertJulian(progressedDate, useJulianForPre1582Action->isChecked());
 
-    m_currentChartData = m_chartDataManager.calculateChartAsJson(
+    setCurrentChart(m_chartDataManager.calculateChart(
                 progressedDate, birthTime, utcOffset, latitude, longitude, houseSystem
-                );
+                ));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
         GlobalFlags::lastGeneratedChartType = "Secondary Progression";
         m_getInterpretationButton->setEnabled(true);
@@ -6120,8 +6048,8 @@ void MainWindow::doSecondaryProgressionCalculation(int progressionYear)
 
         statusBar()->showMessage("Secondary progression chart calculated successfully", 3000);
 
-        QString dateStr = m_currentChartData.value("date").toString();
-        QString timeStr = m_currentChartData.value("time").toString();
+        QString dateStr = progressedDate.toString("dd/MM/yyyy");
+        QString timeStr = birthTime.toString("HH:mm");
         QString infoText = QString(
                     "Secondary Progression Chart\n"
                     "Progressed Date: %1\n"
@@ -6498,7 +6426,7 @@ void MainWindow::startChartDrag()
         inputData["interpretationText"] = m_interpretationtextEdit->toPlainText();
     }
 
-    inputData["chartData"] = m_currentChartData;
+    inputData["chartData"] = currentChartJson();
 
     // Create MIME data for drag
     QMimeData *mimeData = new QMimeData();
@@ -6566,11 +6494,10 @@ void MainWindow::importChartInputData(const QJsonObject &inputData)
     }
 
     // Always use the pre-calculated chart data - call displayChart directly!
-    QJsonObject chartData = inputData["chartData"].toObject();
-    displayChart(chartData);
+    setCurrentChartJson(inputData["chartData"].toObject());
+    displayChart(m_currentChart);
 
     m_chartCalculated = true;
-    m_currentChartData = chartData;
     statusBar()->showMessage("Chart imported via drag & drop", 3000);
     setWindowTitle("Asteria - " + GlobalFlags::lastGeneratedChartType + " Chart");
 
@@ -6643,7 +6570,7 @@ void MainWindow::calculateCurrentChart()
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject(); // Reset relationship info
     m_chartRenderer->scene()->clear();
 
@@ -6653,13 +6580,13 @@ void MainWindow::calculateCurrentChart()
 
     birthDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
 
-    m_currentChartData = m_chartDataManager.calculateChartAsJson(
-                birthDate, birthTime, utcOffset, latitude, longitude, houseSystem);
+    setCurrentChart(m_chartDataManager.calculateChart(
+                birthDate, birthTime, utcOffset, latitude, longitude, houseSystem));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
 
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
 
         // Fill name fields with no/ name
@@ -6706,7 +6633,7 @@ void MainWindow::calculateCurrentChart()
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject(); // Reset relationship info
     m_chartRenderer->scene()->clear();
 
@@ -6715,13 +6642,13 @@ void MainWindow::calculateCurrentChart()
     QTime birthTime = currentTime;
 
     // Calculate chart
-    m_currentChartData = m_chartDataManager.calculateChartAsJson(
-                birthDate, birthTime, utcOffset, latitude, longitude, houseSystem);
+    setCurrentChart(m_chartDataManager.calculateChart(
+                birthDate, birthTime, utcOffset, latitude, longitude, houseSystem));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
 
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
 
         // Fill name and date/time fields
@@ -6791,7 +6718,7 @@ void MainWindow::calculateZodiacSignsChart()
 
     // Reset chart state before new calculation
     m_chartCalculated = false;
-    m_currentChartData = QJsonObject();
+    clearCurrentChart();
     m_currentRelationshipInfo = QJsonObject(); // Reset relationship info
 
     m_chartRenderer->scene()->clear();
@@ -6799,12 +6726,12 @@ void MainWindow::calculateZodiacSignsChart()
     // Calculate chart
     birthDate = checkAndConvertJulian(birthDate, useJulianForPre1582Action->isChecked());
 
-    m_currentChartData = m_chartDataManager.calculateChartAsJson(
-                birthDate, birthTime, utcOffset, latitude, longitude, houseSystem);
+    setCurrentChart(m_chartDataManager.calculateChart(
+                birthDate, birthTime, utcOffset, latitude, longitude, houseSystem));
 
     if (m_chartDataManager.getLastError().isEmpty()) {
         // Display chart
-        displayChart(m_currentChartData);
+        displayChart(m_currentChart);
         m_chartCalculated = true;
 
         // Set default name fields
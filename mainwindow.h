@@ -52,6 +52,8 @@
 #include"osmmapdialog.h"
 #include<QItemSelection>
 #include "transitsearchdialog.h"
+#include "transittablemodel.h"
+#include <QTableView>
 #include<QJsonArray>
 #include<QJsonDocument>
 #include<QJsonObject>
@@ -80,7 +82,7 @@ public:
 private slots:
     // Chart calculation and display
     void calculateChart();
-    void displayChart(const QJsonObject &chartData);
+    void displayChart(const ChartData &chart);
 
     // AI interpretation
     void getInterpretation();
@@ -143,7 +145,10 @@ private:
     // Data managers
     ChartDataManager m_chartDataManager;
     MistralAPI m_mistralApi;
-    // Current chart data
+    // Current chart data. m_currentChart is what the views show; the JSON
+    // form is made from it only when a chart is saved, exported or sent to
+    // the AI (see currentChartJson()).
+    ChartData m_currentChart;
     QJsonObject m_currentChartData;
     QString m_currentInterpretation;
     bool m_chartCalculated;
@@ -157,10 +162,20 @@ protected:
     void dragMoveEvent(QDragMoveEvent *event) override;
     void dropEvent(QDropEvent *event) override;
 private slots:
-    void updateChartDetailsTables(const QJsonObject &chartData);
+    void updateChartDetailsTables(const ChartData &chart);
 private:
     // Helper method to convert QJsonObject to ChartData
     ChartData convertJsonToChartData(const QJsonObject &jsonData);
+
+    // Make a calculated chart the current one; its JSON is built on demand
+    void setCurrentChart(const ChartData &chart);
+    // Same for a chart that comes as JSON (a saved file, a drop, a composite)
+    void setCurrentChartJson(const QJsonObject &chartData);
+    void clearCurrentChart();
+    QJsonObject currentChartJson();
+
+    // The chart without the additional bodies when they are switched off
+    ChartData visibleChart(const ChartData &chart) const;
     // Existing members...
     PlanetListWidget *m_planetListWidget;
     AspectarianWidget *m_aspectarianWidget;
@@ -168,8 +183,17 @@ private:
     QLineEdit* m_predictiveFromEdit;
     QLineEdit* m_predictiveToEdit;
     QPushButton *getPredictionButton;
-    QTableWidget *rawTransitTable;
-    void displayRawTransitData(const QJsonObject &transitData);
+    QTableView *rawTransitTable;
+    void displayRawTransitData(const QVector<TransitHit> &hits);
+    void appendRawTransitData(const QVector<TransitHit> &hits);
+    void displayTransitEvents(const QVector<TransitEvent> &events);
+    // Transit rows, shown through m_transitProxy for filtering and sorting
+    TransitTableModel *m_transitModel;
+    TransitFilterProxyModel *m_transitProxy;
+    // Aspect windows, shown in the same table instead of the daily rows
+    TransitEventTableModel *m_transitEventModel;
+    TransitEventFilterProxyModel *m_transitEventProxy;
+    QCheckBox *m_transitWindowsCB;
 private slots:
     void getPrediction();
     void displayTransitInterpretation(const QString &interpretation);
@@ -276,10 +276,19 @@ QJsonObject MistralAPI::createTransitPrompt(const QJsonObject &transitData) {
     QJsonObject systemMessage;
     systemMessage["role"] = "system";
 
+    // The data is either a line per day, or a line per aspect window with
+    // its entry, exact and exit times
+    const bool windows = transitData["reportKind"].toString() == "windows";
+    const QString dataDescription = windows
+            ? QString("The data provided lists every transit aspect window from %2 to %3 (a full %4-day period): "
+                      "when the aspect comes into orb, when it is exact (R marks the transiting planet "
+                      "retrograde) and when it leaves orb, in Universal Time. ")
+            : QString("The data provided contains "
+                      "transits for EACH DAY from %2 to %3 (a full %4-day period). ");
+
     // Base content with dates
     QString baseContent = QString("You are an expert astrologer providing detailed and insightful "
-                                  "interpretations of planetary transits on %1 charts. The data provided contains "
-                                  "transits for EACH DAY from %2 to %3 (a full %4-day period). "
+                                  "interpretations of planetary transits on %1 charts. " + dataDescription +
                                   "Analyze the ENTIRE PERIOD, not just the first day. "
                                   "\n\nProvide a comprehensive reading covering the significant transits "
                                   "throughout this period, their exact dates of occurrence, their meanings, "
@@ -0,0 +1,197 @@
+#include "resultcache.h"
+#include "ephemeriscontext.h"
+#include "Globals.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace {
+
+const quint32 EntryMagic = 0x41535443;   // "ASTC"
+
+}
+
+ResultCache::ResultCache()
+    : m_directory(GlobalFlags::appDir + "/cache")
+    , m_fingerprint(EphemerisContext::fingerprint())
+{
+}
+
+ResultCache &ResultCache::shared()
+{
+    static ResultCache cache;
+    return cache;
+}
+
+void ResultCache::setMaxBytes(qint64 maxBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxBytes = maxBytes;
+    evict();
+}
+
+qint64 ResultCache::maxBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxBytes;
+}
+
+QString ResultCache::entryPath(const QString &kind, const QByteArray &inputs) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(FormatVersion));
+    hash.addData(m_fingerprint);
+    hash.addData(kind.toUtf8());
+    hash.addData(inputs);
+    return m_directory + "/" + kind + "-" + QString::fromLatin1(hash.result().toHex()) + ".bin";
+}
+
+bool ResultCache::load(const QString &kind, const QByteArray &inputs, QByteArray &payload) const
+{
+    const std::unique_ptr<Reader> entry = openEntry(kind, inputs);
+    if (!entry) {
+        return false;
+    }
+    payload = entry->m_file.readAll();
+    return true;
+}
+
+bool ResultCache::store(const QString &kind, const QByteArray &inputs, const QByteArray &payload)
+{
+    std::unique_ptr<Writer> entry = beginEntry(kind, inputs);
+    if (!entry || entry->m_file.write(payload) != payload.size()) {
+        return false;
+    }
+    return commit(std::move(entry));
+}
+
+std::unique_ptr<ResultCache::Reader> ResultCache::openEntry(const QString &kind, const QByteArray &inputs) const
+{
+    std::unique_ptr<Reader> entry(new Reader(entryPath(kind, inputs)));
+    if (!entry->m_file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    QDataStream &in = entry->m_stream;
+    in.setDevice(&entry->m_file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray fingerprint;
+    QString storedKind;
+    QByteArray storedInputs;
+    in >> magic >> version >> fingerprint >> storedKind >> storedInputs;
+
+    // The name is only a hash; the header says whether this is really the entry
+    if (in.status() != QDataStream::Ok || magic != EntryMagic || version != FormatVersion
+            || fingerprint != m_fingerprint || storedKind != kind || storedInputs != inputs) {
+        return nullptr;
+    }
+    entry->m_payloadStart = entry->m_file.pos();
+
+    // Mark as recently used for eviction
+    entry->m_file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return entry;
+}
+
+std::unique_ptr<ResultCache::Writer> ResultCache::beginEntry(const QString &kind, const QByteArray &inputs) const
+{
+    if (!QDir().mkpath(m_directory)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Writer> entry(new Writer(entryPath(kind, inputs)));
+    if (!entry->m_file.open(QIODevice::WriteOnly)) {
+        return nullptr;
+    }
+
+    // The payload follows the header up to the end of the file
+    QDataStream &out = entry->m_stream;
+    out.setDevice(&entry->m_file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << EntryMagic << FormatVersion << m_fingerprint << kind << inputs;
+    return entry;
+}
+
+bool ResultCache::commit(std::unique_ptr<Writer> writer)
+{
+    if (!writer || writer->m_stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // An entry written again replaces its old file
+    const qint64 size = writer->m_file.pos();
+    const qint64 replaced = QFileInfo(writer->m_file.fileName()).size();
+    if (!writer->m_file.commit()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (m_totalBytes < 0) {
+        m_totalBytes = listedBytes();
+    } else {
+        m_totalBytes += size - replaced;
+    }
+    if (m_totalBytes > m_maxBytes) {
+        evict();
+    }
+    return true;
+}
+
+void ResultCache::remove(const QString &kind, const QByteArray &inputs)
+{
+    const QString path = entryPath(kind, inputs);
+
+    QMutexLocker locker(&m_mutex);
+    const qint64 size = QFileInfo(path).size();
+    if (QFile::remove(path) && m_totalBytes >= 0) {
+        m_totalBytes -= size;
+    }
+}
+
+// Called with m_mutex held
+void ResultCache::evict()
+{
+    // Newest first; everything after the budget is used up goes
+    const QFileInfoList entries = QDir(m_directory).entryInfoList({"*.bin"}, QDir::Files, QDir::Time);
+    qint64 total = 0;
+    qint64 kept = 0;
+    for (const QFileInfo &entry : entries) {
+        total += entry.size();
+        if (total > m_maxBytes) {
+            QFile::remove(entry.absoluteFilePath());
+        } else {
+            kept = total;
+        }
+    }
+    m_totalBytes = kept;
+}
+
+void ResultCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    const QFileInfoList entries = QDir(m_directory).entryInfoList({"*.bin"}, QDir::Files);
+    for (const QFileInfo &entry : entries) {
+        QFile::remove(entry.absoluteFilePath());
+    }
+    m_totalBytes = 0;
+}
+
+qint64 ResultCache::sizeOnDisk() const
+{
+    return listedBytes();
+}
+
+qint64 ResultCache::listedBytes() const
+{
+    qint64 total = 0;
+    const QFileInfoList entries = QDir(m_directory).entryInfoList({"*.bin"}, QDir::Files);
+    for (const QFileInfo &entry : entries) {
+        total += entry.size();
+    }
+    return total;
+}
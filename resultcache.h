@@ -0,0 +1,109 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QMutex>
+#include <QSaveFile>
+#include <QString>
+#include <memory>
+
+// Results of expensive calculations (return series, eclipse lists, long
+// transit scans) kept on disk between sessions, one file per entry. An entry
+// is found by a hash of its kind, its serialized inputs, the cache format
+// version and the ephemeris fingerprint, so changed inputs or replaced
+// ephemeris files simply miss and their old entries age out. Reading an
+// entry marks it as recently used; once the directory grows past the size
+// cap the least recently used files are removed.
+//
+// There is one cache per process, shared by every ChartDataManager and its
+// worker threads. Its directory and the ephemeris fingerprint are read once,
+// on first use; the application makes that first call from main(). Entries
+// are written atomically, so several processes may use the same directory.
+// Every failure reads as a miss.
+class ResultCache
+{
+public:
+    // Bump when the layout of any stored payload changes
+    static constexpr quint32 FormatVersion = 2;
+
+    // An entry read a piece at a time, for payloads too large to hold in
+    // memory at once. The stream starts at the payload.
+    class Reader
+    {
+    public:
+        QDataStream &stream() { return m_stream; }
+        qint64 payloadSize() const { return m_file.size() - m_payloadStart; }
+
+    private:
+        friend class ResultCache;
+        explicit Reader(const QString &path) : m_file(path) {}
+
+        QFile m_file;
+        QDataStream m_stream;
+        qint64 m_payloadStart = 0;
+    };
+
+    // An entry written a piece at a time. Nothing is visible until it is
+    // passed to commit(); a writer dropped before that leaves no file.
+    class Writer
+    {
+    public:
+        QDataStream &stream() { return m_stream; }
+
+    private:
+        friend class ResultCache;
+        explicit Writer(const QString &path) : m_file(path) {}
+
+        QSaveFile m_file;
+        QDataStream m_stream;
+    };
+
+    // The process's cache, in <appDir>/cache. Thread-safe; the first call
+    // must come after the ephemeris is initialized.
+    static ResultCache &shared();
+
+    QString directory() const { return m_directory; }
+
+    void setMaxBytes(qint64 maxBytes);
+    qint64 maxBytes() const;
+
+    bool load(const QString &kind, const QByteArray &inputs, QByteArray &payload) const;
+    bool store(const QString &kind, const QByteArray &inputs, const QByteArray &payload);
+
+    // Null on a miss
+    std::unique_ptr<Reader> openEntry(const QString &kind, const QByteArray &inputs) const;
+    // Null if the entry cannot be written
+    std::unique_ptr<Writer> beginEntry(const QString &kind, const QByteArray &inputs) const;
+    bool commit(std::unique_ptr<Writer> writer);
+
+    // Drop an entry found to be damaged
+    void remove(const QString &kind, const QByteArray &inputs);
+
+    // Remove every entry
+    void clear();
+    qint64 sizeOnDisk() const;
+
+private:
+    ResultCache();
+    Q_DISABLE_COPY(ResultCache)
+
+    QString entryPath(const QString &kind, const QByteArray &inputs) const;
+    qint64 listedBytes() const;
+    void evict();
+
+    const QString m_directory;
+    const QByteArray m_fingerprint;
+
+    // Guards the fields below and serializes eviction
+    mutable QMutex m_mutex;
+    qint64 m_maxBytes = 256 * 1024 * 1024;
+    // Size of the directory as this process last saw it, kept up to date on
+    // every write so eviction only lists the directory when it is over the
+    // cap; -1 until the first write. Other processes' entries are counted
+    // at the next eviction.
+    qint64 m_totalBytes = -1;
+};
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,125 @@
+#include "returnengine.h"
+#include "transitengine.h"
+#include "crossingsolver.h"
+#include "ephemeriscache.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+// Include Swiss Ephemeris headers
+extern "C" {
+#include "swephexp.h"
+}
+
+double ReturnEngine::maxSpeed(Body body)
+{
+    switch (body) {
+    case Body::Moon:      return 15.5;
+    case Body::Sun:       return 1.03;
+    case Body::Mercury:   return 2.25;
+    case Body::Venus:     return 1.3;
+    case Body::Mars:      return 0.8;
+    case Body::Jupiter:   return 0.25;
+    case Body::Saturn:    return 0.14;
+    case Body::Uranus:    return 0.07;
+    case Body::Neptune:   return 0.04;
+    case Body::Pluto:     return 0.045;
+    case Body::NorthNode:
+    case Body::SouthNode: return 0.5;
+    case Body::Chiron:    return 0.2;
+    case Body::Lilith:    return 0.12;
+    default:              return 1.0;
+    }
+}
+
+double ReturnEngine::meanReturnInterval(Body body)
+{
+    switch (body) {
+    case Body::Moon:      return 27.32;
+    case Body::Sun:
+    case Body::Mercury:
+    case Body::Venus:     return 365.25;
+    case Body::Mars:      return 687.0;
+    case Body::Jupiter:   return 4332.6;
+    case Body::Saturn:    return 10759.2;
+    case Body::Uranus:    return 30687.0;
+    case Body::Neptune:   return 60190.0;
+    case Body::Pluto:     return 90560.0;
+    case Body::NorthNode:
+    case Body::SouthNode: return 6798.4;
+    case Body::Chiron:    return 18500.0;
+    case Body::Lilith:    return 3232.6;
+    default:              return 1680.0;
+    }
+}
+
+bool ReturnEngine::position(Body body, double jd, double &longitude, double &speed) const
+{
+    // A sweep evaluates too few points to pay for fitting, but spans that a
+    // transit scan or search has fitted are used. Near a station the fitted
+    // speed may have the wrong sign.
+    const EphemerisCache &cache = EphemerisCache::shared();
+    if (cache.longitude(body, jd, longitude, speed) && fabs(speed) > cache.speedTolerance()) {
+        return true;
+    }
+
+    int sweId = sweBodyId(body == Body::SouthNode ? Body::NorthNode : body);
+    if (sweId < 0) {
+        return false;
+    }
+
+    double xx[6];
+    char serr[256];
+    if (swe_calc_ut(jd, sweId, SEFLG_SWIEPH | SEFLG_SPEED, xx, serr) < 0) {
+        qWarning() << "Error calculating position for" << bodyName(body) << ":" << serr;
+        return false;
+    }
+
+    longitude = xx[0];
+    speed = xx[3];
+    if (body == Body::SouthNode) {
+        longitude = fmod(longitude + 180.0, 360.0);
+    }
+    return true;
+}
+
+QVector<ReturnEvent> ReturnEngine::findReturns(Body body, double targetLongitude,
+                                               double startJd, double endJd) const
+{
+    // Near the target the sweep falls back to the transit sampling step, which
+    // is short enough to separate the passes of a retrograde loop
+    CrossingSolver solver([this, body](double jd, double &longitude, double &speed) {
+                              return position(body, jd, longitude, speed);
+                          },
+                          maxSpeed(body), TransitEngine::sampleStep(body));
+
+    QVector<ReturnEvent> returns;
+    const QVector<Crossing> crossings = solver.findCrossings(targetLongitude, startJd, endJd);
+    returns.reserve(crossings.size());
+    for (const Crossing &crossing : crossings) {
+        returns.append({crossing.jd, crossing.rate < 0.0});
+    }
+    return returns;
+}
+
+double ReturnEngine::findNearestReturn(Body body, double targetLongitude, double approxJd) const
+{
+    // Start with a bit more than half the usual interval on each side and
+    // widen if the body was held up by a long retrograde loop
+    double window = std::max(30.0, 0.6 * meanReturnInterval(body));
+
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        QVector<ReturnEvent> returns = findReturns(body, targetLongitude,
+                                                   approxJd - window, approxJd + window);
+        if (!returns.isEmpty()) {
+            auto nearest = std::min_element(returns.cbegin(), returns.cend(),
+                                            [approxJd](const ReturnEvent &a, const ReturnEvent &b) {
+                                                return fabs(a.jd - approxJd) < fabs(b.jd - approxJd);
+                                            });
+            return nearest->jd;
+        }
+        window *= 2.0;
+    }
+
+    return 0.0;
+}
@@ -0,0 +1,38 @@
+#ifndef RETURNENGINE_H
+#define RETURNENGINE_H
+
+#include <QVector>
+#include "astrotypes.h"
+
+// One moment a body comes back to its natal longitude
+struct ReturnEvent {
+    double jd;          // UT
+    bool retrograde;    // Reached while retrograde (second pass of a loop)
+};
+
+// Planetary returns for any ephemeris body. A single forward sweep finds
+// every crossing of the target longitude in a range, so direct and
+// retrograde passes of Mercury to Pluto all show up. The sweep and the
+// refinement are done by CrossingSolver; far from the target its strides are
+// bounded by the body's maximum speed, which keeps multi-decade ranges cheap.
+// Callers must hold an EphemerisContext::Lease.
+class ReturnEngine
+{
+public:
+    QVector<ReturnEvent> findReturns(Body body, double targetLongitude,
+                                     double startJd, double endJd) const;
+
+    // The return closest in time to approxJd, or 0 if none was found
+    double findNearestReturn(Body body, double targetLongitude, double approxJd) const;
+
+    // Upper bound of the geocentric speed (deg/day), used to size strides
+    static double maxSpeed(Body body);
+
+    // Typical time between returns (days), used to size searches
+    static double meanReturnInterval(Body body);
+
+private:
+    bool position(Body body, double jd, double &longitude, double &speed) const;
+};
+
+#endif // RETURNENGINE_H
@@ -0,0 +1,109 @@
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+#include <QCoreApplication>
+#include <cstdlib>
+#include <functional>
+#include "chartcalculator.h"
+
+// Heap allocations of the calling thread, counted by wrapping the C
+// allocator. Qt containers allocate through malloc and realloc, and
+// operator new ends up in malloc too, so this sees all of them.
+#if defined(__GLIBC__)
+#define ASTERIA_COUNT_ALLOCATIONS
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+}
+
+namespace {
+thread_local bool t_counting = false;
+thread_local long t_allocations = 0;
+}
+
+extern "C" void *malloc(size_t size)
+{
+    if (t_counting) ++t_allocations;
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    if (t_counting) ++t_allocations;
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size)
+{
+    if (t_counting) ++t_allocations;
+    return __libc_realloc(pointer, size);
+}
+
+namespace {
+
+long allocationsDuring(const std::function<void()> &work)
+{
+    t_allocations = 0;
+    t_counting = true;
+    work();
+    t_counting = false;
+    return t_allocations;
+}
+
+}
+#endif
+
+TEST_CASE("The transit day scan allocates per scan, not per day")
+{
+#ifndef ASTERIA_COUNT_ALLOCATIONS
+    WARN("Allocation counting needs glibc; not checked");
+#else
+    ChartCalculator calculator;
+    REQUIRE(calculator.getLastError().toStdString() == "");
+
+    CalculationOptions options;
+    SECTION("Ephemeris bodies (the default)") {
+    }
+    SECTION("With chart points") {
+        options.additionalBodies = true;
+        options.transitChartPoints = true;
+    }
+
+    NatalChartHandle natal = calculator.natalChart(QDate(1990, 5, 17), QTime(14, 30), "+1:00",
+                                                   "51.5", "-0.12", options);
+    REQUIRE(natal);
+
+    const QDate start(2025, 1, 1);
+    const int longDays = 3650;
+    const int shortDays = 70;
+
+    // Fits the shared ephemeris cache over the period and grows the
+    // thread's scan buffers to the largest chunk
+    QVector<TransitHit> hits = calculator.calculateTransitList(*natal, start, longDays, options);
+    REQUIRE(calculator.getLastError().isEmpty());
+    REQUIRE_FALSE(hits.isEmpty());
+    hits = QVector<TransitHit>();
+
+    const long shortScan = allocationsDuring([&]() {
+        hits = calculator.calculateTransitList(*natal, start, shortDays, options);
+    });
+    hits = QVector<TransitHit>();
+    const long longScan = allocationsDuring([&]() {
+        hits = calculator.calculateTransitList(*natal, start, longDays, options);
+    });
+
+    INFO(shortDays << " days: " << shortScan << " allocations, "
+         << longDays << " days: " << longScan << " allocations");
+    // The long scan has 3580 more days in 511 more chunks of 7; anything
+    // allocated per day or per chunk would show up as hundreds more
+    CHECK(longScan - shortScan < 8);
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    // The ephemeris search looks next to the executable
+    QCoreApplication app(argc, argv);
+    return Catch::Session().run(argc, argv);
+}
@@ -0,0 +1,255 @@
+#include "transitengine.h"
+#include "crossingsolver.h"
+#include "returnengine.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+// Include Swiss Ephemeris headers
+extern "C" {
+#include "swephexp.h"
+}
+
+namespace {
+
+// Crossings are only tracked near the target. Far away from it the
+// normalized difference wraps from +180 to -180, which is not a crossing.
+const double kTrackingLimit = 90.0;
+
+}
+
+TransitEngine::TransitEngine(double orbMax)
+    : m_orbs(AspectOrbTable::standard(orbMax))
+{
+}
+
+TransitEngine::TransitEngine(const AspectOrbTable &orbs)
+    : m_orbs(orbs)
+{
+}
+
+double TransitEngine::sampleStep(Body body)
+{
+    // The step must stay well below the time a body needs to cross the
+    // narrowest orb window (2 x 0.75 x orb), so no window is stepped over
+    switch (body) {
+    case Body::Moon:
+        return 0.25;
+    case Body::Sun:
+    case Body::Mercury:
+    case Body::Venus:
+    case Body::Mars:
+    case Body::NorthNode:
+    case Body::SouthNode:
+        return 1.0;
+    default:
+        return 2.0;
+    }
+}
+
+bool TransitEngine::position(const EphemerisCache &cache, Body body, double jd,
+                             double &longitude, double &speed) const
+{
+    // Near a station the fitted speed may have the wrong sign
+    if (cache.longitude(body, jd, longitude, speed) && fabs(speed) > cache.speedTolerance()) {
+        return true;
+    }
+
+    // The South Node is always opposite the North Node
+    int sweId = sweBodyId(body == Body::SouthNode ? Body::NorthNode : body);
+    if (sweId < 0) {
+        return false;
+    }
+
+    double xx[6];
+    char serr[256];
+    if (swe_calc_ut(jd, sweId, SEFLG_SWIEPH | SEFLG_SPEED, xx, serr) < 0) {
+        qWarning() << "Error calculating position for" << bodyName(body) << ":" << serr;
+        return false;
+    }
+
+    longitude = xx[0];
+    speed = xx[3];
+    if (body == Body::SouthNode) {
+        longitude = fmod(longitude + 180.0, 360.0);
+    }
+    return true;
+}
+
+QVector<TransitEngine::Sample> TransitEngine::sampleBody(const EphemerisCache &cache, Body body,
+                                                        double startJd, double endJd) const
+{
+    QVector<Sample> samples;
+    const double step = sampleStep(body);
+    const int count = int(std::ceil((endJd - startJd) / step)) + 1;
+    samples.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        Sample sample;
+        // The last sample lands exactly on the end of the range
+        sample.jd = std::min(startJd + i * step, endJd);
+        if (!position(cache, body, sample.jd, sample.longitude, sample.speed)) {
+            return QVector<Sample>();
+        }
+        samples.append(sample);
+    }
+    return samples;
+}
+
+double TransitEngine::solveCrossing(const EphemerisCache &cache, Body body,
+                                    double target, double offset,
+                                    const Sample &a, const Sample &b) const
+{
+    // The bracket always comes from two samples with opposite signs, and the
+    // samples already carry the speed the Newton steps need
+    CrossingSolver solver([this, &cache, body](double jd, double &longitude, double &speed) {
+                              return position(cache, body, jd, longitude, speed);
+                          },
+                          ReturnEngine::maxSpeed(body), sampleStep(body));
+
+    double fa = CrossingSolver::normalize180(a.longitude - target) - offset;
+    double fb = CrossingSolver::normalize180(b.longitude - target) - offset;
+    return solver.refine(target, offset, a.jd, fa, a.speed, b.jd, fb, b.speed).jd;
+}
+
+void TransitEngine::scanTarget(const EphemerisCache &cache, Body body,
+                               const QVector<Sample> &samples,
+                               const NatalPoint &natal, AspectKind aspect, double target,
+                               double startJd, double endJd,
+                               QVector<TransitEvent> &events) const
+{
+    const double orb = m_orbs.orbFor(aspect, body, natal.body);
+
+    bool inWindow = false;
+    TransitEvent current;
+
+    auto openWindow = [&](double jd, double orbAtStart) {
+        current = TransitEvent();
+        current.transitBody = body;
+        current.natalBody = natal.body;
+        current.aspect = aspect;
+        current.startJd = jd;
+        current.minOrb = orbAtStart;
+        inWindow = true;
+    };
+
+    auto closeWindow = [&](double jd) {
+        current.endJd = jd;
+        events.append(current);
+        inWindow = false;
+    };
+
+    double previous = CrossingSolver::normalize180(samples.first().longitude - target);
+    if (fabs(previous) <= orb) {
+        openWindow(startJd, fabs(previous));
+        current.startsBeforeRange = true;
+    }
+
+    for (int k = 1; k < samples.size(); ++k) {
+        const Sample &p = samples.at(k - 1);
+        const Sample &s = samples.at(k);
+        const double ph = previous;
+        const double h = CrossingSolver::normalize180(s.longitude - target);
+        previous = h;
+
+        if (fabs(ph) >= kTrackingLimit && fabs(h) >= kTrackingLimit) {
+            continue;
+        }
+
+        const bool inOrb = fabs(h) <= orb;
+        const bool crossesExact = (ph < 0.0) != (h < 0.0)
+                && fabs(ph) < kTrackingLimit && fabs(h) < kTrackingLimit;
+
+        // Exact hit inside this step, if any
+        Sample exact;
+        if (crossesExact) {
+            exact.jd = solveCrossing(cache, body, target, 0.0, p, s);
+            if (!position(cache, body, exact.jd, exact.longitude, exact.speed)) {
+                exact.longitude = target;
+                exact.speed = s.speed;
+            }
+        }
+
+        // Coming into orb (possibly passing straight through within one step)
+        if (!inWindow && (inOrb || crossesExact)) {
+            const double edge = ph > 0.0 ? orb : -orb;
+            openWindow(solveCrossing(cache, body, target, edge, p, crossesExact ? exact : s), orb);
+        }
+
+        if (crossesExact) {
+            current.exactJds.append(exact.jd);
+            current.exactRetrograde.append(exact.speed < 0.0);
+            current.minOrb = 0.0;
+        }
+
+        if (inWindow) {
+            if (inOrb) {
+                current.minOrb = std::min(current.minOrb, fabs(h));
+            } else {
+                // Leaving orb
+                const double edge = h > 0.0 ? orb : -orb;
+                closeWindow(solveCrossing(cache, body, target, edge, crossesExact ? exact : p, s));
+            }
+        }
+    }
+
+    if (inWindow) {
+        current.endsAfterRange = true;
+        closeWindow(endJd);
+    }
+}
+
+QVector<TransitEvent> TransitEngine::findEvents(const QVector<Body> &transitingBodies,
+                                                const QVector<NatalPoint> &natalPoints,
+                                                double startJd,
+                                                double endJd,
+                                                const std::function<bool(int done, int total)> &progress) const
+{
+    QVector<TransitEvent> events;
+    if (endJd <= startJd) {
+        return events;
+    }
+
+    EphemerisCache &cache = EphemerisCache::shared();
+    const int total = transitingBodies.size() * natalPoints.size();
+    int done = 0;
+
+    for (Body body : transitingBodies) {
+        // Fit the body once; sampling and every root-finding step below
+        // evaluate the polynomials. If fitting fails, position() falls back
+        // to direct ephemeris calls.
+        cache.prepare(body, startJd, endJd);
+
+        // One sampling pass per body serves every natal point and aspect
+        QVector<Sample> samples = sampleBody(cache, body, startJd, endJd);
+        if (samples.size() < 2) {
+            done += natalPoints.size();
+            continue;
+        }
+
+        for (const NatalPoint &natal : natalPoints) {
+            for (int a = 0; a < AspectKindCount; ++a) {
+                AspectKind aspect = AspectKind(a);
+                double angle = aspectAngle(aspect);
+
+                // Waxing and waning sides are separate windows, except for
+                // the conjunction and the opposition which only have one
+                scanTarget(cache, body, samples, natal, aspect, natal.longitude + angle,
+                           startJd, endJd, events);
+                if (angle > 0.0 && angle < 180.0) {
+                    scanTarget(cache, body, samples, natal, aspect, natal.longitude - angle,
+                               startJd, endJd, events);
+                }
+            }
+            if (progress && !progress(++done, total)) {
+                return QVector<TransitEvent>();
+            }
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const TransitEvent &a, const TransitEvent &b) {
+        return a.startJd < b.startJd;
+    });
+
+    return events;
+}
@@ -0,0 +1,83 @@
+#ifndef TRANSITENGINE_H
+#define TRANSITENGINE_H
+
+#include <QVector>
+#include <functional>
+#include "astrotypes.h"
+#include "ephemeriscache.h"
+#include "aspectkernel.h"
+
+// A natal point that transits are measured against
+struct NatalPoint {
+    Body body;
+    double longitude;
+};
+
+// One aspect window between a transiting body and a natal point: when the
+// aspect comes into orb, every moment it is exact (a retrograde station can
+// produce three hits) and when it leaves orb again.
+struct TransitEvent {
+    Body transitBody;
+    Body natalBody;
+    AspectKind aspect;
+    double startJd = 0.0;           // Enters orb (clipped to the scan start)
+    double endJd = 0.0;             // Leaves orb (clipped to the scan end)
+    QVector<double> exactJds;       // Exact hits inside the window, in time order
+    QVector<bool> exactRetrograde;  // Transiting body retrograde at each hit
+    double minOrb = 0.0;            // Tightest orb reached inside the window
+    bool startsBeforeRange = false; // Already in orb when the scan started
+    bool endsAfterRange = false;    // Still in orb when the scan ended
+};
+
+// Event-based transit search. Instead of sampling once a day and reporting
+// every aspect in orb on every day, it samples each transiting body at a step
+// suited to its speed, brackets every transiting/natal/aspect combination and
+// root-finds the entry, exact and exit times. The result is one event per
+// aspect window. Positions come from the shared EphemerisCache fitted over
+// the range, so root-finding costs polynomial evaluations rather than
+// ephemeris calls, and a later search or scan of the period reuses the fits.
+// Callers must hold an EphemerisContext::Lease.
+//
+// progress, when given, is called with the transiting body/natal point pairs
+// done so far and their total. Returning false stops the search, which then
+// returns no events.
+class TransitEngine
+{
+public:
+    explicit TransitEngine(double orbMax = 8.0);
+    explicit TransitEngine(const AspectOrbTable &orbs);
+
+    QVector<TransitEvent> findEvents(const QVector<Body> &transitingBodies,
+                                     const QVector<NatalPoint> &natalPoints,
+                                     double startJd,
+                                     double endJd,
+                                     const std::function<bool(int done, int total)> &progress = nullptr) const;
+
+    // Sampling step (days) used to bracket events for a body
+    static double sampleStep(Body body);
+
+private:
+    struct Sample {
+        double jd;
+        double longitude;
+        double speed;
+    };
+
+    bool position(const EphemerisCache &cache, Body body, double jd,
+                  double &longitude, double &speed) const;
+    QVector<Sample> sampleBody(const EphemerisCache &cache, Body body,
+                               double startJd, double endJd) const;
+
+    // Time in [a, b] where the transiting longitude minus target equals offset
+    double solveCrossing(const EphemerisCache &cache, Body body, double target, double offset,
+                         const Sample &a, const Sample &b) const;
+
+    void scanTarget(const EphemerisCache &cache, Body body, const QVector<Sample> &samples,
+                    const NatalPoint &natal, AspectKind aspect, double target,
+                    double startJd, double endJd,
+                    QVector<TransitEvent> &events) const;
+
+    AspectOrbTable m_orbs;
+};
+
+#endif // TRANSITENGINE_H
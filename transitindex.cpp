@@ -0,0 +1,439 @@
+#include "transitindex.h"
+#include "transitengine.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cmath>
+
+static_assert(BodyCount <= 64, "BlockSummary keeps one bit per body in a quint64");
+static_assert(AspectKindCount <= 32, "BlockSummary keeps one bit per aspect in a quint32");
+static_assert(TransitStore::BlockRows <= 65536, "Posting lists hold row offsets as quint16");
+
+namespace {
+
+// A posting list record of a full block starts with one entry per key. The
+// lists follow, each at an 8-byte aligned offset.
+struct PostingEntry {
+    quint32 offset;     // From the start of the record
+    quint32 count;      // Rows with the key
+};
+
+constexpr qsizetype BitmapBytes = TransitIndex::BitmapWords * qsizetype(sizeof(quint64));
+
+// Lists at least this long are stored as a bitmap, which is then no larger
+constexpr int BitmapMinRows = int(BitmapBytes / sizeof(quint16));
+
+qsizetype aligned(qsizetype bytes)
+{
+    return (bytes + 7) & ~qsizetype(7);
+}
+
+}
+
+TransitRowList::TransitRowList()
+    : m_blocks("asteria-rows")
+{
+}
+
+void TransitRowList::clear()
+{
+    m_blocks.clear();
+    m_tail.clear();
+    m_size = 0;
+    m_flushed = 0;
+}
+
+void TransitRowList::append(qint32 row)
+{
+    if (m_tail.isEmpty()) {
+        m_tail = QByteArray(BlockBytes, Qt::Uninitialized);
+    }
+    std::memcpy(m_tail.data() + qsizetype(m_size % BlockRows) * qsizetype(sizeof(qint32)),
+                &row, sizeof(row));
+    ++m_size;
+
+    if (m_size - m_flushed == BlockRows) {
+        m_blocks.append(m_tail);
+        m_tail.clear();
+        m_flushed += BlockRows;
+    }
+}
+
+TransitIndex::TransitIndex()
+    : m_postings("asteria-index")
+{
+}
+
+void TransitIndex::clear()
+{
+    m_rows = 0;
+    m_blocks.clear();
+    for (QVector<quint16> &rows : m_tailPostings) {
+        rows.clear();
+    }
+    m_postings.clear();
+    m_dateOrdered = true;
+    m_firstDay = 0;
+    m_dayStart.clear();
+}
+
+void TransitIndex::update(const TransitStore &store)
+{
+    const int first = m_rows;
+    const int rows = store.size();
+    if (rows <= first) {
+        return;
+    }
+
+    for (int row = first; row < rows; ++row) {
+        if (row % TransitStore::BlockRows == 0) {
+            BlockSummary summary;
+            summary.minOrb = store.orb(row);
+            m_blocks.append(summary);
+        }
+        BlockSummary &summary = m_blocks.last();
+        summary.transit[store.retrograde(row)] |= quint64(1) << int(store.transitBody(row));
+        summary.natal |= quint64(1) << int(store.natalBody(row));
+        summary.aspects |= quint32(1) << int(store.aspect(row));
+        summary.minOrb = qMin(summary.minOrb, store.orb(row));
+
+        const quint16 offset = quint16(row % TransitStore::BlockRows);
+        m_tailPostings[transitKey(store.transitBody(row), store.retrograde(row))].append(offset);
+        m_tailPostings[natalKey(store.natalBody(row))].append(offset);
+        m_tailPostings[aspectKey(store.aspect(row))].append(offset);
+        if (offset == TransitStore::BlockRows - 1) {
+            flushPostings();
+        }
+
+        const qint32 day = store.julianDay(row);
+        if (m_dayStart.isEmpty()) {
+            m_firstDay = day;
+            m_dayStart.append(row);
+        } else if (day < lastDay()) {
+            m_dateOrdered = false;
+        }
+        // Days without hits start where the next day with hits starts
+        while (m_dateOrdered && lastDay() < day) {
+            m_dayStart.append(row);
+        }
+    }
+    m_rows = rows;
+}
+
+void TransitIndex::flushPostings()
+{
+    QByteArray record(aligned(KeyCount * qsizetype(sizeof(PostingEntry))), '\0');
+    for (int key = 0; key < KeyCount; ++key) {
+        QVector<quint16> &rows = m_tailPostings[key];
+        const PostingEntry entry = {quint32(record.size()), quint32(rows.size())};
+        std::memcpy(record.data() + key * sizeof(PostingEntry), &entry, sizeof(entry));
+
+        if (rows.size() >= BitmapMinRows) {
+            quint64 words[BitmapWords] = {};
+            for (quint16 offset : rows) {
+                words[offset / 64] |= quint64(1) << (offset % 64);
+            }
+            record.append(reinterpret_cast<const char *>(words), BitmapBytes);
+        } else {
+            record.append(reinterpret_cast<const char *>(rows.constData()),
+                          rows.size() * qsizetype(sizeof(quint16)));
+            record.append(aligned(record.size()) - record.size(), '\0');
+        }
+        // Keeps the capacity for the next block
+        rows.clear();
+    }
+    m_postings.append(record);
+}
+
+void TransitIndex::orRows(int blockIndex, int key, quint64 *bits) const
+{
+    const quint16 *rows;
+    int count;
+    if (blockIndex < m_postings.count()) {
+        const uchar *record = m_postings.block(blockIndex);
+        PostingEntry entry;
+        std::memcpy(&entry, record + key * sizeof(PostingEntry), sizeof(entry));
+        if (int(entry.count) >= BitmapMinRows) {
+            const quint64 *words = reinterpret_cast<const quint64 *>(record + entry.offset);
+            for (int i = 0; i < BitmapWords; ++i) {
+                bits[i] |= words[i];
+            }
+            return;
+        }
+        rows = reinterpret_cast<const quint16 *>(record + entry.offset);
+        count = int(entry.count);
+    } else {
+        // The block being filled
+        rows = m_tailPostings[key].constData();
+        count = m_tailPostings[key].size();
+    }
+    for (int i = 0; i < count; ++i) {
+        bits[rows[i] / 64] |= quint64(1) << (rows[i] % 64);
+    }
+}
+
+int TransitIndex::firstRowOn(qint32 day) const
+{
+    if (m_dayStart.isEmpty() || day <= m_firstDay) {
+        return 0;
+    }
+    if (day > lastDay()) {
+        return m_rows;
+    }
+    return m_dayStart[day - m_firstDay];
+}
+
+TransitFilter TransitFilter::compile(const QString &datePattern,
+                                     const QString &transitPattern,
+                                     const QString &aspectPattern,
+                                     const QString &natalPattern,
+                                     const QString &maxOrbPattern,
+                                     const QString &excludePattern)
+{
+    TransitFilter filter;
+
+    for (const QString &term : excludePattern.split(',', Qt::SkipEmptyParts)) {
+        const QString trimmedTerm = term.trimmed();
+        if (!trimmedTerm.isEmpty()) {
+            filter.m_excludeTerms.append(trimmedTerm);
+        }
+    }
+    auto excluded = [&filter](const QString &label) {
+        for (const QString &term : filter.m_excludeTerms) {
+            if (label.contains(term, Qt::CaseInsensitive)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    auto makeRegex = [](const QString &pattern) {
+        return QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption);
+    };
+
+    const QRegularExpression transitRe = makeRegex(transitPattern);
+    const QRegularExpression natalRe = makeRegex(natalPattern);
+    for (int i = 0; i < BodyCount; ++i) {
+        const Body body = Body(i);
+        for (int retrograde = 0; retrograde < 2; ++retrograde) {
+            const QString label = TransitStore::transitLabel(body, retrograde);
+            bool accepted = (transitPattern.isEmpty() || label.contains(transitRe)) && !excluded(label);
+            filter.m_transitAccepted[i][retrograde] = accepted;
+            filter.m_filtersTransit |= !accepted;
+            if (accepted) {
+                filter.m_transitMask[retrograde] |= quint64(1) << i;
+            }
+        }
+
+        const QString label = TransitStore::shortName(body);
+        bool accepted = (natalPattern.isEmpty() || label.contains(natalRe)) && !excluded(label);
+        filter.m_natalAccepted[i] = accepted;
+        filter.m_filtersNatal |= !accepted;
+        if (accepted) {
+            filter.m_natalMask |= quint64(1) << i;
+        }
+    }
+
+    const QRegularExpression aspectRe = makeRegex(aspectPattern);
+    for (int i = 0; i < AspectKindCount; ++i) {
+        const QString label = aspectCode(AspectKind(i));
+        bool accepted = (aspectPattern.isEmpty() || label.contains(aspectRe)) && !excluded(label);
+        filter.m_aspectAccepted[i] = accepted;
+        filter.m_filtersAspect |= !accepted;
+        if (accepted) {
+            filter.m_aspectMask |= quint32(1) << i;
+        }
+    }
+
+    filter.m_filtersDate = !datePattern.isEmpty() || !filter.m_excludeTerms.isEmpty();
+    filter.m_dateRe = makeRegex(datePattern);
+
+    bool ok = false;
+    const double maxOrb = maxOrbPattern.toDouble(&ok);
+    filter.m_hasMaxOrb = ok;
+    filter.m_maxOrb = float(maxOrb);
+
+    return filter;
+}
+
+bool TransitFilter::isEmpty() const
+{
+    return !m_filtersTransit && !m_filtersNatal && !m_filtersAspect && !m_filtersDate && !m_hasMaxOrb;
+}
+
+bool TransitFilter::dayAccepted(qint32 julianDay) const
+{
+    const QString label = QDate::fromJulianDay(julianDay).toString("yyyy-MM-dd");
+    if (!m_dateRe.pattern().isEmpty() && !label.contains(m_dateRe)) {
+        return false;
+    }
+    for (const QString &term : m_excludeTerms) {
+        if (label.contains(term, Qt::CaseInsensitive)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TransitFilter::columnsAccepted(const TransitStore &store, int row) const
+{
+    if (m_hasMaxOrb && store.orb(row) > m_maxOrb) {
+        return false;
+    }
+    if (m_filtersTransit && !m_transitAccepted[int(store.transitBody(row))][store.retrograde(row)]) {
+        return false;
+    }
+    if (m_filtersNatal && !m_natalAccepted[int(store.natalBody(row))]) {
+        return false;
+    }
+    return !m_filtersAspect || m_aspectAccepted[int(store.aspect(row))];
+}
+
+bool TransitFilter::accepts(const TransitStore &store, int row) const
+{
+    return columnsAccepted(store, row) && (!m_filtersDate || dayAccepted(store.julianDay(row)));
+}
+
+bool TransitFilter::accepts(const TransitEvent &event) const
+{
+    if (m_hasMaxOrb && event.minOrb > m_maxOrb) {
+        return false;
+    }
+    if (m_filtersTransit) {
+        const int body = int(event.transitBody);
+        bool accepted = event.exactRetrograde.isEmpty() && m_transitAccepted[body][0];
+        for (bool retrograde : event.exactRetrograde) {
+            accepted = accepted || m_transitAccepted[body][retrograde];
+        }
+        if (!accepted) {
+            return false;
+        }
+    }
+    if (m_filtersNatal && !m_natalAccepted[int(event.natalBody)]) {
+        return false;
+    }
+    if (m_filtersAspect && !m_aspectAccepted[int(event.aspect)]) {
+        return false;
+    }
+    // Julian day numbers start at noon
+    return !m_filtersDate || dayAccepted(qint32(std::floor(event.startJd + 0.5)));
+}
+
+bool TransitFilter::mayMatch(const TransitIndex::BlockSummary &block) const
+{
+    if (m_hasMaxOrb && block.minOrb > m_maxOrb) {
+        return false;
+    }
+    if (m_filtersTransit && !(block.transit[0] & m_transitMask[0]) && !(block.transit[1] & m_transitMask[1])) {
+        return false;
+    }
+    if (m_filtersNatal && !(block.natal & m_natalMask)) {
+        return false;
+    }
+    return !m_filtersAspect || (block.aspects & m_aspectMask);
+}
+
+void TransitFilter::selectRows(const TransitIndex &index, int blockIndex, quint64 *bits) const
+{
+    std::fill(bits, bits + TransitIndex::BitmapWords, ~quint64(0));
+    quint64 column[TransitIndex::BitmapWords];
+    auto intersect = [&]() {
+        for (int i = 0; i < TransitIndex::BitmapWords; ++i) {
+            bits[i] &= column[i];
+        }
+    };
+
+    if (m_filtersTransit) {
+        std::fill(std::begin(column), std::end(column), quint64(0));
+        for (int i = 0; i < BodyCount; ++i) {
+            for (int retrograde = 0; retrograde < 2; ++retrograde) {
+                if (m_transitAccepted[i][retrograde]) {
+                    index.orRows(blockIndex, TransitIndex::transitKey(Body(i), retrograde), column);
+                }
+            }
+        }
+        intersect();
+    }
+    if (m_filtersNatal) {
+        std::fill(std::begin(column), std::end(column), quint64(0));
+        for (int i = 0; i < BodyCount; ++i) {
+            if (m_natalAccepted[i]) {
+                index.orRows(blockIndex, TransitIndex::natalKey(Body(i)), column);
+            }
+        }
+        intersect();
+    }
+    if (m_filtersAspect) {
+        std::fill(std::begin(column), std::end(column), quint64(0));
+        for (int i = 0; i < AspectKindCount; ++i) {
+            if (m_aspectAccepted[i]) {
+                index.orRows(blockIndex, TransitIndex::aspectKey(AspectKind(i)), column);
+            }
+        }
+        intersect();
+    }
+}
+
+void TransitFilter::collect(const TransitStore &store, const TransitIndex &index,
+                            int begin, int end, TransitRowList &rows) const
+{
+    end = qMin(end, index.size());
+
+    // The last day tested, so each day's pattern runs once
+    qint32 testedDay = 0;
+    bool testedDayAccepted = false;
+    bool hasTestedDay = false;
+
+    quint64 bits[TransitIndex::BitmapWords];
+    int row = qMax(begin, 0);
+    while (row < end) {
+        const int blockIndex = row / TransitStore::BlockRows;
+        const int blockStart = blockIndex * TransitStore::BlockRows;
+        const int blockEnd = qMin(end, blockStart + TransitStore::BlockRows);
+        if (!mayMatch(index.block(blockIndex))) {
+            row = blockEnd;
+            continue;
+        }
+
+        selectRows(index, blockIndex, bits);
+
+        // Rows before next are skipped
+        int next = row;
+        const int lastWord = (blockEnd - 1 - blockStart) / 64;
+        for (int word = (row - blockStart) / 64; word <= lastWord; ++word) {
+            if (blockStart + word * 64 + 63 < next) {
+                continue;
+            }
+            quint64 set = bits[word];
+            while (set) {
+                const int candidate = blockStart + word * 64 + qCountTrailingZeroBits(set);
+                set &= set - 1;
+                if (candidate < next) {
+                    continue;
+                }
+                if (candidate >= blockEnd) {
+                    break;
+                }
+
+                if (m_filtersDate) {
+                    const qint32 day = store.julianDay(candidate);
+                    if (!hasTestedDay || day != testedDay) {
+                        testedDay = day;
+                        testedDayAccepted = dayAccepted(day);
+                        hasTestedDay = true;
+                    }
+                    if (!testedDayAccepted) {
+                        // Skip the rest of a rejected day in one step
+                        if (index.isDateOrdered()) {
+                            next = index.firstRowOn(day + 1);
+                        }
+                        continue;
+                    }
+                }
+                if (m_hasMaxOrb && store.orb(candidate) > m_maxOrb) {
+                    continue;
+                }
+                rows.append(candidate);
+            }
+        }
+        row = qMax(blockEnd, next);
+    }
+}
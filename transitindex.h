@@ -0,0 +1,181 @@
+#ifndef TRANSITINDEX_H
+#define TRANSITINDEX_H
+
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVector>
+#include "transitstore.h"
+
+struct TransitEvent;
+
+// A list of transit row numbers, stored like the TransitStore columns: the
+// block being filled in RAM, full blocks in a BlockFile. Holds the rows a
+// filter accepted, in the order they are shown.
+class TransitRowList
+{
+public:
+    static constexpr int BlockRows = 65536;
+
+    TransitRowList();
+
+    void clear();
+    void append(qint32 row);
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    qint32 at(int index) const
+    {
+        const uchar *data = index >= m_flushed ? reinterpret_cast<const uchar *>(m_tail.constData())
+                                               : m_blocks.block(index / BlockRows);
+        qint32 row;
+        std::memcpy(&row, data + qsizetype(index % BlockRows) * qsizetype(sizeof(qint32)), sizeof(row));
+        return row;
+    }
+
+private:
+    Q_DISABLE_COPY(TransitRowList)
+
+    static constexpr qsizetype BlockBytes = BlockRows * qsizetype(sizeof(qint32));
+
+    QByteArray m_tail;
+    int m_size = 0;
+    int m_flushed = 0;      // Entries in full blocks
+    BlockFile m_blocks;
+};
+
+// Indexes over a TransitStore, for every block of TransitStore::BlockRows
+// rows:
+// - an inverted index: the rows of each transit body (direct and
+//   retrograde), natal body and aspect, each list stored as row offsets or,
+//   once it is long enough, as a bitmap of the block;
+// - a summary of which of those values occur in the block and its smallest
+//   orb, so blocks that cannot match are skipped outright.
+// Plus the first row of every day. The posting lists of full blocks live in
+// a BlockFile and only the block being filled is held in RAM, so the index
+// takes disk space, not RAM, as the store grows. Rows are indexed as they
+// are appended, so the index can follow a streaming scan.
+class TransitIndex
+{
+public:
+    struct BlockSummary {
+        quint64 transit[2] = {};    // Bit per transit body, [retrograde]
+        quint64 natal = 0;          // Bit per natal body
+        quint32 aspects = 0;        // Bit per aspect kind
+        float minOrb = 0.0f;
+    };
+
+    // A bitmap over the rows of one block
+    static constexpr int BitmapWords = TransitStore::BlockRows / 64;
+
+    // Keys of the inverted index
+    static constexpr int TransitKeys = 2 * BodyCount;
+    static constexpr int KeyCount = TransitKeys + BodyCount + AspectKindCount;
+    static int transitKey(Body body, bool retrograde) { return int(body) * 2 + (retrograde ? 1 : 0); }
+    static int natalKey(Body body) { return TransitKeys + int(body); }
+    static int aspectKey(AspectKind aspect) { return TransitKeys + BodyCount + int(aspect); }
+
+    TransitIndex();
+
+    void clear();
+
+    // Index rows [size(), store.size())
+    void update(const TransitStore &store);
+
+    int size() const { return m_rows; }
+
+    int blockCount() const { return m_blocks.size(); }
+    const BlockSummary &block(int index) const { return m_blocks[index]; }
+
+    // Set the bits of the rows of block blockIndex that have key
+    void orRows(int blockIndex, int key, quint64 *bits) const;
+
+    // Date index, valid while rows were appended in date order (as a scan
+    // delivers them). Rows dated day are [firstRowOn(day), firstRowOn(day + 1)).
+    bool isDateOrdered() const { return m_dateOrdered; }
+    qint32 firstDay() const { return m_firstDay; }
+    qint32 lastDay() const { return m_firstDay + m_dayStart.size() - 1; }
+    int firstRowOn(qint32 day) const;
+
+private:
+    Q_DISABLE_COPY(TransitIndex)
+
+    void flushPostings();
+
+    int m_rows = 0;
+    QVector<BlockSummary> m_blocks;
+
+    // Row offsets per key in the block being filled; full blocks are one
+    // BlockFile block each
+    QVector<quint16> m_tailPostings[KeyCount];
+    BlockFile m_postings;
+
+    bool m_dateOrdered = true;
+    qint32 m_firstDay = 0;
+    QVector<int> m_dayStart;    // First row of each day from m_firstDay on
+};
+
+// The TransitSearchDialog patterns compiled into a predicate over the typed
+// columns. Body and aspect patterns are matched once against every label a
+// column can show, date patterns once per distinct day. Filtering a block is
+// bitmap intersection: per filtered column, the union of the posting lists
+// of the accepted values, intersected across columns. Only the rows left
+// are read from the store, for the date and orb tests.
+//
+// The natal pattern and the exclude terms see the natal planet's name
+// without the orb that the table prints after it; the orb has its own field.
+class TransitFilter
+{
+public:
+    // Matches every row
+    TransitFilter() = default;
+
+    static TransitFilter compile(const QString &datePattern,
+                                 const QString &transitPattern,
+                                 const QString &aspectPattern,
+                                 const QString &natalPattern,
+                                 const QString &maxOrbPattern,
+                                 const QString &excludePattern);
+
+    bool isEmpty() const;
+
+    bool accepts(const TransitStore &store, int row) const;
+
+    // The same test on an aspect window: the date is the day it comes into
+    // orb, the orb its tightest one, and the transit label may carry "(R)"
+    // when the body is retrograde at one of its exact hits
+    bool accepts(const TransitEvent &event) const;
+
+    // Append the rows in [begin, end) that pass the filter to rows, in row
+    // order. The rows must be indexed.
+    void collect(const TransitStore &store, const TransitIndex &index,
+                 int begin, int end, TransitRowList &rows) const;
+
+private:
+    bool dayAccepted(qint32 julianDay) const;
+    bool columnsAccepted(const TransitStore &store, int row) const;
+    bool mayMatch(const TransitIndex::BlockSummary &block) const;
+    // Bits of the rows in the block that pass the body and aspect filters
+    void selectRows(const TransitIndex &index, int blockIndex, quint64 *bits) const;
+
+    bool m_transitAccepted[BodyCount][2] = {};  // [body][retrograde]
+    bool m_natalAccepted[BodyCount] = {};
+    bool m_aspectAccepted[AspectKindCount] = {};
+    bool m_filtersTransit = false;
+    bool m_filtersNatal = false;
+    bool m_filtersAspect = false;
+
+    // The accepted values as BlockSummary bit masks
+    quint64 m_transitMask[2] = {};
+    quint64 m_natalMask = 0;
+    quint32 m_aspectMask = 0;
+
+    bool m_filtersDate = false;
+    QRegularExpression m_dateRe;
+    QStringList m_excludeTerms;
+
+    bool m_hasMaxOrb = false;
+    float m_maxOrb = 0.0f;
+};
+
+#endif // TRANSITINDEX_H
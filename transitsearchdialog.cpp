@@ -89,7 +89,7 @@ TransitSearchDialog::TransitSearchDialog(QWidget *parent) : QDialog(parent)
                                 "• CON, OPP, SQR - show only soft aspects");
 
     m_applyButton = new QPushButton("Apply Filter", this);
-    m_applyButton->setToolTip("Depending on the volume of data\nfiltering may take some time.\nPlease be patient!");
+    m_applyButton->setToolTip("Filters are also applied as you type");
     mainLayout->addWidget(m_dateFilter);
     mainLayout->addWidget(m_transitPlanetFilter);
     mainLayout->addWidget(m_aspectFilter);
@@ -102,6 +102,17 @@ TransitSearchDialog::TransitSearchDialog(QWidget *parent) : QDialog(parent)
 
     connect(m_applyButton, &QPushButton::clicked, this, &TransitSearchDialog::emitFilter);
 
+    // Live filtering: every edit restarts a short timer, and the filter runs
+    // when it fires, so a burst of keystrokes costs one pass
+    m_liveFilterTimer = new QTimer(this);
+    m_liveFilterTimer->setSingleShot(true);
+    m_liveFilterTimer->setInterval(200);
+    connect(m_liveFilterTimer, &QTimer::timeout, this, &TransitSearchDialog::emitFilter);
+    for (QLineEdit *edit : {m_dateFilter, m_transitPlanetFilter, m_aspectFilter,
+                            m_natalPlanetFilter, m_maxOrbFilter, m_excludeFilter}) {
+        connect(edit, &QLineEdit::textChanged, m_liveFilterTimer, qOverload<>(&QTimer::start));
+    }
+
     m_clearButton = new QPushButton("Clear All", this);
 
     mainLayout->addWidget(m_clearButton);
@@ -118,6 +129,7 @@ TransitSearchDialog::TransitSearchDialog(QWidget *parent) : QDialog(parent)
 }
 
 void TransitSearchDialog::emitFilter() {
+    m_liveFilterTimer->stop();
     emit filterChanged(m_dateFilter->text(),
                        m_transitPlanetFilter->text(),
                        m_aspectFilter->text(),
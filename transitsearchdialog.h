@@ -6,6 +6,7 @@
 #include<QCheckBox>
 #include<QPushButton>
 #include<QLabel>
+#include<QTimer>
 
 class TransitSearchDialog : public QDialog {
     Q_OBJECT
@@ -31,6 +32,7 @@ private:
 
     QLineEdit* m_excludeFilter;
     //QCheckBox *m_liveFilterCheck;
+    QTimer *m_liveFilterTimer;  // Applies the filter once typing pauses
     QPushButton *m_applyButton;
     QPushButton *m_clearButton;
     void clearFilters();
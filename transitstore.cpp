@@ -0,0 +1,171 @@
+#include "transitstore.h"
+#include <QDir>
+
+BlockFile::BlockFile(const QString &name)
+    : m_name(name)
+{
+}
+
+BlockFile::~BlockFile()
+{
+    closeFile();
+}
+
+void BlockFile::clear()
+{
+    closeFile();
+    m_memoryBlocks.clear();
+    m_memoryBytes = 0;
+    m_offsets = {0};
+    m_count = 0;
+}
+
+void BlockFile::append(const QByteArray &blockData)
+{
+    if (!m_memoryBlocks.isEmpty() || !writeBlock(blockData)) {
+        m_memoryBlocks.append(blockData);
+        m_memoryBytes += blockData.size();
+    }
+    m_offsets.append(m_offsets.last() + blockData.size());
+    ++m_count;
+}
+
+bool BlockFile::writeBlock(const QByteArray &blockData)
+{
+    if (!m_file) {
+        m_file = std::make_unique<QTemporaryFile>(QDir::tempPath() + "/" + m_name + "-XXXXXX");
+        if (!m_file->open()) {
+            m_file.reset();
+            return false;
+        }
+    }
+
+    // The mapping has to cover the new block, so map the file again. The old
+    // mapping stays until the new one exists: if anything fails, the blocks
+    // already written are copied out of it, so no block loses its storage.
+    const qint64 expected = m_offsets.last() + blockData.size();
+    uchar *map = nullptr;
+    if (m_file->write(blockData) == blockData.size() && m_file->flush()
+            && m_file->size() == expected) {
+        map = m_file->map(0, expected);
+    }
+    if (map) {
+        if (m_map) {
+            m_file->unmap(m_map);
+        }
+        m_map = map;
+        return true;
+    }
+
+    // Keep what the file already holds in memory and stop using it. The file
+    // is only ever used from the first block on, so m_map covers every block.
+    Q_ASSERT(m_map || m_count == 0);
+    for (int i = 0; m_map && i < m_count; ++i) {
+        m_memoryBlocks.append(QByteArray(reinterpret_cast<const char *>(m_map) + m_offsets[i],
+                                         blockSize(i)));
+        m_memoryBytes += blockSize(i);
+    }
+    closeFile();
+    return false;
+}
+
+void BlockFile::closeFile()
+{
+    if (m_file && m_map) {
+        m_file->unmap(m_map);
+    }
+    m_map = nullptr;
+    m_file.reset();
+}
+
+qint64 BlockFile::fileSize() const
+{
+    return m_file ? m_file->size() : 0;
+}
+
+TransitStore::TransitStore()
+    : m_blocks("asteria-transits")
+{
+}
+
+void TransitStore::clear()
+{
+    m_blocks.clear();
+    m_tail.clear();
+    m_size = 0;
+    m_flushedRows = 0;
+}
+
+void TransitStore::append(const QVector<TransitHit> &hits)
+{
+    for (const TransitHit &hit : hits) {
+        if (m_tail.isEmpty()) {
+            m_tail = QByteArray(BlockBytes, Qt::Uninitialized);
+        }
+
+        const int row = m_size;
+        setValue(row, DaysOffset, qint32(hit.date.toJulianDay()));
+        setValue(row, OrbsOffset, float(hit.orb));
+        setValue(row, TransitOffset, hit.transitBody);
+        setValue(row, NatalOffset, hit.natalBody);
+        setValue(row, AspectOffset, hit.aspect);
+        setValue(row, RetrogradeOffset, quint8(hit.retrograde ? 1 : 0));
+        ++m_size;
+
+        if (m_size - m_flushedRows == BlockRows) {
+            m_blocks.append(m_tail);
+            m_tail.clear();
+            m_flushedRows += BlockRows;
+        }
+    }
+}
+
+TransitHit TransitStore::at(int row) const
+{
+    TransitHit hit;
+    hit.date = date(row);
+    hit.transitBody = transitBody(row);
+    hit.natalBody = natalBody(row);
+    hit.aspect = aspect(row);
+    hit.orb = orb(row);
+    hit.retrograde = retrograde(row);
+    return hit;
+}
+
+QVector<TransitHit> TransitStore::hits() const
+{
+    QVector<TransitHit> result;
+    result.reserve(size());
+    for (int row = 0; row < size(); ++row) {
+        result.append(at(row));
+    }
+    return result;
+}
+
+qsizetype TransitStore::memoryUsage() const
+{
+    return m_tail.capacity() + m_blocks.memoryUsage();
+}
+
+qint64 TransitStore::fileSize() const
+{
+    return m_blocks.fileSize();
+}
+
+QString TransitStore::shortName(Body body)
+{
+    switch (body) {
+    case Body::NorthNode: return QString("NNode");
+    case Body::SouthNode: return QString("SNode");
+    case Body::ParsFortuna: return QString("PFortuna");
+    case Body::PartOfSpirit: return QString("PSpirit");
+    case Body::EastPoint: return QString("EPoint");
+    default: return bodyName(body);
+    }
+}
+
+QString TransitStore::transitLabel(Body body, bool retrograde)
+{
+    bool isRetrograde = retrograde && body != Body::NorthNode && body != Body::SouthNode;
+    return shortName(body) + (isRetrograde ? " (R)" : "");
+}
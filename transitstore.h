@@ -0,0 +1,138 @@
+#ifndef TRANSITSTORE_H
+#define TRANSITSTORE_H
+
+#include <QByteArray>
+#include <QTemporaryFile>
+#include <QVector>
+#include <cstring>
+#include <memory>
+#include "chartcalculator.h"
+
+// Blocks appended to a memory-mapped temporary file and read back through
+// the mapping, leaving paging to the OS. Blocks may differ in size; each
+// starts at an 8-byte aligned offset if every block's size is a multiple of
+// 8. If no temporary file can be used, blocks are kept in memory from then
+// on; a block that was appended is never lost.
+class BlockFile
+{
+public:
+    // name is the start of the temporary file's name
+    explicit BlockFile(const QString &name);
+    ~BlockFile();
+
+    void clear();
+    void append(const QByteArray &blockData);
+
+    int count() const { return m_count; }
+    const uchar *block(int index) const
+    {
+        return m_map ? m_map + m_offsets[index]
+                     : reinterpret_cast<const uchar *>(m_memoryBlocks[index].constData());
+    }
+    qsizetype blockSize(int index) const { return qsizetype(m_offsets[index + 1] - m_offsets[index]); }
+
+    bool isFileBacked() const { return m_map != nullptr; }
+    qsizetype memoryUsage() const { return m_memoryBytes; }
+    qint64 fileSize() const;
+
+private:
+    Q_DISABLE_COPY(BlockFile)
+
+    bool writeBlock(const QByteArray &blockData);
+    void closeFile();
+
+    QString m_name;
+    int m_count = 0;
+    QVector<qint64> m_offsets = {0};    // Start of every block, then the end
+
+    std::unique_ptr<QTemporaryFile> m_file;
+    uchar *m_map = nullptr;             // Mapping of every block
+    QVector<QByteArray> m_memoryBlocks; // The blocks, when there is no file
+    qsizetype m_memoryBytes = 0;
+};
+
+// Transit hits held column by column in a memory-mapped file, so a scan of
+// decades takes disk space rather than RAM. Rows are stored in blocks of
+// BlockRows; inside a block each field is one array (days, orbs, transit
+// bodies, natal bodies, aspects, retrograde flags), 12 bytes a row in all.
+// Only the block being filled lives in RAM; full blocks go to a BlockFile.
+//
+// Rows are kept in append order, which for a transit scan is date order.
+class TransitStore
+{
+public:
+    static constexpr int BlockRows = 65536;
+
+    TransitStore();
+
+    void clear();
+    void append(const QVector<TransitHit> &hits);
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    bool isFileBacked() const { return m_blocks.isFileBacked(); }
+
+    // Typed column access
+    qint32 julianDay(int row) const { return value<qint32>(row, DaysOffset); }
+    QDate date(int row) const { return QDate::fromJulianDay(julianDay(row)); }
+    Body transitBody(int row) const { return value<Body>(row, TransitOffset); }
+    Body natalBody(int row) const { return value<Body>(row, NatalOffset); }
+    AspectKind aspect(int row) const { return value<AspectKind>(row, AspectOffset); }
+    float orb(int row) const { return value<float>(row, OrbsOffset); }    // Shown to two decimals
+    bool retrograde(int row) const { return value<quint8>(row, RetrogradeOffset) != 0; }
+
+    TransitHit at(int row) const;
+    QVector<TransitHit> hits() const;
+
+    // Bytes held in RAM and in the backing file
+    qsizetype memoryUsage() const;
+    qint64 fileSize() const;
+
+    // Labels as shown in the transit table. Short names keep the columns
+    // narrow; nodes are never marked retrograde.
+    static QString shortName(Body body);
+    static QString transitLabel(Body body, bool retrograde);
+
+private:
+    Q_DISABLE_COPY(TransitStore)
+
+    // Column offsets inside a block
+    static constexpr qsizetype DaysOffset = 0;
+    static constexpr qsizetype OrbsOffset = DaysOffset + BlockRows * qsizetype(sizeof(qint32));
+    static constexpr qsizetype TransitOffset = OrbsOffset + BlockRows * qsizetype(sizeof(float));
+    static constexpr qsizetype NatalOffset = TransitOffset + BlockRows;
+    static constexpr qsizetype AspectOffset = NatalOffset + BlockRows;
+    static constexpr qsizetype RetrogradeOffset = AspectOffset + BlockRows;
+    static constexpr qsizetype BlockBytes = RetrogradeOffset + BlockRows;
+
+    const uchar *block(int row) const
+    {
+        if (row >= m_flushedRows) {
+            return reinterpret_cast<const uchar *>(m_tail.constData());
+        }
+        return m_blocks.block(row / BlockRows);
+    }
+
+    template<typename T>
+    T value(int row, qsizetype column) const
+    {
+        T result;
+        std::memcpy(&result, block(row) + column + qsizetype(row % BlockRows) * qsizetype(sizeof(T)),
+                    sizeof(T));
+        return result;
+    }
+
+    template<typename T>
+    void setValue(int row, qsizetype column, T value)
+    {
+        std::memcpy(m_tail.data() + column + qsizetype(row % BlockRows) * qsizetype(sizeof(T)),
+                    &value, sizeof(T));
+    }
+
+    QByteArray m_tail;      // Block being filled
+    int m_size = 0;
+    int m_flushedRows = 0;  // Rows in full blocks, a multiple of BlockRows
+    BlockFile m_blocks;     // Full blocks
+};
+
+#endif // TRANSITSTORE_H
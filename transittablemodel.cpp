@@ -0,0 +1,586 @@
+#include "transittablemodel.h"
+#include <QDateTime>
+#include <QTimeZone>
+#include <algorithm>
+#include <limits>
+
+TransitTableModel::TransitTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int TransitTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_store.size();
+}
+
+int TransitTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TransitTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_store.size()) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole) {
+        return text(index.row(), index.column());
+    }
+    return QVariant();
+}
+
+QVariant TransitTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+    switch (section) {
+    case DateColumn: return QString("Date");
+    case TransitColumn: return QString("Transit Planet");
+    case AspectColumn: return QString("Aspect");
+    case NatalColumn: return QString("Natal Planet (Orb)");
+    default: return QVariant();
+    }
+}
+
+void TransitTableModel::clear()
+{
+    beginResetModel();
+    m_store.clear();
+    m_index.clear();
+    endResetModel();
+}
+
+void TransitTableModel::appendHits(const QVector<TransitHit> &hits)
+{
+    if (hits.isEmpty()) {
+        return;
+    }
+    const int first = m_store.size();
+    beginInsertRows(QModelIndex(), first, first + hits.size() - 1);
+    m_store.append(hits);
+    m_index.update(m_store);
+    endInsertRows();
+}
+
+QString TransitTableModel::text(int row, int column) const
+{
+    switch (column) {
+    case DateColumn:
+        return m_store.date(row).toString("yyyy-MM-dd");
+    case TransitColumn:
+        return TransitStore::transitLabel(m_store.transitBody(row), m_store.retrograde(row));
+    case AspectColumn:
+        return aspectCode(m_store.aspect(row));
+    case NatalColumn:
+        return TransitStore::shortName(m_store.natalBody(row)) + " (" + QString::number(m_store.orb(row), 'f', 2) + "°)";
+    default:
+        return QString();
+    }
+}
+
+TransitFilterProxyModel::TransitFilterProxyModel(QObject *parent)
+    : QAbstractProxyModel(parent)
+    , m_rows(std::make_unique<TransitRowList>())
+{
+}
+
+void TransitFilterProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    beginResetModel();
+    for (const QMetaObject::Connection &connection : m_connections) {
+        disconnect(connection);
+    }
+    m_connections.clear();
+
+    m_transitModel = qobject_cast<TransitTableModel *>(sourceModel);
+    QAbstractProxyModel::setSourceModel(sourceModel);
+    m_sourceRows = sourceModel ? sourceModel->rowCount() : 0;
+
+    if (sourceModel) {
+        m_connections.append(connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset,
+                                     this, &TransitFilterProxyModel::sourceAboutToBeReset));
+        m_connections.append(connect(sourceModel, &QAbstractItemModel::modelReset,
+                                     this, &TransitFilterProxyModel::sourceReset));
+        // A scan brings new rows; the filter is tested on them as they come
+        m_connections.append(connect(sourceModel, &QAbstractItemModel::rowsInserted, this,
+                                     [this](const QModelIndex &parent, int first, int last) {
+            if (!parent.isValid()) {
+                appendSourceRows(first, last);
+            }
+        }));
+    }
+
+    rebuild();
+    endResetModel();
+}
+
+void TransitFilterProxyModel::setFilter(const QString &datePattern,
+                                        const QString &transitPattern,
+                                        const QString &aspectPattern,
+                                        const QString &natalPattern,
+                                        const QString &maxOrbPattern,
+                                        const QString &excludePattern)
+{
+    beginResetModel();
+    m_filter = TransitFilter::compile(datePattern, transitPattern, aspectPattern,
+                                      natalPattern, maxOrbPattern, excludePattern);
+    rebuild();
+    endResetModel();
+}
+
+QModelIndex TransitFilterProxyModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || column < 0 || row >= rowCount() || column >= columnCount()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex TransitFilterProxyModel::parent(const QModelIndex &child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+QModelIndex TransitFilterProxyModel::sibling(int row, int column, const QModelIndex &idx) const
+{
+    Q_UNUSED(idx);
+    return index(row, column);
+}
+
+bool TransitFilterProxyModel::hasChildren(const QModelIndex &parent) const
+{
+    return !parent.isValid() && rowCount() > 0 && columnCount() > 0;
+}
+
+int TransitFilterProxyModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return isIdentity() ? m_sourceRows : m_rows->size();
+}
+
+int TransitFilterProxyModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() || !sourceModel() ? 0 : sourceModel()->columnCount();
+}
+
+QModelIndex TransitFilterProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel()) {
+        return QModelIndex();
+    }
+    return sourceModel()->index(sourceRow(proxyIndex.row()), proxyIndex.column());
+}
+
+QModelIndex TransitFilterProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid() || sourceIndex.model() != sourceModel()) {
+        return QModelIndex();
+    }
+    const int row = proxyRow(sourceIndex.row());
+    return row < 0 ? QModelIndex() : createIndex(row, sourceIndex.column());
+}
+
+void TransitFilterProxyModel::sort(int column, Qt::SortOrder order)
+{
+    if (column == m_sortColumn && order == m_sortOrder) {
+        return;
+    }
+    changeLayout([&]() {
+        m_sortColumn = column;
+        m_sortOrder = order;
+        rebuild();
+    });
+}
+
+bool TransitFilterProxyModel::isIdentity() const
+{
+    return !m_transitModel || (m_filter.isEmpty() && !isSortedByKey());
+}
+
+bool TransitFilterProxyModel::isReversed() const
+{
+    return m_sortColumn >= 0 && m_sortOrder == Qt::DescendingOrder;
+}
+
+bool TransitFilterProxyModel::isSortedByKey() const
+{
+    // The source rows are already in date order
+    return m_sortColumn > TransitTableModel::DateColumn && m_sortColumn < TransitTableModel::ColumnCount;
+}
+
+int TransitFilterProxyModel::sourceRow(int proxyRow) const
+{
+    const int row = isReversed() ? rowCount() - 1 - proxyRow : proxyRow;
+    return isIdentity() ? row : m_rows->at(row);
+}
+
+int TransitFilterProxyModel::proxyRow(int sourceRow) const
+{
+    int row;
+    if (isIdentity()) {
+        row = sourceRow < m_sourceRows ? sourceRow : -1;
+    } else {
+        row = findRow(sourceRow, 0, m_orderedRows);
+        if (row < 0) {
+            row = findTailRow(sourceRow);
+        }
+    }
+    if (row < 0) {
+        return -1;
+    }
+    return isReversed() ? rowCount() - 1 - row : row;
+}
+
+int TransitFilterProxyModel::findRow(int sourceRow, int begin, int end) const
+{
+    // The list is ordered by rowLessThan, which is a total order
+    int low = begin;
+    int high = end;
+    while (low < high) {
+        const int mid = low + (high - low) / 2;
+        if (rowLessThan(m_rows->at(mid), sourceRow)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < end && m_rows->at(low) == sourceRow ? low : -1;
+}
+
+int TransitFilterProxyModel::findTailRow(int sourceRow) const
+{
+    // The tail is in source order, as the rows arrived
+    int low = m_orderedRows;
+    int high = m_rows->size();
+    while (low < high) {
+        const int mid = low + (high - low) / 2;
+        if (m_rows->at(mid) < sourceRow) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < m_rows->size() && m_rows->at(low) == sourceRow ? low : -1;
+}
+
+bool TransitFilterProxyModel::rowLessThan(int left, int right) const
+{
+    if (isSortedByKey()) {
+        const TransitStore &store = m_transitModel->store();
+        switch (m_sortColumn) {
+        case TransitTableModel::TransitColumn:
+            if (store.transitBody(left) != store.transitBody(right)) {
+                return store.transitBody(left) < store.transitBody(right);
+            }
+            break;
+        case TransitTableModel::AspectColumn:
+            if (store.aspect(left) != store.aspect(right)) {
+                return store.aspect(left) < store.aspect(right);
+            }
+            break;
+        case TransitTableModel::NatalColumn:
+            if (store.natalBody(left) != store.natalBody(right)) {
+                return store.natalBody(left) < store.natalBody(right);
+            }
+            if (store.orb(left) != store.orb(right)) {
+                return store.orb(left) < store.orb(right);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    // Equal keys stay in date order
+    return left < right;
+}
+
+void TransitFilterProxyModel::rebuild()
+{
+    m_rows->clear();
+    m_orderedRows = 0;
+    if (isIdentity()) {
+        return;
+    }
+
+    m_filter.collect(m_transitModel->store(), m_transitModel->index(), 0, m_sourceRows, *m_rows);
+
+    if (isSortedByKey()) {
+        // The one place the rows are held in RAM, for the length of the sort
+        QVector<qint32> rows;
+        rows.reserve(m_rows->size());
+        for (int i = 0; i < m_rows->size(); ++i) {
+            rows.append(m_rows->at(i));
+        }
+        std::sort(rows.begin(), rows.end(), [this](qint32 left, qint32 right) {
+            return rowLessThan(left, right);
+        });
+        m_rows->clear();
+        for (qint32 row : rows) {
+            m_rows->append(row);
+        }
+    }
+    m_orderedRows = m_rows->size();
+}
+
+void TransitFilterProxyModel::appendSourceRows(int first, int last)
+{
+    // The transit model only ever appends
+    Q_ASSERT(first == m_sourceRows);
+
+    if (isIdentity()) {
+        const int added = last - first + 1;
+        const int at = isReversed() ? 0 : m_sourceRows;
+        beginInsertRows(QModelIndex(), at, at + added - 1);
+        m_sourceRows = last + 1;
+        endInsertRows();
+        return;
+    }
+
+    TransitRowList matches;
+    m_filter.collect(m_transitModel->store(), m_transitModel->index(), first, last + 1, matches);
+    m_sourceRows = last + 1;
+    if (matches.isEmpty()) {
+        return;
+    }
+
+    // The new rows come in at the end of the list: the bottom of the table,
+    // or the top in descending order
+    const int at = isReversed() ? 0 : m_rows->size();
+    beginInsertRows(QModelIndex(), at, at + matches.size() - 1);
+    for (int i = 0; i < matches.size(); ++i) {
+        m_rows->append(matches.at(i));
+    }
+    endInsertRows();
+
+    // In date order the new rows follow the old ones. Under a column sort
+    // they wait in the tail until it has grown by a quarter of the ordered
+    // rows (or the stream ends), so the merges cost O(1) a row overall
+    // rather than a pass over the whole list for every chunk.
+    if (!isSortedByKey()) {
+        m_orderedRows = m_rows->size();
+    } else if (m_rows->size() - m_orderedRows >= m_orderedRows / 4) {
+        changeLayout([this]() { mergeTail(); });
+    }
+}
+
+void TransitFilterProxyModel::mergeAppendedRows()
+{
+    if (!isIdentity() && m_orderedRows < m_rows->size()) {
+        changeLayout([this]() { mergeTail(); });
+    }
+}
+
+void TransitFilterProxyModel::mergeTail()
+{
+    // Sort the tail in RAM, then merge it with the ordered rows
+    const int size = m_rows->size();
+    QVector<qint32> tail;
+    tail.reserve(size - m_orderedRows);
+    for (int i = m_orderedRows; i < size; ++i) {
+        tail.append(m_rows->at(i));
+    }
+    std::sort(tail.begin(), tail.end(), [this](qint32 left, qint32 right) {
+        return rowLessThan(left, right);
+    });
+
+    auto merged = std::make_unique<TransitRowList>();
+    int left = 0;
+    int right = 0;
+    while (left < m_orderedRows && right < tail.size()) {
+        const qint32 a = m_rows->at(left);
+        const qint32 b = tail[right];
+        if (rowLessThan(b, a)) {
+            merged->append(b);
+            ++right;
+        } else {
+            merged->append(a);
+            ++left;
+        }
+    }
+    for (; left < m_orderedRows; ++left) {
+        merged->append(m_rows->at(left));
+    }
+    for (; right < tail.size(); ++right) {
+        merged->append(tail[right]);
+    }
+    m_rows = std::move(merged);
+    m_orderedRows = m_rows->size();
+}
+
+void TransitFilterProxyModel::changeLayout(const std::function<void()> &change)
+{
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    // Persistent indexes (selection, current row) follow their source rows
+    const QModelIndexList from = persistentIndexList();
+    QVector<int> sourceRows;
+    sourceRows.reserve(from.size());
+    for (const QModelIndex &persistent : from) {
+        sourceRows.append(sourceRow(persistent.row()));
+    }
+
+    change();
+
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (int i = 0; i < from.size(); ++i) {
+        const int row = proxyRow(sourceRows[i]);
+        to.append(row < 0 ? QModelIndex() : index(row, from[i].column()));
+    }
+    changePersistentIndexList(from, to);
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+void TransitFilterProxyModel::sourceAboutToBeReset()
+{
+    beginResetModel();
+}
+
+void TransitFilterProxyModel::sourceReset()
+{
+    m_sourceRows = sourceModel()->rowCount();
+    rebuild();
+    endResetModel();
+}
+
+namespace {
+
+// A Julian day (UT) as table text, to the minute
+QString eventTime(double jd)
+{
+    // JD 2440587.5 is the Unix epoch
+    const qint64 minutes = qRound64((jd - 2440587.5) * 1440.0);
+    return QDateTime::fromMSecsSinceEpoch(minutes * 60000, QTimeZone::UTC).toString("yyyy-MM-dd HH:mm");
+}
+
+}
+
+TransitEventTableModel::TransitEventTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int TransitEventTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_events.size();
+}
+
+int TransitEventTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TransitEventTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_events.size()) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole) {
+        return text(index.row(), index.column());
+    }
+    if (role != Qt::UserRole) {
+        return QVariant();
+    }
+
+    const TransitEvent &event = m_events.at(index.row());
+    switch (index.column()) {
+    case StartColumn: return event.startJd;
+    case EndColumn: return event.endJd;
+    // Windows without an exact hit sort last
+    case ExactColumn: return event.exactJds.isEmpty() ? std::numeric_limits<double>::max()
+                                                      : event.exactJds.first();
+    case TransitColumn: return int(event.transitBody);
+    case AspectColumn: return int(event.aspect);
+    case NatalColumn: return int(event.natalBody) * 1000.0 + event.minOrb;
+    default: return QVariant();
+    }
+}
+
+QVariant TransitEventTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+    switch (section) {
+    case StartColumn: return QString("In Orb (UT)");
+    case EndColumn: return QString("Out of Orb (UT)");
+    case ExactColumn: return QString("Exact (UT)");
+    case TransitColumn: return QString("Transit Planet");
+    case AspectColumn: return QString("Aspect");
+    case NatalColumn: return QString("Natal Planet (Closest Orb)");
+    default: return QVariant();
+    }
+}
+
+void TransitEventTableModel::setEvents(const QVector<TransitEvent> &events)
+{
+    beginResetModel();
+    m_events = events;
+    endResetModel();
+}
+
+QString TransitEventTableModel::text(int row, int column) const
+{
+    const TransitEvent &event = m_events.at(row);
+    switch (column) {
+    case StartColumn:
+        return event.startsBeforeRange ? "before " + eventTime(event.startJd) : eventTime(event.startJd);
+    case EndColumn:
+        return event.endsAfterRange ? "after " + eventTime(event.endJd) : eventTime(event.endJd);
+    case ExactColumn: {
+        QStringList times;
+        for (int i = 0; i < event.exactJds.size(); ++i) {
+            times.append(event.exactRetrograde.at(i) ? eventTime(event.exactJds.at(i)) + " (R)"
+                                                     : eventTime(event.exactJds.at(i)));
+        }
+        return times.join(", ");
+    }
+    case TransitColumn:
+        return TransitStore::shortName(event.transitBody);
+    case AspectColumn:
+        return aspectCode(event.aspect);
+    case NatalColumn:
+        return TransitStore::shortName(event.natalBody) + " (" + QString::number(event.minOrb, 'f', 2) + "°)";
+    default:
+        return QString();
+    }
+}
+
+TransitEventFilterProxyModel::TransitEventFilterProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setSortRole(Qt::UserRole);
+}
+
+void TransitEventFilterProxyModel::setFilter(const QString &datePattern,
+                                             const QString &transitPattern,
+                                             const QString &aspectPattern,
+                                             const QString &natalPattern,
+                                             const QString &maxOrbPattern,
+                                             const QString &excludePattern)
+{
+    m_filter = TransitFilter::compile(datePattern, transitPattern, aspectPattern,
+                                      natalPattern, maxOrbPattern, excludePattern);
+    invalidateFilter();
+}
+
+bool TransitEventFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (sourceParent.isValid() || m_filter.isEmpty()) {
+        return true;
+    }
+    auto *model = static_cast<const TransitEventTableModel *>(sourceModel());
+    return m_filter.accepts(model->events().at(sourceRow));
+}
@@ -0,0 +1,189 @@
+#ifndef TRANSITTABLEMODEL_H
+#define TRANSITTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QAbstractProxyModel>
+#include <QSortFilterProxyModel>
+#include <functional>
+#include <memory>
+#include "transitindex.h"
+#include "transitengine.h"
+
+// Table model over a TransitStore. Cell text is produced only for the rows
+// a view asks for, so memory follows the data rather than the widget count.
+class TransitTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        DateColumn,
+        TransitColumn,
+        AspectColumn,
+        NatalColumn,
+        ColumnCount
+    };
+
+    explicit TransitTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void clear();
+    void appendHits(const QVector<TransitHit> &hits);
+
+    const TransitStore &store() const { return m_store; }
+    const TransitIndex &index() const { return m_index; }
+
+    // Cell text without going through QVariant
+    QString text(int row, int column) const;
+
+private:
+    TransitStore m_store;
+    TransitIndex m_index;   // Kept in step with m_store
+};
+
+// Filtering and sorting for the transit table, without a per-row mapping in
+// RAM. The source rows are in date order, so with no filter and the date
+// sort the proxy rows are the source rows (reversed for descending order).
+// Otherwise the source rows to show are kept in a TransitRowList, which is
+// file-backed like the store: setFilter() compiles the TransitSearchDialog
+// patterns into a TransitFilter and collects the matching rows through the
+// index, and sorting by another column orders that list by the column and
+// then by date. Rows appended by a streaming scan are filtered as they
+// arrive; under a column sort they collect at the end of the table and are
+// merged into the order in batches, and for good by mergeAppendedRows().
+//
+// Sorting by a column other than the date holds the matching row numbers
+// in RAM (4 bytes a row) while they are sorted; otherwise memory use does
+// not grow with the number of rows.
+class TransitFilterProxyModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit TransitFilterProxyModel(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    void setFilter(const QString &datePattern,
+                   const QString &transitPattern,
+                   const QString &aspectPattern,
+                   const QString &natalPattern,
+                   const QString &maxOrbPattern,
+                   const QString &excludePattern);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    QModelIndex sibling(int row, int column, const QModelIndex &idx) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+    // column -1 restores the source order
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    // Move appended rows still waiting at the end to their place in the
+    // column sort. Call when a stream of appends ends.
+    void mergeAppendedRows();
+
+private:
+    // Proxy rows are the source rows (m_rows is not used)
+    bool isIdentity() const;
+    bool isReversed() const;
+    bool isSortedByKey() const;
+
+    int sourceRow(int proxyRow) const;
+    int proxyRow(int sourceRow) const;
+    // Position of sourceRow among the ordered m_rows[begin, end), or -1
+    int findRow(int sourceRow, int begin, int end) const;
+    // Position of sourceRow in the tail, or -1
+    int findTailRow(int sourceRow) const;
+
+    // Order of the list: by the sort column, then by source row
+    bool rowLessThan(int left, int right) const;
+
+    void rebuild();
+    void appendSourceRows(int first, int last);
+    void mergeTail();
+    void changeLayout(const std::function<void()> &change);
+
+    void sourceAboutToBeReset();
+    void sourceReset();
+
+    TransitTableModel *m_transitModel = nullptr;
+    TransitFilter m_filter;
+    int m_sortColumn = -1;
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
+
+    int m_sourceRows = 0;                   // Source rows taken in so far
+    std::unique_ptr<TransitRowList> m_rows; // Shown source rows, ascending order
+    int m_orderedRows = 0;                  // Leading m_rows in order; the rest
+                                            // are a tail in source order waiting
+                                            // to be merged
+    QVector<QMetaObject::Connection> m_connections;
+};
+
+// Table model over transit aspect windows (TransitEngine events): one row
+// per window with its UT entry, exact and exit times. Windows are far fewer
+// than daily rows, so they are held in RAM. Qt::UserRole gives the value a
+// column sorts by.
+class TransitEventTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        StartColumn,
+        EndColumn,
+        ExactColumn,
+        TransitColumn,
+        AspectColumn,
+        NatalColumn,
+        ColumnCount
+    };
+
+    explicit TransitEventTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setEvents(const QVector<TransitEvent> &events);
+    const QVector<TransitEvent> &events() const { return m_events; }
+
+    QString text(int row, int column) const;
+
+private:
+    QVector<TransitEvent> m_events;
+};
+
+// Sorting and TransitSearchDialog filtering for the aspect window table
+class TransitEventFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit TransitEventFilterProxyModel(QObject *parent = nullptr);
+
+    void setFilter(const QString &datePattern,
+                   const QString &transitPattern,
+                   const QString &aspectPattern,
+                   const QString &natalPattern,
+                   const QString &maxOrbPattern,
+                   const QString &excludePattern);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    TransitFilter m_filter;
+};
+
+#endif // TRANSITTABLEMODEL_H